@@ -44,7 +44,8 @@ void LocalServer::run()
 {
   server = new QLocalServer();
 
-  QObject::connect(server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()));
+  //Server and sockets are living in this thread, their signals are processed by the thread's event loop
+  QObject::connect(server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()), Qt::DirectConnection);
   QObject::connect(this, SIGNAL(privateDataReceived(QString)), this, SLOT(slotOnData(QString)));
 
 #ifdef Q_OS_UNIX
@@ -65,53 +66,72 @@ void LocalServer::run()
 }
 
 /**
- * @brief LocalServer::exec
- *  Keeps the thread alive. Waits for incomming connections
+ * -------
+ * SLOTS
+ * -------
+ */
+
+
+
+/**
+ * @brief LocalServer::slotNewConnection
+ *  Executed when a new connection is available
  */
-void LocalServer::exec()
+void LocalServer::slotNewConnection()
 {
-  while(server->isListening())
+  while(server->hasPendingConnections())
   {
-    msleep(100);
-    server->waitForNewConnection(100);
-    for(int i = 0; i < clients.size(); ++i)
-    {
-      if(clients[i]->waitForReadyRead(100))
-      {
-        QByteArray data = clients[i]->readAll();
-        emit privateDataReceived(QString::fromUtf8(data));
-      }
-      else
-      {
-          if(!clients[i]->isOpen())
-          {
-              QLocalSocket* tmp = clients[i];
-              clients.removeAt(i);
-              delete tmp;
-              i--;
-          }
-      }
-    }
-  }
-}
+    QLocalSocket *client = server->nextPendingConnection();
+    clients.push_front(client);
+    clientBuffers.push_front(QByteArray());
 
+    //Complete lines are passed to the main thread as soon as they come
+    QObject::connect(client, &QLocalSocket::readyRead, client, [this, client]() { readClient(client); });
+    QObject::connect(client, SIGNAL(disconnected()), this, SLOT(slotClientDisconnected()), Qt::DirectConnection);
 
+    if(client->bytesAvailable()>0)
+      readClient(client);
+  }
+}
 
 /**
- * -------
- * SLOTS
- * -------
+ * @brief LocalServer::readClient
+ *  Collects data of the client and emits all completely received '\n'-terminated lines
  */
+void LocalServer::readClient(QLocalSocket *client)
+{
+  int i = clients.indexOf(client);
+  if(i<0) return;
+
+  clientBuffers[i].append(client->readAll());
 
+  int end = clientBuffers[i].lastIndexOf('\n');
+  if(end<0) return;
 
+  QByteArray lines = clientBuffers[i].left(end);
+  clientBuffers[i].remove(0, end+1);
+  emit privateDataReceived(QString::fromUtf8(lines));
+}
 
 /**
- * @brief LocalServer::slotNewConnection
- *  Executed when a new connection is available
+ * @brief LocalServer::slotClientDisconnected
+ *  Executed when client has closed the connection
  */
-void LocalServer::slotNewConnection()
+void LocalServer::slotClientDisconnected()
 {
-  clients.push_front(server->nextPendingConnection());
+  QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+  int i = clients.indexOf(client);
+  if(i<0) return;
+
+  //Last line of one-shot messages may come without '\n'
+  if(client->bytesAvailable()>0)
+    clientBuffers[i].append(client->readAll());
+  if(!clientBuffers[i].isEmpty())
+    emit privateDataReceived(QString::fromUtf8(clientBuffers[i]));
+
+  clients.remove(i);
+  clientBuffers.remove(i);
+  client->deleteLater();
 }
 
 
@@ -178,6 +198,10 @@ void LocalServer::onCMD(QString data)
                   IntEngine::engineSocket->sendLevelData(
                          MainWinConnect::pMainWin->activeLvlEditWin()->LvlData
                      );
+                  //Next changes of this level will be sent to engine as deltas
+                  IntEngine::engineSocket->setLiveSource(
+                         &MainWinConnect::pMainWin->activeLvlEditWin()->LvlData
+                     );
               }
               break;
         }
@@ -18,7 +18,6 @@ public:
 
 protected:
   void run();
-  void exec();
 
 signals:
   void dataReceived(QString data);
@@ -29,11 +28,14 @@ signals:
 
 private slots:
   void slotNewConnection();
+  void slotClientDisconnected();
   void slotOnData(QString data);
 
 private:
   QLocalServer* server;
   QVector<QLocalSocket*> clients;
+  QVector<QByteArray> clientBuffers; // Not completely received lines of each client
+  void readClient(QLocalSocket *client);
   void onCMD(QString data);
 
 };
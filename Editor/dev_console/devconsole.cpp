@@ -6,15 +6,22 @@
 #include <QScrollBar>
 #include <QSettings>
 #include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
 
 #include "../version.h"
 
 #include "../common_features/app_path.h"
 
 #include "../common_features/mainwinconnect.h"
+#include "../edit_level/level_edit.h"
 
 
 #include "../file_formats/file_formats.h"
+#include "../file_formats/lvl_sort.h"
+#include "../../_common/mask_blend.h"
 
 DevConsole *DevConsole::currentDevConsole = 0;
 
@@ -190,6 +197,10 @@ void DevConsole::registerCommands()
     registerCommand("md5", &DevConsole::doMd5, tr("Args: {SomeString} Calculating MD5 hash of string"));
     registerCommand("strarr", &DevConsole::doValidateStrArray, tr("Args: {String array} validating the PGE-X string array"));
     registerCommand("flood", &DevConsole::doFlood, tr("Args: {[Number] Gigabytes} | Floods the memory with megabytes"));
+    registerCommand("lvlhistory", &DevConsole::doLvlHistoryInfo, tr("Prints memory usage of the current level's history"));
+    registerCommand("lvlhiststress", &DevConsole::doLvlHistoryStress, tr("Args: {[Number] Operations} | Adds moves of all items (to the same place) into history of the current level and prints the memory usage"));
+    registerCommand("sortbench", &DevConsole::doSortBenchmark, tr("Args: {[Number] Items} | Measures sorting of generated blocks and BGO and saving them into SMBX64 level file"));
+    registerCommand("maskbench", &DevConsole::doMaskBenchmark, tr("Args: {[Directory] GIF images with masks} | Measures applying of masks to images"));
     registerCommand("unhandle", &DevConsole::doThrowUnhandledException, tr("Throws an unhandled exception to crash the editor"));
     registerCommand("segserv", &DevConsole::doSegmentationViolation, tr("Does a segmentation violation"));
 }
@@ -281,6 +292,197 @@ void DevConsole::doFlood(QStringList args)
     }
 }
 
+void DevConsole::doLvlHistoryInfo(QStringList /*args*/)
+{
+    if(MainWinConnect::pMainWin->activeChildWindow()!=1)
+    {
+        log("-> No opened level", ui->tabWidget->tabText(0));
+        return;
+    }
+    LvlScene *scene = MainWinConnect::pMainWin->activeLvlEditWin()->scene;
+    log(QString("-> History steps: %1, compressed: %2, memory: %3 KB")
+        .arg(scene->getHistroyIndex())
+        .arg(scene->historyPackedCount())
+        .arg(scene->historyMemoryUsage()/1024), ui->tabWidget->tabText(0));
+}
+
+void DevConsole::doLvlHistoryStress(QStringList args)
+{
+    if(MainWinConnect::pMainWin->activeChildWindow()!=1)
+    {
+        log("-> No opened level", ui->tabWidget->tabText(0));
+        return;
+    }
+    int count = 10;
+    if(args.size() > 0)
+    {
+        bool succ;
+        count = args[0].toInt(&succ);
+        if(!succ || (count<=0))
+            return;
+    }
+
+    LvlScene *scene = MainWinConnect::pMainWin->activeLvlEditWin()->scene;
+    LevelData allItems = *(scene->LvlData);
+    qint64 before = scene->historyMemoryUsage();
+
+    //Size of same step if it was stored as full copy of items
+    LvlScene::HistoryOperation fullCopy;
+    fullCopy.data = allItems;
+    qint64 fullCopySize = scene->historyOperationSize(fullCopy);
+
+    //Moving to the same place: undo/redo of this steps will not change anything
+    for(int i=0; i<count; i++)
+        scene->addMoveHistory(allItems, allItems);
+    qint64 afterMove = scene->historyMemoryUsage();
+
+    scene->historyCompressAll();
+    qint64 afterPack = scene->historyMemoryUsage();
+
+    log(QString("-> %1 moves of %2 blocks, %3 BGO, %4 NPC")
+        .arg(count).arg(allItems.blocks.size()).arg(allItems.bgo.size()).arg(allItems.npc.size()),
+        ui->tabWidget->tabText(0));
+    log(QString("-> History memory: before %1 KB, as full copies %2 KB, after moves %3 KB, compressed %4 KB")
+        .arg(before/1024).arg((before+fullCopySize*count)/1024).arg(afterMove/1024).arg(afterPack/1024),
+        ui->tabWidget->tabText(0));
+    log(QString("-> History steps: %1, compressed: %2")
+        .arg(scene->getHistroyIndex()).arg(scene->historyPackedCount()),
+        ui->tabWidget->tabText(0));
+}
+
+void DevConsole::doSortBenchmark(QStringList args)
+{
+    int count = 100000;
+    if(args.size() > 0)
+    {
+        bool succ;
+        count = args[0].toInt(&succ);
+        if(!succ || (count<=0))
+            return;
+    }
+
+    //Generate items on the grid in the random order with many equal coordinates
+    qsrand(count);
+    LevelData data = FileFormats::dummyLvlDataArray();
+    for(int i=0; i<count; i++)
+    {
+        LevelBlock block = FileFormats::dummyLvlBlock();
+        block.x = (qrand()%1000)*32;
+        block.y = (qrand()%100)*32;
+        block.array_id = count-i;
+        data.blocks.push_back(block);
+
+        LevelBGO bgo = FileFormats::dummyLvlBgo();
+        bgo.x = (qrand()%1000)*32;
+        bgo.y = (qrand()%100)*32;
+        bgo.smbx64_sp_apply = qrand()%10;
+        bgo.array_id = count-i;
+        data.bgo.push_back(bgo);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    LvlSort::blocksByArrayID(data.blocks);
+    qint64 tBlocksID = timer.restart();
+    LvlSort::blocksSMBX64(data.blocks);
+    qint64 tBlocksFile = timer.restart();
+    LvlSort::bgoSMBX64(data.bgo);
+    qint64 tBgoFile = timer.restart();
+    QVector<LevelBlock > blocks = data.blocks;
+    LvlSort::applyOrder(blocks, LvlSort::blocksByPos(blocks));
+    qint64 tBlocksApply = timer.restart();
+    QString raw = FileFormats::WriteSMBX64LvlFile(data);
+    qint64 tWrite = timer.elapsed();
+
+    log(QString("-> %1 blocks and %1 BGO").arg(count), ui->tabWidget->tabText(0));
+    log(QString("-> Blocks by array_id: %1 ms, blocks SMBX64 order: %2 ms, BGO SMBX64 order: %3 ms")
+        .arg(tBlocksID).arg(tBlocksFile).arg(tBgoFile), ui->tabWidget->tabText(0));
+    log(QString("-> Reorder blocks by position: %1 ms, save SMBX64 file: %2 ms (%3 KB)")
+        .arg(tBlocksApply).arg(tWrite).arg(raw.size()/1024), ui->tabWidget->tabText(0));
+}
+
+void DevConsole::doMaskBenchmark(QStringList args)
+{
+    QList<QImage > images;
+    QList<QImage > masks;
+    if(args.size() > 0)
+    {
+        QDir dir(args.join(" "));
+        foreach(QString file, dir.entryList(QStringList() << "*.gif", QDir::Files))
+        {
+            QString maskFile = QFileInfo(file).baseName()+"m.gif";
+            if(file.endsWith("m.gif", Qt::CaseInsensitive) || !dir.exists(maskFile))
+                continue;
+            QImage image(dir.filePath(file));
+            QImage mask(dir.filePath(maskFile));
+            if(image.isNull() || mask.isNull())
+                continue;
+            images.push_back(image);
+            masks.push_back(mask);
+        }
+    }
+
+    if(images.isEmpty())
+    {
+        //Generated sprite sheet with black background and white mask around
+        QImage image(512, 512, QImage::Format_Indexed8);
+        QImage mask(512, 512, QImage::Format_Indexed8);
+        QVector<QRgb> colors;
+        for(int i=0; i<256; i++)
+            colors.push_back(qRgb(i, (i*7)&0xFF, (i*13)&0xFF));
+        image.setColorTable(colors);
+        mask.setColorTable(QVector<QRgb>() << qRgb(0,0,0) << qRgb(255,255,255));
+        for(int y=0; y<512; y++)
+            for(int x=0; x<512; x++)
+            {
+                bool inSprite = ((x%32)>4) && ((x%32)<28) && ((y%32)>2);
+                image.setPixel(x, y, inSprite ? uint((x^y)&0xFF) : 0);
+                mask.setPixel(x, y, inSprite ? 0 : 1);
+            }
+        for(int i=0; i<32; i++)
+        {
+            images.push_back(image);
+            masks.push_back(mask);
+        }
+    }
+
+    qint64 pixels = 0;
+    foreach(QImage image, images)
+        pixels += qint64(image.width())*image.height();
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int i=0; i<images.size(); i++)
+    {
+        QImage target = images[i];
+        QImage newmask = masks[i];
+        if(target.size() != newmask.size())
+            newmask = newmask.copy(0, 0, target.width(), target.height());
+        newmask.invertPixels();
+        target.setAlphaChannel(newmask);
+    }
+    qint64 tQt = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i=0; i<images.size(); i++)
+        MaskBlend::applyMask(images[i], masks[i]);
+    qint64 tMask = timer.nsecsElapsed();
+
+    timer.restart();
+    for(int i=0; i<images.size(); i++)
+        MaskBlend::applyMaskVB(images[i], masks[i]);
+    qint64 tMaskVB = timer.nsecsElapsed();
+
+    //Megapixels per second = pixels / nanoseconds * 1000
+    log(QString("-> %1 images, %2 pixels").arg(images.size()).arg(pixels), ui->tabWidget->tabText(0));
+    log(QString("-> invertPixels+setAlphaChannel: %1 ms (%2 Mpix/s)")
+        .arg(tQt/1000000.0, 0, 'f', 2).arg(pixels*1000.0/qMax(tQt, qint64(1)), 0, 'f', 1), ui->tabWidget->tabText(0));
+    log(QString("-> MaskBlend::applyMask: %1 ms (%2 Mpix/s)")
+        .arg(tMask/1000000.0, 0, 'f', 2).arg(pixels*1000.0/qMax(tMask, qint64(1)), 0, 'f', 1), ui->tabWidget->tabText(0));
+    log(QString("-> MaskBlend::applyMaskVB: %1 ms (%2 Mpix/s)")
+        .arg(tMaskVB/1000000.0, 0, 'f', 2).arg(pixels*1000.0/qMax(tMaskVB, qint64(1)), 0, 'f', 1), ui->tabWidget->tabText(0));
+}
+
 void DevConsole::doThrowUnhandledException(QStringList /*args*/)
 {
     throw std::runtime_error("Test Exception of Toast!");
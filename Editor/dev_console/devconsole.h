@@ -58,6 +58,10 @@ private:
     void doMd5(QStringList args);
     void doFlood(QStringList args);
     void doValidateStrArray(QStringList args);
+    void doLvlHistoryInfo(QStringList);
+    void doLvlHistoryStress(QStringList args);
+    void doSortBenchmark(QStringList args);
+    void doMaskBenchmark(QStringList args);
     void doThrowUnhandledException(QStringList);
     void doSegmentationViolation(QStringList);
 };
@@ -21,6 +21,7 @@
 #include <QPixmap>
 #include <QGraphicsScene>
 #include <QProgressDialog>
+#include <QElapsedTimer>
 
 #include "level_edit.h"
 #include <ui_leveledit.h>
@@ -59,20 +60,28 @@ bool leveledit::DrawObjects(QProgressDialog &progress)
         if(!progress.wasCanceled())
             progress.setLabelText(tr("2/%1 Applying BGOs...").arg(TotalSteps));
 
+    QElapsedTimer placingTime;
+    QElapsedTimer stageTime;
+    placingTime.start();
     progress.setValue(progress.value()+1);
     qApp->processEvents();
+    scene->beginBulkInsertion();
+    stageTime.start();
     scene->setBGO(progress);
+    WriteToLog(QtDebugMsg, QString("%1 BGO are placed in %2 ms").arg(LvlData.bgo.size()).arg(stageTime.elapsed()));
 
-        if(progress.wasCanceled()) return false;
+        if(progress.wasCanceled()) { scene->endBulkInsertion(); return false; }
 
         if(!progress.wasCanceled())
             progress.setLabelText(tr("3/%1 Applying Blocks...").arg(TotalSteps));
 
     progress.setValue(progress.value()+1);
     qApp->processEvents();
+    stageTime.start();
     scene->setBlocks(progress);
+    WriteToLog(QtDebugMsg, QString("%1 blocks are placed in %2 ms").arg(LvlData.blocks.size()).arg(stageTime.elapsed()));
 
-        if(progress.wasCanceled()) return false;
+        if(progress.wasCanceled()) { scene->endBulkInsertion(); return false; }
 
         if(!progress.wasCanceled())
             progress.setLabelText(tr("4/%1 Applying NPCs...").arg(TotalSteps));
@@ -80,27 +89,36 @@ bool leveledit::DrawObjects(QProgressDialog &progress)
     progress.setValue(progress.value()+1);
     progress.setValue(progress.value()+1);
     qApp->processEvents();
+    stageTime.start();
     scene->setNPC(progress);
+    WriteToLog(QtDebugMsg, QString("%1 NPC are placed in %2 ms").arg(LvlData.npc.size()).arg(stageTime.elapsed()));
 
-        if(progress.wasCanceled()) return false;
+        if(progress.wasCanceled()) { scene->endBulkInsertion(); return false; }
 
         if(!progress.wasCanceled())
             progress.setLabelText(tr("5/%1 Applying Water...").arg(TotalSteps));
 
     progress.setValue(progress.value()+1);
     qApp->processEvents();
+    stageTime.start();
     scene->setWaters(progress);
+    WriteToLog(QtDebugMsg, QString("%1 water boxes are placed in %2 ms").arg(LvlData.physez.size()).arg(stageTime.elapsed()));
 
-        if(progress.wasCanceled()) return false;
+        if(progress.wasCanceled()) { scene->endBulkInsertion(); return false; }
 
         if(!progress.wasCanceled())
             progress.setLabelText(tr("6/%1 Applying Doors...").arg(TotalSteps));
 
 
     qApp->processEvents();
+    stageTime.start();
     scene->setDoors(progress);
+    WriteToLog(QtDebugMsg, QString("%1 doors are placed in %2 ms").arg(LvlData.doors.size()).arg(stageTime.elapsed()));
 
-        if(progress.wasCanceled()) return false;
+        if(progress.wasCanceled()) { scene->endBulkInsertion(); return false; }
+
+    scene->endBulkInsertion();
+    WriteToLog(QtDebugMsg, QString("Level items are placed in %1 ms").arg(placingTime.elapsed()));
 
     scene->setPlayerPoints();
 
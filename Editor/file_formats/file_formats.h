@@ -149,6 +149,10 @@ public:
     static LevelData ReadExtendedLvlFile(QString RawData, QString filePath=""); //!< Parse PGE-X level file
     static QString WriteExtendedLvlFile(LevelData FileData);  //!< Generate PGE-X level raw data
 
+    // Raw binary level data (in-memory exchange only, keeps editing data)
+    static LevelData ReadLvlRawData(QByteArray RawData); //!< Restore level data from binary dump
+    static QByteArray WriteLvlRawData(LevelData FileData);  //!< Make binary dump of level data
+
     // Lvl Data
     static LevelNPC dummyLvlNpc();
     static LevelDoors dummyLvlDoor();
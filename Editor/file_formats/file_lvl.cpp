@@ -17,6 +17,7 @@
  */
 
 #include "file_formats.h"
+#include "lvl_sort.h"
 
 #include <QFileInfo>
 #include <QDir>
@@ -1219,25 +1220,16 @@ QString FileFormats::WriteSMBX64LvlFile(LevelData FileData)
 
 
     //Blocks
-    QMap<long, QMap<long, QMap<long, LevelBlock > > > sortedBlocks;
-    foreach(LevelBlock block, FileData.blocks)
+    QVector<int> blocksOrder = LvlSort::blocksSMBX64(FileData.blocks);
+    for(i=0; i<blocksOrder.size(); i++)
     {
-        sortedBlocks[block.x][block.y][block.array_id] = block;
-    }
-
-    //for(i=0; i<FileData.blocks.size(); i++)
-    //{
-    for (QMap<long, QMap<long, QMap<long, LevelBlock > > >::iterator bArr = sortedBlocks.begin(); bArr != sortedBlocks.end(); bArr++)
-    {
-      for (QMap<long, QMap<long, LevelBlock > >::iterator bBrr = (* bArr).begin(); bBrr != (* bArr).end(); bBrr++)
-        for (QMap<long, LevelBlock >::iterator block = (* bBrr).begin(); block != (*bBrr).end(); block++)
-        {
-        TextData += SMBX64::IntS((*block).x);
-        TextData += SMBX64::IntS((*block).y);
-        TextData += SMBX64::IntS((*block).h);
-        TextData += SMBX64::IntS((*block).w);
-        TextData += SMBX64::IntS((*block).id);
-        int npcID = (*block).npc_id;
+        const LevelBlock &block = FileData.blocks.at(blocksOrder[i]);
+        TextData += SMBX64::IntS(block.x);
+        TextData += SMBX64::IntS(block.y);
+        TextData += SMBX64::IntS(block.h);
+        TextData += SMBX64::IntS(block.w);
+        TextData += SMBX64::IntS(block.id);
+        int npcID = block.npc_id;
         if(npcID < 0)
         {
             npcID *= -1; if(npcID>99) npcID = 99;
@@ -1246,36 +1238,25 @@ QString FileFormats::WriteSMBX64LvlFile(LevelData FileData)
         if(npcID!=0)
             npcID+=1000;
         TextData += SMBX64::IntS(npcID);
-        TextData += SMBX64::BoolS((*block).invisible);
-        TextData += SMBX64::BoolS((*block).slippery);
-        TextData += SMBX64::qStrS((*block).layer);
-        TextData += SMBX64::qStrS((*block).event_destroy);
-        TextData += SMBX64::qStrS((*block).event_hit);
-        TextData += SMBX64::qStrS((*block).event_no_more);
-        }
+        TextData += SMBX64::BoolS(block.invisible);
+        TextData += SMBX64::BoolS(block.slippery);
+        TextData += SMBX64::qStrS(block.layer);
+        TextData += SMBX64::qStrS(block.event_destroy);
+        TextData += SMBX64::qStrS(block.event_hit);
+        TextData += SMBX64::qStrS(block.event_no_more);
     }
     TextData += "\"next\"\n";//Separator
 
 
     //BGOs
-    QMap<long, QMap<long, QMap<long, QMap<long, LevelBGO > > > > sortedBGO;
-    foreach(LevelBGO bgo1, FileData.bgo)
+    QVector<int> bgoOrder = LvlSort::bgoSMBX64(FileData.bgo);
+    for(i=0; i<bgoOrder.size(); i++)
     {
-        sortedBGO[bgo1.smbx64_sp_apply][bgo1.x][bgo1.y][bgo1.array_id] = bgo1;
-    }
-
-    //for(i=0; i<FileData.bgo.size(); i++)
-    for (QMap<long, QMap<long, QMap<long, QMap<long, LevelBGO > > > >::iterator sArr = sortedBGO.begin(); sArr != sortedBGO.end(); sArr++)
-    {
-        for (QMap<long, QMap<long, QMap<long, LevelBGO > > >::iterator bArr = (* sArr).begin(); bArr != (* sArr).end(); bArr++)
-          for (QMap<long, QMap<long, LevelBGO > >::iterator bBrr = (* bArr).begin(); bBrr != (* bArr).end(); bBrr++)
-            for (QMap<long, LevelBGO >::iterator bgo = (* bBrr).begin(); bgo != (*bBrr).end(); bgo++)
-            {
-            TextData += SMBX64::IntS( (*bgo).x);
-            TextData += SMBX64::IntS( (*bgo).y);
-            TextData += SMBX64::IntS( (*bgo).id);
-            TextData += SMBX64::qStrS( (*bgo).layer);
-            }
+        const LevelBGO &bgo = FileData.bgo.at(bgoOrder[i]);
+        TextData += SMBX64::IntS(bgo.x);
+        TextData += SMBX64::IntS(bgo.y);
+        TextData += SMBX64::IntS(bgo.id);
+        TextData += SMBX64::qStrS(bgo.layer);
     }
     TextData += "\"next\"\n";//Separator
 
@@ -0,0 +1,390 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file_formats.h"
+
+#include <QDataStream>
+
+/*
+ * Raw level data is an in-memory binary dump of LevelData.
+ * Unlike PGE-X it keeps the editing fields (array_id, index, etc.),
+ * so it is used only where data is exchanged between the same build of
+ * editor and engine or kept inside of the editor (history, transfers).
+ * It is NOT a file format and must never be saved to disk.
+ */
+
+static const quint32 LVL_RAW_MAGIC   = 0x584C4750; // "PGLX"
+static const quint16 LVL_RAW_VERSION = 1;
+static const quint32 LVL_RAW_MIN_RECORD = 8; // Smallest record (layer) is longer
+
+//*********************************************************
+//****************WRITE RAW DATA***************************
+//*********************************************************
+
+static void writeRawSection(QDataStream &out, const LevelSection &s)
+{
+    out << (qint32)s.id
+        << (qint64)s.size_top << (qint64)s.size_bottom
+        << (qint64)s.size_left << (qint64)s.size_right
+        << (quint32)s.music_id << (qint64)s.bgcolor
+        << s.IsWarp << s.OffScreenEn
+        << (quint32)s.background << s.noback << s.underwater
+        << s.music_file
+        << (qint64)s.PositionX << (qint64)s.PositionY;
+}
+
+static void writeRawPlayer(QDataStream &out, const PlayerPoint &p)
+{
+    out << (quint32)p.id << (qint64)p.x << (qint64)p.y
+        << (qint64)p.h << (qint64)p.w << (qint32)p.direction;
+}
+
+static void writeRawBlock(QDataStream &out, const LevelBlock &b)
+{
+    out << (qint64)b.x << (qint64)b.y << (qint64)b.h << (qint64)b.w
+        << (quint64)b.id << (qint64)b.npc_id
+        << b.invisible << b.slippery
+        << b.layer << b.event_destroy << b.event_hit << b.event_no_more
+        << (quint32)b.array_id << (quint32)b.index;
+}
+
+static void writeRawBGO(QDataStream &out, const LevelBGO &b)
+{
+    out << (qint64)b.x << (qint64)b.y << (quint64)b.id << b.layer
+        << (qint32)b.z_mode << (double)b.z_offset
+        << (qint64)b.smbx64_sp << (qint64)b.smbx64_sp_apply
+        << (quint32)b.array_id << (quint32)b.index;
+}
+
+static void writeRawNPC(QDataStream &out, const LevelNPC &n)
+{
+    out << (qint64)n.x << (qint64)n.y << (qint32)n.direct << (quint64)n.id
+        << (qint64)n.special_data << (qint64)n.special_data2
+        << n.generator << (qint32)n.generator_direct
+        << (qint32)n.generator_type << (qint32)n.generator_period
+        << n.msg << n.friendly << n.nomove << n.legacyboss
+        << n.layer << n.event_activate << n.event_die << n.event_talk
+        << n.event_nomore << n.attach_layer
+        << (quint32)n.array_id << (quint32)n.index << n.is_star;
+}
+
+static void writeRawDoor(QDataStream &out, const LevelDoors &d)
+{
+    out << (qint64)d.ix << (qint64)d.iy << d.isSetIn
+        << (qint64)d.ox << (qint64)d.oy << d.isSetOut
+        << (qint32)d.idirect << (qint32)d.odirect << (qint32)d.type
+        << d.lname << (qint64)d.warpto << d.lvl_i << d.lvl_o
+        << (qint64)d.world_x << (qint64)d.world_y << (qint32)d.stars
+        << d.layer << d.unknown << d.novehicles << d.allownpc << d.locked
+        << (quint32)d.array_id << (quint32)d.index;
+}
+
+static void writeRawPhysEnv(QDataStream &out, const LevelPhysEnv &w)
+{
+    out << (qint64)w.x << (qint64)w.y << (qint64)w.h << (qint64)w.w
+        << (qint64)w.unknown << w.quicksand << w.layer
+        << (quint32)w.array_id << (quint32)w.index;
+}
+
+static void writeRawLayer(QDataStream &out, const LevelLayers &l)
+{
+    out << l.name << l.hidden << l.locked << (quint32)l.array_id;
+}
+
+static void writeRawEvent(QDataStream &out, const LevelEvents &e)
+{
+    out << e.name << e.msg << (qint64)e.sound_id << (qint64)e.end_game;
+
+    out << (quint32)e.layers.size();
+    foreach(const LevelEvents_layers &l, e.layers)
+        out << l.hide << l.show << l.toggle;
+
+    out << e.nosmoke << e.layers_hide << e.layers_show << e.layers_toggle;
+
+    out << (quint32)e.sets.size();
+    foreach(const LevelEvents_Sets &s, e.sets)
+        out << (qint64)s.music_id << (qint64)s.background_id
+            << (qint64)s.position_left << (qint64)s.position_top
+            << (qint64)s.position_bottom << (qint64)s.position_right;
+
+    out << e.trigger << (qint64)e.trigger_timer
+        << e.ctrl_up << e.ctrl_down << e.ctrl_left << e.ctrl_right
+        << e.ctrl_jump << e.ctrl_altjump << e.ctrl_run << e.ctrl_altrun
+        << e.ctrl_start << e.ctrl_drop << e.autostart
+        << e.movelayer << e.layer_speed_x << e.layer_speed_y
+        << e.move_camera_x << e.move_camera_y << (qint64)e.scroll_section
+        << (quint32)e.array_id;
+}
+
+QByteArray FileFormats::WriteLvlRawData(LevelData FileData)
+{
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_8);
+
+    out << LVL_RAW_MAGIC << LVL_RAW_VERSION;
+
+    out << (qint32)FileData.stars << FileData.LevelName;
+
+    out << (quint32)FileData.blocks_array_id << (quint32)FileData.bgo_array_id
+        << (quint32)FileData.npc_array_id << (quint32)FileData.doors_array_id
+        << (quint32)FileData.physenv_array_id << (quint32)FileData.layers_array_id
+        << (quint32)FileData.events_array_id;
+
+    out << (quint32)FileData.sections.size();
+    foreach(const LevelSection &s, FileData.sections)  writeRawSection(out, s);
+
+    out << (quint32)FileData.players.size();
+    foreach(const PlayerPoint &p, FileData.players)    writeRawPlayer(out, p);
+
+    out << (quint32)FileData.blocks.size();
+    foreach(const LevelBlock &b, FileData.blocks)      writeRawBlock(out, b);
+
+    out << (quint32)FileData.bgo.size();
+    foreach(const LevelBGO &b, FileData.bgo)           writeRawBGO(out, b);
+
+    out << (quint32)FileData.npc.size();
+    foreach(const LevelNPC &n, FileData.npc)           writeRawNPC(out, n);
+
+    out << (quint32)FileData.doors.size();
+    foreach(const LevelDoors &d, FileData.doors)       writeRawDoor(out, d);
+
+    out << (quint32)FileData.physez.size();
+    foreach(const LevelPhysEnv &w, FileData.physez)    writeRawPhysEnv(out, w);
+
+    out << (quint32)FileData.layers.size();
+    foreach(const LevelLayers &l, FileData.layers)     writeRawLayer(out, l);
+
+    out << (quint32)FileData.events.size();
+    foreach(const LevelEvents &e, FileData.events)     writeRawEvent(out, e);
+
+    out << (quint32)FileData.metaData.bookmarks.size();
+    foreach(const Bookmark &b, FileData.metaData.bookmarks)
+        out << b.bookmarkName << (double)b.x << (double)b.y;
+
+    out << (qint32)FileData.CurSection << FileData.playmusic
+        << FileData.modified << FileData.untitled << FileData.smbx64strict
+        << FileData.filename << FileData.path;
+
+    return raw;
+}
+
+
+//*********************************************************
+//****************READ RAW DATA****************************
+//*********************************************************
+
+static void readRawSection(QDataStream &in, LevelSection &s)
+{
+    qint32 id; qint64 top, bottom, left, right, bgcolor, posX, posY;
+    quint32 music_id, background;
+    in >> id >> top >> bottom >> left >> right >> music_id >> bgcolor
+       >> s.IsWarp >> s.OffScreenEn >> background >> s.noback >> s.underwater
+       >> s.music_file >> posX >> posY;
+    s.id = id;
+    s.size_top = top; s.size_bottom = bottom;
+    s.size_left = left; s.size_right = right;
+    s.music_id = music_id; s.bgcolor = bgcolor;
+    s.background = background;
+    s.PositionX = posX; s.PositionY = posY;
+}
+
+static void readRawPlayer(QDataStream &in, PlayerPoint &p)
+{
+    quint32 id; qint64 x, y, h, w; qint32 direction;
+    in >> id >> x >> y >> h >> w >> direction;
+    p.id = id; p.x = x; p.y = y; p.h = h; p.w = w; p.direction = direction;
+}
+
+static void readRawBlock(QDataStream &in, LevelBlock &b)
+{
+    qint64 x, y, h, w, npc_id; quint64 id; quint32 array_id, index;
+    in >> x >> y >> h >> w >> id >> npc_id >> b.invisible >> b.slippery
+       >> b.layer >> b.event_destroy >> b.event_hit >> b.event_no_more
+       >> array_id >> index;
+    b.x = x; b.y = y; b.h = h; b.w = w;
+    b.id = id; b.npc_id = npc_id;
+    b.array_id = array_id; b.index = index;
+}
+
+static void readRawBGO(QDataStream &in, LevelBGO &b)
+{
+    qint64 x, y, sp, sp_apply; quint64 id; qint32 z_mode; double z_offset;
+    quint32 array_id, index;
+    in >> x >> y >> id >> b.layer >> z_mode >> z_offset
+       >> sp >> sp_apply >> array_id >> index;
+    b.x = x; b.y = y; b.id = id;
+    b.z_mode = z_mode; b.z_offset = z_offset;
+    b.smbx64_sp = sp; b.smbx64_sp_apply = sp_apply;
+    b.array_id = array_id; b.index = index;
+}
+
+static void readRawNPC(QDataStream &in, LevelNPC &n)
+{
+    qint64 x, y, sp1, sp2; qint32 direct, gdir, gtype, gperiod; quint64 id;
+    quint32 array_id, index;
+    in >> x >> y >> direct >> id >> sp1 >> sp2
+       >> n.generator >> gdir >> gtype >> gperiod
+       >> n.msg >> n.friendly >> n.nomove >> n.legacyboss
+       >> n.layer >> n.event_activate >> n.event_die >> n.event_talk
+       >> n.event_nomore >> n.attach_layer
+       >> array_id >> index >> n.is_star;
+    n.x = x; n.y = y; n.direct = direct; n.id = id;
+    n.special_data = sp1; n.special_data2 = sp2;
+    n.generator_direct = gdir; n.generator_type = gtype; n.generator_period = gperiod;
+    n.array_id = array_id; n.index = index;
+}
+
+static void readRawDoor(QDataStream &in, LevelDoors &d)
+{
+    qint64 ix, iy, ox, oy, warpto, wx, wy; qint32 idir, odir, type, stars;
+    quint32 array_id, index;
+    in >> ix >> iy >> d.isSetIn >> ox >> oy >> d.isSetOut
+       >> idir >> odir >> type >> d.lname >> warpto >> d.lvl_i >> d.lvl_o
+       >> wx >> wy >> stars
+       >> d.layer >> d.unknown >> d.novehicles >> d.allownpc >> d.locked
+       >> array_id >> index;
+    d.ix = ix; d.iy = iy; d.ox = ox; d.oy = oy;
+    d.idirect = idir; d.odirect = odir; d.type = type;
+    d.warpto = warpto; d.world_x = wx; d.world_y = wy; d.stars = stars;
+    d.array_id = array_id; d.index = index;
+}
+
+static void readRawPhysEnv(QDataStream &in, LevelPhysEnv &w)
+{
+    qint64 x, y, h, wd, unknown; quint32 array_id, index;
+    in >> x >> y >> h >> wd >> unknown >> w.quicksand >> w.layer >> array_id >> index;
+    w.x = x; w.y = y; w.h = h; w.w = wd; w.unknown = unknown;
+    w.array_id = array_id; w.index = index;
+}
+
+static void readRawLayer(QDataStream &in, LevelLayers &l)
+{
+    quint32 array_id;
+    in >> l.name >> l.hidden >> l.locked >> array_id;
+    l.array_id = array_id;
+}
+
+static void readRawEvent(QDataStream &in, LevelEvents &e)
+{
+    qint64 sound_id, end_game, trigger_timer, scroll_section;
+    quint32 count, array_id;
+
+    in >> e.name >> e.msg >> sound_id >> end_game;
+
+    in >> count;
+    e.layers.clear();
+    for(quint32 i=0; (i<count) && (in.status()==QDataStream::Ok); i++)
+    {
+        LevelEvents_layers l;
+        in >> l.hide >> l.show >> l.toggle;
+        e.layers.push_back(l);
+    }
+
+    in >> e.nosmoke >> e.layers_hide >> e.layers_show >> e.layers_toggle;
+
+    in >> count;
+    e.sets.clear();
+    for(quint32 i=0; (i<count) && (in.status()==QDataStream::Ok); i++)
+    {
+        LevelEvents_Sets s;
+        qint64 music, bg, l, t, b, r;
+        in >> music >> bg >> l >> t >> b >> r;
+        s.music_id = music; s.background_id = bg;
+        s.position_left = l; s.position_top = t;
+        s.position_bottom = b; s.position_right = r;
+        e.sets.push_back(s);
+    }
+
+    in >> e.trigger >> trigger_timer
+       >> e.ctrl_up >> e.ctrl_down >> e.ctrl_left >> e.ctrl_right
+       >> e.ctrl_jump >> e.ctrl_altjump >> e.ctrl_run >> e.ctrl_altrun
+       >> e.ctrl_start >> e.ctrl_drop >> e.autostart
+       >> e.movelayer >> e.layer_speed_x >> e.layer_speed_y
+       >> e.move_camera_x >> e.move_camera_y >> scroll_section
+       >> array_id;
+
+    e.sound_id = sound_id; e.end_game = end_game;
+    e.trigger_timer = trigger_timer; e.scroll_section = scroll_section;
+    e.array_id = array_id;
+}
+
+LevelData FileFormats::ReadLvlRawData(QByteArray RawData)
+{
+    LevelData FileData = dummyLvlDataArray();
+    FileData.sections.clear();
+    FileData.layers.clear();
+    FileData.events.clear();
+
+    QDataStream in(RawData);
+    in.setVersion(QDataStream::Qt_4_8);
+
+    quint32 magic; quint16 version; quint32 count;
+    qint32 stars, cursection;
+
+    in >> magic >> version;
+    if((magic != LVL_RAW_MAGIC) || (version != LVL_RAW_VERSION))
+    {
+        FileData.ReadFileValid = false;
+        return FileData;
+    }
+
+    in >> stars >> FileData.LevelName;
+    FileData.stars = stars;
+
+    in >> FileData.blocks_array_id >> FileData.bgo_array_id
+       >> FileData.npc_array_id >> FileData.doors_array_id
+       >> FileData.physenv_array_id >> FileData.layers_array_id
+       >> FileData.events_array_id;
+
+    #define READ_RAW_ARRAY(array, type, reader) \
+        in >> count; \
+        /* Damaged count must not reserve more than the data has */ \
+        array.reserve(qMin(count, quint32(in.device()->bytesAvailable()/LVL_RAW_MIN_RECORD))); \
+        for(quint32 i=0; (i<count) && (in.status()==QDataStream::Ok); i++) \
+        { type item; reader(in, item); array.push_back(item); }
+
+    READ_RAW_ARRAY(FileData.sections, LevelSection, readRawSection)
+    READ_RAW_ARRAY(FileData.players,  PlayerPoint,  readRawPlayer)
+    READ_RAW_ARRAY(FileData.blocks,   LevelBlock,   readRawBlock)
+    READ_RAW_ARRAY(FileData.bgo,      LevelBGO,     readRawBGO)
+    READ_RAW_ARRAY(FileData.npc,      LevelNPC,     readRawNPC)
+    READ_RAW_ARRAY(FileData.doors,    LevelDoors,   readRawDoor)
+    READ_RAW_ARRAY(FileData.physez,   LevelPhysEnv, readRawPhysEnv)
+    READ_RAW_ARRAY(FileData.layers,   LevelLayers,  readRawLayer)
+    READ_RAW_ARRAY(FileData.events,   LevelEvents,  readRawEvent)
+
+    #undef READ_RAW_ARRAY
+
+    in >> count;
+    for(quint32 i=0; (i<count) && (in.status()==QDataStream::Ok); i++)
+    {
+        Bookmark b; double x, y;
+        in >> b.bookmarkName >> x >> y;
+        b.x = x; b.y = y;
+        FileData.metaData.bookmarks.push_back(b);
+    }
+
+    in >> cursection >> FileData.playmusic
+       >> FileData.modified >> FileData.untitled >> FileData.smbx64strict
+       >> FileData.filename >> FileData.path;
+    FileData.CurSection = cursection;
+
+    FileData.ReadFileValid = (in.status()==QDataStream::Ok);
+    return FileData;
+}
@@ -0,0 +1,98 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lvl_sort.h"
+
+#include <algorithm>
+
+QVector<int> LvlSort::identity(int size)
+{
+    QVector<int> order(size);
+    for(int i=0; i<size; i++)
+        order[i] = i;
+    return order;
+}
+
+QVector<int> LvlSort::blocksSMBX64(const QVector<LevelBlock > &blocks)
+{
+    QVector<int> order = identity(blocks.size());
+    std::stable_sort(order.begin(), order.end(), [&blocks](int a, int b)
+    {
+        const LevelBlock &l = blocks[a];
+        const LevelBlock &r = blocks[b];
+        if(l.x != r.x) return l.x < r.x;
+        if(l.y != r.y) return l.y < r.y;
+        return l.array_id < r.array_id;
+    });
+    return order;
+}
+
+QVector<int> LvlSort::blocksByArrayID(const QVector<LevelBlock > &blocks)
+{
+    QVector<int> order = identity(blocks.size());
+    std::stable_sort(order.begin(), order.end(), [&blocks](int a, int b)
+    {
+        return blocks[a].array_id < blocks[b].array_id;
+    });
+    return order;
+}
+
+QVector<int> LvlSort::blocksByPos(const QVector<LevelBlock > &blocks)
+{
+    QVector<int> order = identity(blocks.size());
+    std::stable_sort(order.begin(), order.end(), [&blocks](int a, int b)
+    {
+        return blocks[a].x < blocks[b].x;
+    });
+    return order;
+}
+
+QVector<int> LvlSort::bgoSMBX64(const QVector<LevelBGO > &bgos)
+{
+    QVector<int> order = identity(bgos.size());
+    std::stable_sort(order.begin(), order.end(), [&bgos](int a, int b)
+    {
+        const LevelBGO &l = bgos[a];
+        const LevelBGO &r = bgos[b];
+        if(l.smbx64_sp_apply != r.smbx64_sp_apply) return l.smbx64_sp_apply < r.smbx64_sp_apply;
+        if(l.x != r.x) return l.x < r.x;
+        if(l.y != r.y) return l.y < r.y;
+        return l.array_id < r.array_id;
+    });
+    return order;
+}
+
+QVector<int> LvlSort::bgoByArrayID(const QVector<LevelBGO > &bgos)
+{
+    QVector<int> order = identity(bgos.size());
+    std::stable_sort(order.begin(), order.end(), [&bgos](int a, int b)
+    {
+        return bgos[a].array_id < bgos[b].array_id;
+    });
+    return order;
+}
+
+QVector<int> LvlSort::npcByArrayID(const QVector<LevelNPC > &npcs)
+{
+    QVector<int> order = identity(npcs.size());
+    std::stable_sort(order.begin(), order.end(), [&npcs](int a, int b)
+    {
+        return npcs[a].array_id < npcs[b].array_id;
+    });
+    return order;
+}
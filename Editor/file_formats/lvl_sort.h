@@ -0,0 +1,65 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LVL_SORT_H
+#define LVL_SORT_H
+
+#include <QVector>
+#include "lvl_filedata.h"
+
+/*!
+ * \brief Ordering of LevelData arrays
+ *
+ * All functions are stable O(n log n) sorts which are returning
+ * a permutation of indexes instead of moving whole structures.
+ * Use applyOrder() to reorder an array by permutation when it is really needed.
+ */
+class LvlSort
+{
+public:
+    //! SMBX64 file order of blocks: X, Y, array_id
+    static QVector<int> blocksSMBX64(const QVector<LevelBlock > &blocks);
+    //! Blocks by array_id
+    static QVector<int> blocksByArrayID(const QVector<LevelBlock > &blocks);
+    //! Blocks by X position
+    static QVector<int> blocksByPos(const QVector<LevelBlock > &blocks);
+
+    //! SMBX64 file order of BGO: smbx64_sp_apply, X, Y, array_id
+    static QVector<int> bgoSMBX64(const QVector<LevelBGO > &bgos);
+    //! BGO by array_id
+    static QVector<int> bgoByArrayID(const QVector<LevelBGO > &bgos);
+
+    //! NPC by array_id
+    static QVector<int> npcByArrayID(const QVector<LevelNPC > &npcs);
+
+    //! Reorder array by permutation given by one of functions above
+    template<class T>
+    static void applyOrder(QVector<T > &array, const QVector<int> &order)
+    {
+        QVector<T > sorted;
+        sorted.reserve(order.size());
+        for(int i=0; i<order.size(); i++)
+            sorted.push_back(array.at(order[i]));
+        array.swap(sorted);
+    }
+
+private:
+    static QVector<int> identity(int size);
+};
+
+#endif // LVL_SORT_H
@@ -18,22 +18,45 @@
 
 #include "file_formats.h"
 
+#include <QThreadStorage>
+
 namespace PGEExtendedFormat
 {
-    QRegExp qstr = QRegExp("^\"(?:[^\"\\\\]|\\\\.)*\"$");
-    QRegExp heximal = QRegExp("^[0-9a-fA-F]+$");
+    //QRegExp keeps state of last match, so every thread which parses files has own validators
+    struct Validators
+    {
+        Validators() :
+            qstr("^\"(?:[^\"\\\\]|\\\\.)*\"$"),
+            heximal("^[0-9a-fA-F]+$"),
+            boolean("^(1|0)$"),
+            usig_int("\\d+"),     //Check "Is Numeric"
+            sig_int("^[\\-0]?\\d*$"),     //Check "Is signed Numeric"
+            floatptr("^[\\-]?(\\d*)?[\\(.|,)]?\\d*[Ee]?[\\-\\+]?\\d*$"),     //Check "Is signed Float Numeric"
+            boolArray("^[1|0]+$"),
+            intArray("^\\[(\\-?\\d+,?)*\\]$") // ^\[(\-?\d+,?)*\]$
+        {}
+
+        QRegExp qstr;
+        QRegExp heximal;
 
-    QRegExp boolean = QRegExp("^(1|0)$");
+        QRegExp boolean;
 
-    QRegExp usig_int = QRegExp("\\d+");     //Check "Is Numeric"
-    QRegExp sig_int = QRegExp("^[\\-0]?\\d*$");     //Check "Is signed Numeric"
+        QRegExp usig_int;
+        QRegExp sig_int;
 
-    QRegExp floatptr = QRegExp("^[\\-]?(\\d*)?[\\(.|,)]?\\d*[Ee]?[\\-\\+]?\\d*$");     //Check "Is signed Float Numeric"
+        QRegExp floatptr;
 
-    //Arrays
-    QRegExp boolArray = QRegExp("^[1|0]+$");
-    QRegExp intArray = QRegExp("^\\[(\\-?\\d+,?)*\\]$"); // ^\[(\-?\d+,?)*\]$
+        //Arrays
+        QRegExp boolArray;
+        QRegExp intArray;
+    };
 
+    static QThreadStorage<Validators> threadValidators;
+
+    static Validators &validators()
+    {
+        return threadValidators.localData();
+    }
 }
 
 
@@ -41,50 +64,50 @@ namespace PGEExtendedFormat
 bool PGEFile::IsQStr(QString in) // QUOTED STRING
 {
     using namespace PGEExtendedFormat;
-    return qstr.exactMatch(in);
+    return validators().qstr.exactMatch(in);
 }
 
 bool PGEFile::IsHex(QString in) // Heximal string
 {
     using namespace PGEExtendedFormat;
-    return heximal.exactMatch(in);
+    return validators().heximal.exactMatch(in);
 }
 
 bool PGEFile::IsBool(QString in) // Boolean
 {
     using namespace PGEExtendedFormat;
-    return boolean.exactMatch(in);
+    return validators().boolean.exactMatch(in);
 }
 
 bool PGEFile::IsIntU(QString in) // Unsigned Int
 {
     using namespace PGEExtendedFormat;
-    return usig_int.exactMatch(in);
+    return validators().usig_int.exactMatch(in);
 }
 
 bool PGEFile::IsIntS(QString in) // Signed Int
 {
     using namespace PGEExtendedFormat;
-    return sig_int.exactMatch(in);
+    return validators().sig_int.exactMatch(in);
 }
 
 bool PGEFile::IsFloat(QString in) // Float Point numeric
 {
     using namespace PGEExtendedFormat;
-    return floatptr.exactMatch(in);
+    return validators().floatptr.exactMatch(in);
 }
 
 
 bool PGEFile::IsBoolArray(QString in) // Boolean array
 {
     using namespace PGEExtendedFormat;
-    return boolArray.exactMatch(in);
+    return validators().boolArray.exactMatch(in);
 }
 
 bool PGEFile::IsIntArray(QString in) // Boolean array
 {
     using namespace PGEExtendedFormat;
-    return intArray.exactMatch(in);
+    return validators().intArray.exactMatch(in);
 }
 
 bool PGEFile::IsStringArray(QString in) // String array
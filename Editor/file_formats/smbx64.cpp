@@ -18,14 +18,36 @@
 
 #include "file_formats.h"
 
+#include <QThreadStorage>
+
 namespace smbx64Format
 {
-    QRegExp isint = QRegExp("\\d+");     //Check "Is Numeric"
-    QRegExp issint = QRegExp("^[\\-0]?\\d*$");     //Check "Is signed Numeric"
-    QRegExp issfloat = QRegExp("^[\\-]?(\\d*)?[\\(.|,)]?\\d*[Ee]?[\\-\\+]?\\d*$");     //Check "Is signed Float Numeric"
-    QRegExp qstr = QRegExp("^\"(?:[^\"\\\\]|\\\\.)*\"$");
-    QRegExp boolwords = QRegExp("^(#TRUE#|#FALSE#)$");
-    QRegExp booldeg = QRegExp("^(1|0)$");
+    //QRegExp keeps state of last match, so every thread which parses files has own validators
+    struct Validators
+    {
+        Validators() :
+            isint("\\d+"),     //Check "Is Numeric"
+            issint("^[\\-0]?\\d*$"),     //Check "Is signed Numeric"
+            issfloat("^[\\-]?(\\d*)?[\\(.|,)]?\\d*[Ee]?[\\-\\+]?\\d*$"),     //Check "Is signed Float Numeric"
+            qstr("^\"(?:[^\"\\\\]|\\\\.)*\"$"),
+            boolwords("^(#TRUE#|#FALSE#)$"),
+            booldeg("^(1|0)$")
+        {}
+
+        QRegExp isint;
+        QRegExp issint;
+        QRegExp issfloat;
+        QRegExp qstr;
+        QRegExp boolwords;
+        QRegExp booldeg;
+    };
+
+    static QThreadStorage<Validators> threadValidators;
+
+    static Validators &validators()
+    {
+        return threadValidators.localData();
+    }
 }
 
 // /////////////Validators///////////////
@@ -34,37 +56,37 @@ namespace smbx64Format
 bool SMBX64::Int(QString in) // UNSIGNED INT
 {
     using namespace smbx64Format;
-    return !isint.exactMatch(in);
+    return !validators().isint.exactMatch(in);
 }
 
 bool SMBX64::sInt(QString in) // SIGNED INT
 {
     using namespace smbx64Format;
-    return !issint.exactMatch(in);
+    return !validators().issint.exactMatch(in);
 }
 
 bool SMBX64::sFloat(QString in) // SIGNED FLOAT
 {
     using namespace smbx64Format;
-    return !issfloat.exactMatch(in);
+    return !validators().issfloat.exactMatch(in);
 }
 
 bool SMBX64::qStr(QString in) // QUOTED STRING
 {
     using namespace smbx64Format;
-    return !qstr.exactMatch(in);
+    return !validators().qstr.exactMatch(in);
 }
 
 bool SMBX64::wBool(QString in) //Worded BOOL
 {
     using namespace smbx64Format;
-    return !boolwords.exactMatch(in);
+    return !validators().boolwords.exactMatch(in);
 }
 
 bool SMBX64::dBool(QString in) //Digital BOOL
 {
     using namespace smbx64Format;
-    return !booldeg.exactMatch(in);
+    return !validators().booldeg.exactMatch(in);
 }
 
 
@@ -27,6 +27,14 @@
 #include "../common_features/mainwinconnect.h"
 #include "../file_formats/file_formats.h"
 #include "../main_window/music_player.h"
+#include "../networking/engine_intproc.h"
+
+//Operations smaller than this (in bytes) are never compressed
+static const qint64 historyPackThreshold = 16*1024;
+//Count of operations around current history position which are kept unpacked
+static const int historyUnpackedWindow = 2;
+//Idle time after last history change before compression will be started (ms)
+static const int historyCompressDelay = 2000;
 
 void LvlScene::addRemoveHistory(LevelData removedItems)
 {
@@ -38,6 +46,8 @@ void LvlScene::addRemoveHistory(LevelData removedItems)
     rmOperation.data = removedItems;
     operationList.push_back(rmOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -53,6 +63,8 @@ void LvlScene::addPlaceHistory(LevelData placedItems)
 
     operationList.push_back(plOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -68,6 +80,8 @@ void LvlScene::addOverwriteHistory(LevelData removedItems, LevelData placedItems
 
     operationList.push_back(ovOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -87,6 +101,7 @@ void LvlScene::addPlaceDoorHistory(int array_id, bool isEntrance, long x, long y
 
     operationList.push_back(plDoorOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -105,11 +120,13 @@ void LvlScene::addMoveHistory(LevelData sourceMovedItems, LevelData targetMovedI
 
     HistoryOperation mvOperation;
     mvOperation.type = HistoryOperation::LEVELHISTORY_MOVE;
-    mvOperation.data = sourceMovedItems;
+    mvOperation.data = historyCompactMoveData(sourceMovedItems);
     mvOperation.x = baseX;
     mvOperation.y = baseY;
     operationList.push_back(mvOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -125,6 +142,8 @@ void LvlScene::addChangeSettingsHistory(LevelData modifiedItems, LvlScene::Setti
     modOperation.extraData = extraData;
     operationList.push_back(modOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -152,6 +171,7 @@ void LvlScene::addResizeSectionHistory(int sectionID, long oldLeft, long oldTop,
     resizeOperation.extraData = QVariant(package);
     operationList.push_back(resizeOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -166,6 +186,8 @@ void LvlScene::addChangedLayerHistory(LevelData changedItems, QString newLayerNa
     chLaOperation.data = changedItems;
     operationList.push_back(chLaOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -195,6 +217,8 @@ void LvlScene::addResizeBlockHistory(LevelBlock bl, long oldLeft, long oldTop, l
     resizeBlOperation.extraData = QVariant(package);
     operationList.push_back(resizeBlOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -224,6 +248,7 @@ void LvlScene::addResizeWaterHistory(LevelPhysEnv wt, long oldLeft, long oldTop,
     resizeWtOperation.extraData = QVariant(package);
     operationList.push_back(resizeWtOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -241,6 +266,7 @@ void LvlScene::addAddWarpHistory(int array_id, int listindex, int doorindex)
     addWpOperation.extraData = QVariant(package);
     operationList.push_back(addWpOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -256,6 +282,7 @@ void LvlScene::addRemoveWarpHistory(LevelDoors removedDoor)
     rmWpOperation.data = data;
     operationList.push_back(rmWpOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -273,6 +300,7 @@ void LvlScene::addChangeWarpSettingsHistory(int array_id, LvlScene::SettingSubTy
     chWpSettingsOperation.extraData = QVariant(package);
     operationList.push_back(chWpSettingsOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -289,6 +317,7 @@ void LvlScene::addAddEventHistory(int array_id, QString name)
     addEvOperation.extraData = QVariant(package);
     operationList.push_back(addEvOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -302,6 +331,7 @@ void LvlScene::addRemoveEventHistory(LevelEvents ev)
     rmEvOperation.data.events.push_back(ev);
     operationList.push_back(rmEvOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -315,6 +345,7 @@ void LvlScene::addDuplicateEventHistory(LevelEvents newDuplicate)
     dupEvOperation.data.events.push_back(newDuplicate);
     operationList.push_back(dupEvOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -332,6 +363,7 @@ void LvlScene::addChangeEventSettingsHistory(int array_id, LvlScene::SettingSubT
     chEvSettingsOperation.extraData = QVariant(package);
     operationList.push_back(chEvSettingsOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -347,6 +379,8 @@ void LvlScene::addChangedNewLayerHistory(LevelData changedItems, LevelLayers new
     chNewLaOperation.data = changedItems;
     operationList.push_back(chNewLaOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -363,6 +397,7 @@ void LvlScene::addAddLayerHistory(int array_id, QString name)
     addNewLaOperation.extraData = QVariant(layerData);
     operationList.push_back(addNewLaOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -376,6 +411,8 @@ void LvlScene::addRemoveLayerHistory(LevelData modData)
     rmLaOperation.data = modData;
     operationList.push_back(rmLaOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -393,6 +430,7 @@ void LvlScene::addRenameEventHistory(int array_id, QString oldName, QString newN
     renameEvOperation.extraData = QVariant(renameData);
     operationList.push_back(renameEvOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -410,6 +448,7 @@ void LvlScene::addRenameLayerHistory(int array_id, QString oldName, QString newN
     renameLaOperation.extraData = QVariant(renameData);
     operationList.push_back(renameLaOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -424,6 +463,8 @@ void LvlScene::addRemoveLayerAndSaveItemsHistory(LevelData modData)
     rmLaAndSaveItemsOperation.extraData = QVariant(QString("Default"));
     operationList.push_back(rmLaAndSaveItemsOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -438,6 +479,8 @@ void LvlScene::addMergeLayer(LevelData mergedData, QString newLayerName)
     mergeLaOperation.extraData = QVariant(newLayerName);
     operationList.push_back(mergeLaOperation);
     historyIndex++;
+    historyApplyLimits();
+    historySyncToEngine(operationList.last());
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -455,6 +498,7 @@ void LvlScene::addChangeSectionSettingsHistory(int sectionID, LvlScene::SettingS
     chSecSettingsOperation.extraData = QVariant(package);
     operationList.push_back(chSecSettingsOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -469,6 +513,7 @@ void LvlScene::addChangeLevelSettingsHistory(LvlScene::SettingSubType subtype, Q
     chLevelSettingsOperation.extraData = extraData;
     operationList.push_back(chLevelSettingsOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -484,6 +529,7 @@ void LvlScene::addPlacePlayerPointHistory(PlayerPoint plr, QVariant oldPos)
         plPlrPointOperation.extraData = oldPos;
     operationList.push_back(plPlrPointOperation);
     historyIndex++;
+    historyApplyLimits();
 
     MainWinConnect::pMainWin->refreshHistoryButtons();
 }
@@ -491,7 +537,9 @@ void LvlScene::addPlacePlayerPointHistory(PlayerPoint plr, QVariant oldPos)
 void LvlScene::historyBack()
 {
     historyIndex--;
+    historyUnpackOperation(operationList[historyIndex]);
     HistoryOperation lastOperation = operationList[historyIndex];
+    beginArrayRemoval();
 
     switch( lastOperation.type )
     {
@@ -1533,7 +1581,10 @@ void LvlScene::historyBack()
     default:
         break;
     }
+    endArrayRemoval();
     LvlData->modified = true;
+    historySyncToEngine(lastOperation);
+    historyCompressTimer.start(historyCompressDelay);
 
     Debugger_updateItemList();
     MainWinConnect::pMainWin->refreshHistoryButtons();
@@ -1542,8 +1593,9 @@ void LvlScene::historyBack()
 
 void LvlScene::historyForward()
 {
-
+    historyUnpackOperation(operationList[historyIndex]);
     HistoryOperation lastOperation = operationList[historyIndex];
+    beginArrayRemoval();
 
     switch( lastOperation.type )
     {
@@ -1829,7 +1881,10 @@ void LvlScene::historyForward()
         }
 
         if(!found)
+        {
+            endArrayRemoval();
             return;
+        }
 
         bool isEntrance = lastOperation.extraData.toList()[1].toBool();
 
@@ -2437,7 +2492,10 @@ void LvlScene::historyForward()
         break;
 
     }
+    endArrayRemoval();
     historyIndex++;
+    historySyncToEngine(lastOperation);
+    historyCompressTimer.start(historyCompressDelay);
 
     Debugger_updateItemList();
     MainWinConnect::pMainWin->refreshHistoryButtons();
@@ -2471,6 +2529,300 @@ bool LvlScene::canRedo()
     return historyIndex < operationList.size();
 }
 
+/*
+ * History memory control
+ *
+ * Every history step keeps copies of changed items. To avoid unlimited grow of memory:
+ * - moves are stored as array_id + position only,
+ * - big steps out of current undo/redo position are compressed
+ *   by timer while editor is idle,
+ * - oldest steps are removed when history reached memory limit
+ *   (GlobalSettings::historyMemoryLimit, in megabytes, 0 - unlimited).
+ */
+
+static qint64 historyStrSize(const QString &str)
+{
+    return (qint64)str.size()*sizeof(QChar);
+}
+
+static qint64 historyLvlDataSize(const LevelData &d)
+{
+    qint64 size = sizeof(LevelData) + historyStrSize(d.LevelName);
+
+    size += d.sections.size()*sizeof(LevelSection);
+    foreach(const LevelSection &x, d.sections)
+        size += historyStrSize(x.music_file);
+
+    size += d.players.size()*sizeof(PlayerPoint);
+
+    size += d.blocks.size()*sizeof(LevelBlock);
+    foreach(const LevelBlock &x, d.blocks)
+        size += historyStrSize(x.layer)+historyStrSize(x.event_destroy)
+               +historyStrSize(x.event_hit)+historyStrSize(x.event_no_more);
+
+    size += d.bgo.size()*sizeof(LevelBGO);
+    foreach(const LevelBGO &x, d.bgo)
+        size += historyStrSize(x.layer);
+
+    size += d.npc.size()*sizeof(LevelNPC);
+    foreach(const LevelNPC &x, d.npc)
+        size += historyStrSize(x.msg)+historyStrSize(x.layer)
+               +historyStrSize(x.event_activate)+historyStrSize(x.event_die)
+               +historyStrSize(x.event_talk)+historyStrSize(x.event_nomore)
+               +historyStrSize(x.attach_layer);
+
+    size += d.doors.size()*sizeof(LevelDoors);
+    foreach(const LevelDoors &x, d.doors)
+        size += historyStrSize(x.lname)+historyStrSize(x.layer);
+
+    size += d.physez.size()*sizeof(LevelPhysEnv);
+    foreach(const LevelPhysEnv &x, d.physez)
+        size += historyStrSize(x.layer);
+
+    size += d.layers.size()*sizeof(LevelLayers);
+    foreach(const LevelLayers &x, d.layers)
+        size += historyStrSize(x.name);
+
+    size += d.events.size()*sizeof(LevelEvents);
+    foreach(const LevelEvents &x, d.events)
+    {
+        size += historyStrSize(x.name)+historyStrSize(x.msg)
+               +historyStrSize(x.trigger)+historyStrSize(x.movelayer);
+        size += x.layers.size()*sizeof(LevelEvents_layers);
+        size += x.sets.size()*sizeof(LevelEvents_Sets);
+        size += (x.layers_hide.join("").size()+x.layers_show.join("").size()
+                +x.layers_toggle.join("").size())*sizeof(QChar);
+    }
+
+    return size;
+}
+
+static void historyClearLvlData(LevelData &d)
+{
+    d.LevelName.clear();
+    d.sections.clear();
+    d.players.clear();
+    d.blocks.clear();
+    d.bgo.clear();
+    d.npc.clear();
+    d.doors.clear();
+    d.physez.clear();
+    d.layers.clear();
+    d.events.clear();
+    d.metaData.bookmarks.clear();
+    d.filename.clear();
+    d.path.clear();
+}
+
+LevelData LvlScene::historyCompactMoveData(LevelData &data)
+{
+    //Undo/redo of move needs only identifiers and positions
+    LevelData compact = FileFormats::dummyLvlDataArray();
+    historyClearLvlData(compact);
+
+    LevelBlock blankBlock = FileFormats::dummyLvlBlock();
+    blankBlock.layer.clear();
+    compact.blocks.reserve(data.blocks.size());
+    foreach(const LevelBlock &x, data.blocks)
+    {
+        LevelBlock b = blankBlock;
+        b.array_id = x.array_id;
+        b.x = x.x; b.y = x.y;
+        b.w = x.w; b.h = x.h;
+        compact.blocks.push_back(b);
+    }
+
+    LevelBGO blankBGO = FileFormats::dummyLvlBgo();
+    blankBGO.layer.clear();
+    compact.bgo.reserve(data.bgo.size());
+    foreach(const LevelBGO &x, data.bgo)
+    {
+        LevelBGO b = blankBGO;
+        b.array_id = x.array_id;
+        b.x = x.x; b.y = x.y;
+        compact.bgo.push_back(b);
+    }
+
+    LevelNPC blankNPC = FileFormats::dummyLvlNpc();
+    blankNPC.layer.clear();
+    compact.npc.reserve(data.npc.size());
+    foreach(const LevelNPC &x, data.npc)
+    {
+        LevelNPC n = blankNPC;
+        n.array_id = x.array_id;
+        n.x = x.x; n.y = x.y;
+        compact.npc.push_back(n);
+    }
+
+    LevelPhysEnv blankWater = FileFormats::dummyLvlPhysEnv();
+    blankWater.layer.clear();
+    compact.physez.reserve(data.physez.size());
+    foreach(const LevelPhysEnv &x, data.physez)
+    {
+        LevelPhysEnv w = blankWater;
+        w.array_id = x.array_id;
+        w.x = x.x; w.y = x.y;
+        w.w = x.w; w.h = x.h;
+        compact.physez.push_back(w);
+    }
+
+    LevelDoors blankDoor = FileFormats::dummyLvlDoor();
+    blankDoor.layer.clear();
+    foreach(const LevelDoors &x, data.doors)
+    {
+        LevelDoors d = blankDoor;
+        d.array_id = x.array_id;
+        d.ix = x.ix; d.iy = x.iy; d.isSetIn = x.isSetIn;
+        d.ox = x.ox; d.oy = x.oy; d.isSetOut = x.isSetOut;
+        d.lvl_i = x.lvl_i; d.lvl_o = x.lvl_o;
+        compact.doors.push_back(d);
+    }
+
+    compact.players = data.players;
+
+    return compact;
+}
+
+qint64 LvlScene::historyOperationSize(HistoryOperation &operation)
+{
+    qint64 size = sizeof(HistoryOperation);
+    if(operation.packed)
+        size += operation.packedData.size() + operation.packedDataMod.size();
+    else
+        size += historyLvlDataSize(operation.data) + historyLvlDataSize(operation.data_mod);
+    return size;
+}
+
+void LvlScene::historyPackOperation(HistoryOperation &operation)
+{
+    if(operation.packed) return;
+
+    operation.packedData    = qCompress(FileFormats::WriteLvlRawData(operation.data));
+    operation.packedDataMod = qCompress(FileFormats::WriteLvlRawData(operation.data_mod));
+    historyClearLvlData(operation.data);
+    historyClearLvlData(operation.data_mod);
+    operation.packed = true;
+    operation.memSize = historyOperationSize(operation);
+}
+
+void LvlScene::historyUnpackOperation(HistoryOperation &operation)
+{
+    if(!operation.packed) return;
+
+    operation.data     = FileFormats::ReadLvlRawData(qUncompress(operation.packedData));
+    operation.data_mod = FileFormats::ReadLvlRawData(qUncompress(operation.packedDataMod));
+    operation.packedData.clear();
+    operation.packedDataMod.clear();
+    operation.packed = false;
+    operation.memSize = historyOperationSize(operation);
+}
+
+/**
+ * @brief LvlScene::historySyncToEngine
+ *  Sends blocks and BGO touched by operation to the engine which is testing this level.
+ *  Operation must be already applied: every touched item which is still in the level
+ *  is sent in it's current state, others are sent as removed.
+ */
+void LvlScene::historySyncToEngine(const HistoryOperation &operation)
+{
+    if(!IntEngine::engineSocket) return;
+    if(!IntEngine::engineSocket->isLiveSource(LvlData)) return;
+    if(operation.packed) return;
+
+    QSet<unsigned int> blockIDs;
+    QSet<unsigned int> bgoIDs;
+    foreach(const LevelBlock &b, operation.data.blocks)     blockIDs.insert(b.array_id);
+    foreach(const LevelBlock &b, operation.data_mod.blocks) blockIDs.insert(b.array_id);
+    foreach(const LevelBGO &b, operation.data.bgo)          bgoIDs.insert(b.array_id);
+    foreach(const LevelBGO &b, operation.data_mod.bgo)      bgoIDs.insert(b.array_id);
+
+    IntProcProto::LevelDelta delta;
+    foreach(unsigned int id, blockIDs)
+    {
+        int i = blocks_byArrayId.find(LvlData->blocks, id);
+        if(i>=0)
+            delta.blocks.push_back(LvlData->blocks[i]);
+        else
+            delta.removedBlocks.push_back(id);
+    }
+    foreach(unsigned int id, bgoIDs)
+    {
+        int i = bgo_byArrayId.find(LvlData->bgo, id);
+        if(i>=0)
+            delta.bgo.push_back(LvlData->bgo[i]);
+        else
+            delta.removedBGO.push_back(id);
+    }
+
+    IntEngine::engineSocket->sendLevelDelta(delta);
+}
+
+qint64 LvlScene::historyMemoryUsage()
+{
+    qint64 total = 0;
+    for(int i = 0; i < operationList.size(); i++)
+    {
+        if(operationList[i].memSize < 0)
+            operationList[i].memSize = historyOperationSize(operationList[i]);
+        total += operationList[i].memSize;
+    }
+    return total;
+}
+
+int LvlScene::historyPackedCount()
+{
+    int packed = 0;
+    foreach(const HistoryOperation &op, operationList)
+        if(op.packed) packed++;
+    return packed;
+}
+
+void LvlScene::historyApplyLimits()
+{
+    qint64 limit = (qint64)GlobalSettings::historyMemoryLimit*1024*1024;
+    if(limit > 0)
+    {
+        //Remove oldest operations, but always keep the latest one
+        qint64 total = historyMemoryUsage();
+        while((total > limit) && (historyIndex > 1))
+        {
+            total -= operationList.first().memSize;
+            operationList.pop_front();
+            historyIndex--;
+        }
+    }
+
+    historyCompressTimer.start(historyCompressDelay);
+}
+
+void LvlScene::historyCompressStep()
+{
+    //Pack one big operation per step to keep editor responsive
+    for(int i = 0; i < operationList.size(); i++)
+    {
+        HistoryOperation &op = operationList[i];
+        if(op.packed) continue;
+        if(qAbs(i - historyIndex) <= historyUnpackedWindow) continue;
+        if(op.memSize < 0)
+            op.memSize = historyOperationSize(op);
+        if(op.memSize < historyPackThreshold) continue;
+
+        historyPackOperation(op);
+        historyCompressTimer.start(0);
+        return;
+    }
+}
+
+void LvlScene::historyCompressAll()
+{
+    historyCompressTimer.stop();
+    for(int i = 0; i < operationList.size(); i++)
+    {
+        if(qAbs(i - historyIndex) <= historyUnpackedWindow) continue;
+        historyPackOperation(operationList[i]);
+    }
+}
+
 void LvlScene::historyRedoMoveBlocks(CallbackData cbData, LevelBlock data)
 {
 
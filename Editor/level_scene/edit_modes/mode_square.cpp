@@ -208,26 +208,9 @@ void LVL_ModeSquare::mouseRelease(QGraphicsSceneMouseEvent *mouseEvent)
                 }
                 else
                 {
-                    QPointF p = ((QGraphicsRectItem *)(s->cursor))->scenePos();
-                    QSizeF sz = ((QGraphicsRectItem *)(s->cursor))->rect().size();
-
-                    WriteToLog(QtDebugMsg, "Get collision buffer");
-
-                    s->collisionCheckBuffer = s->items(QRectF(
-                                p.x()-10, p.y()-10,
-                                sz.width()+20, sz.height()+20),
-                                Qt::IntersectsItemBoundingRect);
-                    if(s->collisionCheckBuffer.isEmpty())
-                        s->emptyCollisionCheck = true;
-                    else
-                        s->prepareCollisionBuffer();
-
+                    //Each cell is checked by item grids of scene, no collision buffer needed
                     WriteToLog(QtDebugMsg, "Placing");
                     s->placeItemsByRectArray();
-
-                    WriteToLog(QtDebugMsg, "clear collision buffer");
-                    s->emptyCollisionCheck = false;
-                    s->collisionCheckBuffer.clear();
                     WriteToLog(QtDebugMsg, "Done");
 
                     s->Debugger_updateItemList();
@@ -236,24 +219,8 @@ void LVL_ModeSquare::mouseRelease(QGraphicsSceneMouseEvent *mouseEvent)
             }
         case LvlScene::PLC_BGO:
             {
-                QPointF p = ((QGraphicsRectItem *)(s->cursor))->scenePos();
-                QSizeF sz = ((QGraphicsRectItem *)(s->cursor))->rect().size();
-
-                s->collisionCheckBuffer = s->items(QRectF(
-                            p.x()-10, p.y()-10,
-                            sz.width()+20, sz.height()+20),
-                            Qt::IntersectsItemBoundingRect);
-
-                if(s->collisionCheckBuffer.isEmpty())
-                    s->emptyCollisionCheck = true;
-                else
-                    s->prepareCollisionBuffer();
-
                 s->placeItemsByRectArray();
 
-                s->emptyCollisionCheck = false;
-                s->collisionCheckBuffer.clear();
-
                 s->Debugger_updateItemList();
              break;
             }
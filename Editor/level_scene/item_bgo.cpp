@@ -46,6 +46,10 @@ ItemBGO::ItemBGO(QGraphicsItem *parent)
     mouseLeft=false;
     mouseMid=false;
     mouseRight=false;
+
+    scene=NULL;
+    //Needed to keep position in the collision grid
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
 }
 
 
@@ -53,6 +57,16 @@ ItemBGO::~ItemBGO()
 {
     //WriteToLog(QtDebugMsg, "!<-BGO destroyed->!");
     //if(timer) delete timer;
+
+    if(scene) scene->bgoGrid.remove(this);
+}
+
+QVariant ItemBGO::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    //Keep item in the collision grid
+    if((scene) && ((change==ItemPositionHasChanged)||(change==ItemSceneHasChanged)))
+        scene->updateGridItem(scene->bgoGrid, this);
+    return QGraphicsItem::itemChange(change, value);
 }
 
 void ItemBGO::mousePressEvent ( QGraphicsSceneMouseEvent * mouseEvent )
@@ -343,57 +357,24 @@ void ItemBGO::setLayer(QString layer)
 
 void ItemBGO::arrayApply()
 {
-    bool found=false;
     bgoData.x = qRound(this->scenePos().x());
     bgoData.y = qRound(this->scenePos().y());
-    if(bgoData.index < (unsigned int)scene->LvlData->bgo.size())
-    { //Check index
-        if(bgoData.array_id == scene->LvlData->bgo[bgoData.index].array_id)
-        {
-            found=true;
-        }
-    }
 
     //Apply current data in main array
-    if(found)
-    { //directlry
-        scene->LvlData->bgo[bgoData.index] = bgoData; //apply current bgoData
-    }
-    else
-    for(int i=0; i<scene->LvlData->bgo.size(); i++)
-    { //after find it into array
-        if(scene->LvlData->bgo[i].array_id == bgoData.array_id)
-        {
-            bgoData.index = i;
-            scene->LvlData->bgo[i] = bgoData;
-            break;
-        }
+    int i = scene->bgo_byArrayId.find(scene->LvlData->bgo, bgoData.array_id, bgoData.index);
+    if(i >= 0)
+    {
+        bgoData.index = i;
+        scene->LvlData->bgo[i] = bgoData; //apply current bgoData
     }
 }
 
 void ItemBGO::removeFromArray()
 {
-    bool found=false;
-    if(bgoData.index < (unsigned int)scene->LvlData->bgo.size())
-    { //Check index
-        if(bgoData.array_id == scene->LvlData->bgo[bgoData.index].array_id)
-        {
-            found=true;
-        }
-    }
-
-    if(found)
-    { //directlry
-        scene->LvlData->bgo.remove(bgoData.index);
-    }
+    if(scene->arrayRemovalDepth>0)
+        scene->bgo_byArrayId.markRemoved(bgoData.array_id);
     else
-    for(int i=0; i<scene->LvlData->bgo.size(); i++)
-    {
-        if(scene->LvlData->bgo[i].array_id == bgoData.array_id)
-        {
-            scene->LvlData->bgo.remove(i); break;
-        }
-    }
+        scene->bgo_byArrayId.remove(scene->LvlData->bgo, bgoData.array_id, bgoData.index);
 }
 
 void ItemBGO::setBGOData(LevelBGO inD)
@@ -493,4 +474,7 @@ void ItemBGO::setAnimator(long aniID)
     //WriteToLog(QtDebugMsg, QString("BGO Animator ID: %1").arg(aniID));
 
     animatorID = aniID;
+
+    //Size is changed, keep cells of the collision grid actual
+    scene->updateGridItem(scene->bgoGrid, this);
 }
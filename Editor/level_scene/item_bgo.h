@@ -78,6 +78,8 @@ public:
 
 
 protected:
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
     bool mouseLeft;
     bool mouseMid;
     bool mouseRight;
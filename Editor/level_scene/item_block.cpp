@@ -43,6 +43,12 @@ ItemBlock::ItemBlock(QGraphicsItem *parent)
     mouseLeft=false;
     mouseMid=false;
     mouseRight=false;
+
+    scene=NULL;
+    grp=NULL;
+    includedNPC=NULL;
+    //Needed to keep position in the collision grid
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
 }
 
 
@@ -53,6 +59,16 @@ ItemBlock::~ItemBlock()
     if(includedNPC!=NULL) delete includedNPC;
     if(grp!=NULL) delete grp;
     //if(timer) delete timer;
+
+    if(scene) scene->blocksGrid.remove(this);
+}
+
+QVariant ItemBlock::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    //Keep item in the collision grid
+    if((scene) && ((change==ItemPositionHasChanged)||(change==ItemSceneHasChanged)))
+        scene->updateGridItem(scene->blocksGrid, this);
+    return QGraphicsItem::itemChange(change, value);
 }
 
 void ItemBlock::mousePressEvent ( QGraphicsSceneMouseEvent * mouseEvent )
@@ -382,6 +398,9 @@ void ItemBlock::setIncludedNPC(int npcID, bool init)
                  ));
     includedNPC->setZValue(scene->Z_Block + 10);
     includedNPC->setOpacity(qreal(0.6));
+    //Group is created only for blocks which have included NPC,
+    //otherwise every block on the level gives one more item into the scene
+    if(!grp) grp = new QGraphicsItemGroup(this);
     grp->addToGroup(includedNPC);
 
     if(!init) blockData.npc_id = npcID;
@@ -391,54 +410,26 @@ void ItemBlock::setIncludedNPC(int npcID, bool init)
 ///////////////////MainArray functions/////////////////////////////
 void ItemBlock::arrayApply()
 {
-    bool found=false;
     blockData.x = qRound(this->scenePos().x());
     blockData.y = qRound(this->scenePos().y());
     if(this->data(3).toString()=="sizable")
         this->setZValue( scene->Z_blockSizable + ((double)blockData.y / (double) 100000000000) + 1 - ((double)blockData.w * (double)0.0000000000000001) );
-    if(blockData.index < (unsigned int)scene->LvlData->blocks.size())
-    { //Check index
-        if(blockData.array_id == scene->LvlData->blocks[blockData.index].array_id)
-            found=true;
-    }
 
     //Apply current data in main array
-    if(found)
-    { //directlry
-        scene->LvlData->blocks[blockData.index] = blockData; //apply current blockdata
-    }
-    else
-    for(int i=0; i<scene->LvlData->blocks.size(); i++)
-    { //after find it into array
-        if(scene->LvlData->blocks[i].array_id == blockData.array_id)
-        {
-            blockData.index = i;
-            scene->LvlData->blocks[i] = blockData;
-            break;
-        }
+    int i = scene->blocks_byArrayId.find(scene->LvlData->blocks, blockData.array_id, blockData.index);
+    if(i >= 0)
+    {
+        blockData.index = i;
+        scene->LvlData->blocks[i] = blockData; //apply current blockdata
     }
 }
 
 void ItemBlock::removeFromArray()
 {
-    bool found=false;
-    if(blockData.index < (unsigned int)scene->LvlData->blocks.size())
-    { //Check index
-        if(blockData.array_id == scene->LvlData->blocks[blockData.index].array_id)
-            found=true;
-    }
-    if(found)
-    { //directlry
-        scene->LvlData->blocks.remove(blockData.index);
-    }
+    if(scene->arrayRemovalDepth>0)
+        scene->blocks_byArrayId.markRemoved(blockData.array_id);
     else
-    for(int i=0; i<scene->LvlData->blocks.size(); i++)
-    {
-        if(scene->LvlData->blocks[i].array_id == blockData.array_id)
-        {
-            scene->LvlData->blocks.remove(i); break;
-        }
-    }
+        scene->blocks_byArrayId.remove(scene->LvlData->blocks, blockData.array_id, blockData.index);
 }
 
 void ItemBlock::setMainPixmap(/*const QPixmap &pixmap*/) // Init Sizable block
@@ -465,6 +456,7 @@ void ItemBlock::setBlockSize(QRect rect)
     imageSize = QRectF(0,0, blockData.w, blockData.h);
     setIncludedNPC(blockData.npc_id);
     arrayApply();
+    scene->updateGridItem(scene->blocksGrid, this);
     scene->update();
 }
 
@@ -524,6 +516,9 @@ void ItemBlock::setAnimator(long aniID)
 
     //WriteToLog(QtDebugMsg, QString("BGO Animator ID: %1").arg(aniID));
     animatorID = aniID;
+
+    //Size is changed, keep cells of the collision grid actual
+    scene->updateGridItem(scene->blocksGrid, this);
 }
 
 void ItemBlock::setContextMenu(QMenu &menu)
@@ -536,8 +531,6 @@ void ItemBlock::setContextMenu(QMenu &menu)
 void ItemBlock::setScenePoint(LvlScene *theScene)
 {
     scene = theScene;
-    grp = new QGraphicsItemGroup(this);
-    includedNPC = NULL;
 }
 
 
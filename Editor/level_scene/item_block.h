@@ -75,6 +75,8 @@ public:
     void setLocked(bool lock);
 
 protected:
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
     bool mouseLeft;
     bool mouseMid;
     bool mouseRight;
@@ -37,6 +37,7 @@ ItemNPC::ItemNPC(bool noScene, QGraphicsPixmapItem *parent)
     setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
     generatorArrow = NULL;
     includedNPC = NULL;
+    grp = NULL;
     DisableScene = noScene;
     animated = false;
     aniDirect=false;
@@ -67,6 +68,10 @@ ItemNPC::ItemNPC(bool noScene, QGraphicsPixmapItem *parent)
     mouseLeft=false;
     mouseMid=false;
     mouseRight=false;
+
+    scene=NULL;
+    //Needed to keep position in the collision grid
+    setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
 }
 
 
@@ -77,6 +82,15 @@ ItemNPC::~ItemNPC()
     if(grp!=NULL) delete grp;
     if(timer) delete timer;
 
+    if((!DisableScene)&&(scene)) scene->npcGrid.remove(this);
+}
+
+QVariant ItemNPC::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    //Keep item in the collision grid
+    if((!DisableScene) && (scene) && ((change==ItemPositionHasChanged)||(change==ItemSceneHasChanged)))
+        scene->updateGridItem(scene->npcGrid, this);
+    return QGraphicsPixmapItem::itemChange(change, value);
 }
 
 
@@ -567,6 +581,7 @@ void ItemNPC::setIncludedNPC(int npcID, bool init)
     }
     else
         includedNPC->setZValue(this->zValue() - 0.0000010);
+    if(!grp) grp = new QGraphicsItemGroup(this);
     grp->addToGroup(includedNPC);
 
     if(!init) npcData.special_data = npcID;
@@ -655,6 +670,7 @@ void ItemNPC::setGenerator(bool enable, int direction, int type, bool init)
                         offset.y()+this->scenePos().y()+qreal((qreal(localProps.height) - qreal(32))/qreal(2))
                      ));
 
+        if(!grp) grp = new QGraphicsItemGroup(this);
         grp->addToGroup( generatorArrow );
 
         if(!init) arrayApply();
@@ -681,31 +697,15 @@ void ItemNPC::arrayApply()
     if(DisableScene)
         return;
 
-    bool found=false;
-
     npcData.x = qRound(this->scenePos().x());
     npcData.y = qRound(this->scenePos().y());
 
-    if(npcData.index < (unsigned int)scene->LvlData->npc.size())
-    { //Check index
-        if(npcData.array_id == scene->LvlData->npc[npcData.index].array_id)
-            found=true;
-    }
-
     //Apply current data in main array
-    if(found)
-    { //directlry
-        scene->LvlData->npc[npcData.index] = npcData; //apply current npcData
-    }
-    else
-    for(int i=0; i<scene->LvlData->npc.size(); i++)
-    { //after find it into array
-        if(scene->LvlData->npc[i].array_id == npcData.array_id)
-        {
-            npcData.index = i;
-            scene->LvlData->npc[i] = npcData;
-            break;
-        }
+    int i = scene->npc_byArrayId.find(scene->LvlData->npc, npcData.array_id, npcData.index);
+    if(i >= 0)
+    {
+        npcData.index = i;
+        scene->LvlData->npc[i] = npcData; //apply current npcData
     }
 }
 
@@ -714,24 +714,10 @@ void ItemNPC::removeFromArray()
     if(DisableScene)
         return;
 
-    bool found=false;
-    if(npcData.index < (unsigned int)scene->LvlData->npc.size())
-    { //Check index
-        if(npcData.array_id == scene->LvlData->npc[npcData.index].array_id)
-            found=true;
-    }
-    if(found)
-    { //directlry
-        scene->LvlData->npc.remove(npcData.index);
-    }
+    if(scene->arrayRemovalDepth>0)
+        scene->npc_byArrayId.markRemoved(npcData.array_id);
     else
-    for(int i=0; i<scene->LvlData->npc.size(); i++)
-    {
-        if(scene->LvlData->npc[i].array_id == npcData.array_id)
-        {
-            scene->LvlData->npc.remove(i); break;
-        }
-    }
+        scene->npc_byArrayId.remove(scene->LvlData->npc, npcData.array_id, npcData.index);
 }
 
 
@@ -763,6 +749,9 @@ void ItemNPC::setMainPixmap(const QPixmap &pixmap)
 void ItemNPC::setNpcData(LevelNPC inD)
 {
     npcData = inD;
+    //Size may be changed in place, keep cells of the collision grid actual
+    if((!DisableScene)&&(scene))
+        scene->updateGridItem(scene->npcGrid, this);
 }
 
 
@@ -811,7 +800,6 @@ void ItemNPC::setContextMenu(QMenu &menu)
 void ItemNPC::setScenePoint(LvlScene *theScene)
 {
     scene = theScene;
-    grp = new QGraphicsItemGroup(this);
 }
 
 
@@ -851,6 +839,8 @@ void ItemNPC::setAnimator(long aniID)
     offseted.setRight(offseted.right()+this->offset().x());
     offseted.setBottom(offseted.bottom()+this->offset().y());
 
+    //Size is changed, keep cells of the collision grid actual
+    scene->updateGridItem(scene->npcGrid, this);
 }
 
 ////////////////Animation///////////////////
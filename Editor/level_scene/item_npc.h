@@ -92,6 +92,8 @@ public:
     void setAnimator(long aniID);
 
 protected:
+    virtual QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+
     bool mouseLeft;
     bool mouseMid;
     bool mouseRight;
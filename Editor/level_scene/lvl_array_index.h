@@ -0,0 +1,108 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LVL_ARRAY_INDEX_H
+#define LVL_ARRAY_INDEX_H
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+
+/*!
+ * \brief array_id -> position map for one of LevelData item arrays
+ *
+ * Map is verified on every lookup and rebuilt once when array was changed
+ * from outside (push_back, sorting, removal), so the caller never gets a wrong index.
+ * Removals can be collected by markRemoved() and applied in one pass by compact().
+ */
+template<class T>
+class LvlArrayIndex
+{
+public:
+    LvlArrayIndex() : dirty(true) {}
+
+    //! Returns position of item with array_id or -1 if not found. hint - last known position
+    int find(const QVector<T> &array, unsigned int array_id, int hint=-1)
+    {
+        if((hint >= 0) && (hint < array.size()) && (array[hint].array_id == array_id))
+            return hint;
+
+        if(!dirty)
+        {
+            typename QHash<unsigned int, int>::const_iterator it = map.constFind(array_id);
+            if((it != map.constEnd()) && (it.value() < array.size()) && (array[it.value()].array_id == array_id))
+                return it.value();
+        }
+
+        rebuild(array);
+        return map.value(array_id, -1);
+    }
+
+    //! Removes one item immediately
+    void remove(QVector<T> &array, unsigned int array_id, int hint=-1)
+    {
+        int i = find(array, array_id, hint);
+        if(i < 0) return;
+        array.remove(i);
+        dirty = true;
+    }
+
+    //! Marks item to be removed by next compact() call
+    void markRemoved(unsigned int array_id)
+    {
+        removed.insert(array_id);
+    }
+
+    //! Removes all marked items in one pass, order of other items is kept
+    void compact(QVector<T> &array)
+    {
+        if(removed.isEmpty()) return;
+
+        int out = 0;
+        for(int i = 0; i < array.size(); i++)
+        {
+            if(removed.contains(array[i].array_id)) continue;
+            if(out != i) array[out] = array[i];
+            out++;
+        }
+        array.resize(out);
+        removed.clear();
+        dirty = true;
+    }
+
+    void invalidate()
+    {
+        dirty = true;
+    }
+
+private:
+    void rebuild(const QVector<T> &array)
+    {
+        map.clear();
+        map.reserve(array.size());
+        for(int i = 0; i < array.size(); i++)
+            map.insert(array[i].array_id, i);
+        dirty = false;
+    }
+
+    bool dirty;
+    QHash<unsigned int, int> map;
+    QSet<unsigned int> removed;
+};
+
+#endif // LVL_ARRAY_INDEX_H
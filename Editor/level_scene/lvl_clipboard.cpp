@@ -35,6 +35,7 @@ LevelData LvlScene::copy(bool cut)
 
     if (!selectedList.isEmpty())
     {
+        if(cut) beginArrayRemoval();
         for (QList<QGraphicsItem*>::iterator it = selectedList.begin(); it != selectedList.end(); it++)
         {
             QString ObjType = (*it)->data(0).toString();
@@ -83,6 +84,7 @@ LevelData LvlScene::copy(bool cut)
 
         if(cut)
         {
+            endArrayRemoval();
             LvlData->modified = true;
             addRemoveHistory(copyData);
             Debugger_updateItemList();
@@ -157,6 +157,7 @@ QGraphicsItem * LvlScene::itemCollidesWith(QGraphicsItem * item, QList<QGraphics
     if(itemgrp && !itemgrp->isEmpty())
         collisions = *itemgrp;
     else
+    if(!collisionCandidates(item, collisions))
         collisions = this->items(
                 QRectF(item->scenePos().x()-10, item->scenePos().y()-10,
                 item->data(9).toReal()+20, item->data(10).toReal()+20 ),
@@ -304,6 +305,69 @@ QGraphicsItem * LvlScene::itemCollidesWith(QGraphicsItem * item, QList<QGraphics
     return NULL;
 }
 
+///
+/// \brief updateGridItem
+/// Keeps position of item in the grid same as in the scene
+void LvlScene::updateGridItem(LvlItemGrid &grid, QGraphicsItem *item)
+{
+    if(bulkInsertionDepth>0)
+        return; //Grids will be rebuilt by endBulkInsertion()
+
+    // Sizable blocks are never colliding
+    if((item->scene()!=this)||(item->data(3).toString()=="sizable"))
+    {
+        grid.remove(item);
+        return;
+    }
+
+    grid.insert(item, QRectF(item->scenePos(),
+                             QSizeF(item->data(9).toReal(), item->data(10).toReal())));
+}
+
+void LvlScene::rebuildItemGrids()
+{
+    blocksGrid.clear();
+    bgoGrid.clear();
+    npcGrid.clear();
+
+    foreach(QGraphicsItem * it, items())
+    {
+        QString ObjType = it->data(0).toString();
+        if(ObjType=="Block")
+            updateGridItem(blocksGrid, it);
+        else
+        if(ObjType=="BGO")
+            updateGridItem(bgoGrid, it);
+        else
+        if(ObjType=="NPC")
+            updateGridItem(npcGrid, it);
+    }
+}
+
+///
+/// \brief collisionCandidates
+/// Collects items from grids which may collide with the item.
+/// Returns false if item type has no grid
+bool LvlScene::collisionCandidates(QGraphicsItem *item, QList<QGraphicsItem *> &found)
+{
+    QRectF zone(item->scenePos().x()-10, item->scenePos().y()-10,
+                item->data(9).toReal()+20, item->data(10).toReal()+20 );
+
+    QString ObjType = item->data(0).toString();
+    if((ObjType=="Block")||(ObjType=="NPC"))
+    {
+        blocksGrid.query(zone, found);
+        npcGrid.query(zone, found);
+    }
+    else
+    if(ObjType=="BGO")
+        bgoGrid.query(zone, found);
+    else
+        return false;
+
+    return true;
+}
+
 QGraphicsItem * LvlScene::itemCollidesCursor(QGraphicsItem * item)
 {
     QList<QGraphicsItem *> collisions = collidingItems(item, Qt::IntersectsItemBoundingRect);
@@ -1076,6 +1076,7 @@ void LvlScene::placeItemUnderCursor()
     if(LvlPlacingItems::overwriteMode)
     {   //remove all colliaded items before placing
         QGraphicsItem * xxx;
+        beginArrayRemoval();
         while( (xxx=itemCollidesWith(cursor)) != NULL )
         {
             if(xxx->data(0).toString()=="Block")
@@ -1102,6 +1103,7 @@ void LvlScene::placeItemUnderCursor()
                 delete xxx;
             }
         }
+        endArrayRemoval();
     }
 
     QList<QGraphicsItem *> * checkZone;
@@ -1287,12 +1289,30 @@ void LvlScene::removeLvlItem(QGraphicsItem * item, bool globalHistory)
     removeLvlItems(items, globalHistory);
 }
 
+void LvlScene::beginArrayRemoval()
+{
+    arrayRemovalDepth++;
+}
+
+void LvlScene::endArrayRemoval()
+{
+    if(arrayRemovalDepth<=0) return;
+    arrayRemovalDepth--;
+    if(arrayRemovalDepth>0) return;
+
+    //Remove all marked items with a single pass over each array
+    blocks_byArrayId.compact(LvlData->blocks);
+    bgo_byArrayId.compact(LvlData->bgo);
+    npc_byArrayId.compact(LvlData->npc);
+}
+
 void LvlScene::removeLvlItems(QList<QGraphicsItem * > items, bool globalHistory)
 {
     LevelData historyBuffer;
     bool deleted=false;
     QString objType;
 
+    beginArrayRemoval();
     for (QList<QGraphicsItem*>::iterator it = items.begin(); it != items.end(); it++)
     {
             objType=(*it)->data(0).toString();
@@ -1368,6 +1388,7 @@ void LvlScene::removeLvlItems(QList<QGraphicsItem * > items, bool globalHistory)
                  deleted=true;
             }
     }
+    endArrayRemoval();
 
     if(deleted)
     {
@@ -19,6 +19,18 @@
 #include "lvl_scene.h"
 #include "../edit_level/level_edit.h"
 
+#include <QApplication>
+
+//Cancel button works through event processing only, so it's checked once per this count of items
+static const int bulkCancelCheckStep = 1024;
+
+static bool bulkCanceled(QProgressDialog &progress, int i)
+{
+    if((i % bulkCancelCheckStep) != (bulkCancelCheckStep-1))
+        return false;
+    qApp->processEvents();
+    return progress.wasCanceled();
+}
 
 // //////////////////////////Apply used sections///////////////////////////////////////
 void LvlScene::makeSectionBG(QProgressDialog &progress)
@@ -42,6 +54,23 @@ void LvlScene::makeSectionBG(QProgressDialog &progress)
 }
 
 
+// ///////////////////Bulk insertion/////////////////////////////////////////////
+void LvlScene::beginBulkInsertion()
+{
+    //Item grids are not updated on each added item, they will be built once by endBulkInsertion()
+    bulkInsertionDepth++;
+}
+
+void LvlScene::endBulkInsertion()
+{
+    if(bulkInsertionDepth<=0) return;
+    bulkInsertionDepth--;
+    if(bulkInsertionDepth>0) return;
+
+    rebuildItemGrids();
+}
+
+
 // ///////////////////SET Block Objects/////////////////////////////////////////////
 void LvlScene::setBlocks(QProgressDialog &progress)
 {
@@ -53,9 +82,8 @@ void LvlScene::setBlocks(QProgressDialog &progress)
         //Add block to scene
         placeBlock(LvlData->blocks[i]);
 
-        if(progress.wasCanceled())
-            //progress.setValue(progress.value()+1);
-        /*else*/ return;
+        if(bulkCanceled(progress, i))
+            return;
     }
 }
 
@@ -73,9 +101,8 @@ void LvlScene::setBGO(QProgressDialog &progress)
         //add BGO to scene
         placeBGO(LvlData->bgo[i]);
 
-        if(progress.wasCanceled())
-            //progress.setValue(progress.value()+1);
-        /*else*/ return;
+        if(bulkCanceled(progress, i))
+            return;
     }
 
 }
@@ -92,9 +119,8 @@ void LvlScene::setNPC(QProgressDialog &progress)
         //add NPC to scene
         placeNPC(LvlData->npc[i]);
 
-        if(progress.wasCanceled())
-            //progress.setValue(progress.value()+1);
-        /*else*/ return;
+        if(bulkCanceled(progress, i))
+            return;
     }
 
 }
@@ -109,9 +135,8 @@ void LvlScene::setWaters(QProgressDialog &progress)
         //add Water to scene
         placeWater(LvlData->physez[i]);
 
-        if(progress.wasCanceled())
-            //progress.setValue(progress.value()+1);
-        /*else*/ return;
+        if(bulkCanceled(progress, i))
+            return;
     }
 
 }
@@ -128,9 +153,8 @@ void LvlScene::setDoors(QProgressDialog &progress)
         //add Doors points to scene
         placeDoor(LvlData->doors[i]);
 
-        if(progress.wasCanceled())
-            //progress.setValue(progress.value()+1);
-        /*else*/ return;
+        if(bulkCanceled(progress, i))
+            return;
     }
 }
 
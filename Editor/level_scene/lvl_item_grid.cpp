@@ -0,0 +1,127 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lvl_item_grid.h"
+
+#include <QSet>
+#include <math.h>
+
+LvlItemGrid::LvlItemGrid(int cellSize)
+{
+    this->cellSize = (cellSize>0) ? cellSize : 64;
+}
+
+void LvlItemGrid::insert(QGraphicsItem *item, const QRectF &rect)
+{
+    if(!item) return;
+    QRect newCells = cellsOf(rect);
+
+    QHash<QGraphicsItem *, QRect>::iterator it = itemCells.find(item);
+    if(it != itemCells.end())
+    {
+        if(it.value() == newCells) return; //Still in same cells
+        remove(item);
+    }
+
+    for(int y=newCells.top(); y<=newCells.bottom(); y++)
+        for(int x=newCells.left(); x<=newCells.right(); x++)
+            cells[cellKey(x, y)].push_back(item);
+    itemCells.insert(item, newCells);
+}
+
+void LvlItemGrid::remove(QGraphicsItem *item)
+{
+    QHash<QGraphicsItem *, QRect>::iterator it = itemCells.find(item);
+    if(it == itemCells.end()) return;
+
+    QRect oldCells = it.value();
+    itemCells.erase(it);
+
+    for(int y=oldCells.top(); y<=oldCells.bottom(); y++)
+        for(int x=oldCells.left(); x<=oldCells.right(); x++)
+        {
+            QHash<quint64, QVector<QGraphicsItem *> >::iterator c = cells.find(cellKey(x, y));
+            if(c == cells.end()) continue;
+            QVector<QGraphicsItem *> &cell = c.value();
+            for(int i=0; i<cell.size(); i++)
+            {
+                if(cell[i]!=item) continue;
+                //Order of items in cell doesn't matter
+                cell[i] = cell.last();
+                cell.pop_back();
+                break;
+            }
+            if(cell.isEmpty()) cells.erase(c);
+        }
+}
+
+bool LvlItemGrid::contains(QGraphicsItem *item) const
+{
+    return itemCells.contains(item);
+}
+
+void LvlItemGrid::query(const QRectF &rect, QList<QGraphicsItem *> &found) const
+{
+    QRect area = cellsOf(rect);
+    bool single = (area.width()==1) && (area.height()==1);
+    QSet<QGraphicsItem *> seen;
+
+    for(int y=area.top(); y<=area.bottom(); y++)
+        for(int x=area.left(); x<=area.right(); x++)
+        {
+            QHash<quint64, QVector<QGraphicsItem *> >::const_iterator c = cells.constFind(cellKey(x, y));
+            if(c == cells.constEnd()) continue;
+            const QVector<QGraphicsItem *> &cell = c.value();
+            for(int i=0; i<cell.size(); i++)
+            {
+                //Items which are covering several cells must be returned once
+                if(!single)
+                {
+                    if(seen.contains(cell[i])) continue;
+                    seen.insert(cell[i]);
+                }
+                found.push_back(cell[i]);
+            }
+        }
+}
+
+void LvlItemGrid::clear()
+{
+    cells.clear();
+    itemCells.clear();
+}
+
+int LvlItemGrid::size() const
+{
+    return itemCells.size();
+}
+
+QRect LvlItemGrid::cellsOf(const QRectF &rect) const
+{
+    int l = (int)floor(rect.left()/cellSize);
+    int t = (int)floor(rect.top()/cellSize);
+    //Right and bottom edges are not a part of item
+    int r = (int)floor(qMax(rect.left(), rect.right()-1.0)/cellSize);
+    int b = (int)floor(qMax(rect.top(), rect.bottom()-1.0)/cellSize);
+    return QRect(QPoint(l, t), QPoint(r, b));
+}
+
+quint64 LvlItemGrid::cellKey(int x, int y)
+{
+    return (quint64(quint32(x)) << 32) | quint64(quint32(y));
+}
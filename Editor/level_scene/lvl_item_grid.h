@@ -0,0 +1,60 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LVL_ITEM_GRID_H
+#define LVL_ITEM_GRID_H
+
+#include <QHash>
+#include <QVector>
+#include <QRect>
+#include <QRectF>
+#include <QList>
+
+class QGraphicsItem;
+
+/*!
+ * \brief Uniform grid occupancy index of scene items
+ *
+ * Every item is registered in all cells covered by its rectangle.
+ * Lookup of items near the rectangle touches only the covered cells
+ * and doesn't depend on the total number of items in the scene.
+ */
+class LvlItemGrid
+{
+public:
+    LvlItemGrid(int cellSize=64);
+
+    //! Adds item or moves it into the new place
+    void insert(QGraphicsItem *item, const QRectF &rect);
+    void remove(QGraphicsItem *item);
+    bool contains(QGraphicsItem *item) const;
+    //! Appends items registered in cells covered by rect (every item once)
+    void query(const QRectF &rect, QList<QGraphicsItem *> &found) const;
+    void clear();
+    int size() const;
+
+private:
+    QRect cellsOf(const QRectF &rect) const;
+    static quint64 cellKey(int x, int y);
+
+    int cellSize;
+    QHash<quint64, QVector<QGraphicsItem *> > cells;
+    QHash<QGraphicsItem *, QRect> itemCells;
+};
+
+#endif // LVL_ITEM_GRID_H
@@ -395,7 +395,6 @@ void LvlScene::placeBlock(LevelBlock &block, bool toGrid)
     BlockImage->setBlockData(block, pConfigs->main_block[item_i].sizable);
     BlockImage->gridSize = pConfigs->main_block[item_i].grid;
     //BlockImage->setMainPixmap(tImg);
-    addItem(BlockImage);
 
     //Set pointers
     BlockImage->setScenePoint(this);
@@ -430,13 +429,6 @@ void LvlScene::placeBlock(LevelBlock &block, bool toGrid)
 
     BlockImage->setPos(QPointF(newPos));
 
-    //////////////////////////////Included NPC////////////////////////////////////////
-    if(block.npc_id != 0)
-    {
-        BlockImage->setIncludedNPC(block.npc_id, true);
-    }
-    //////////////////////////////////////////////////////////////////////////////////
-
     if(pConfigs->main_block[j].sizable)
     {
         BlockImage->setMainPixmap();
@@ -468,6 +460,17 @@ void LvlScene::placeBlock(LevelBlock &block, bool toGrid)
 
     BlockImage->setData(9, QString::number(block.w) ); //width
     BlockImage->setData(10, QString::number(block.h) ); //height
+
+    //Item is completely built, add it to scene with a single notification
+    addItem(BlockImage);
+
+    //////////////////////////////Included NPC////////////////////////////////////////
+    if(block.npc_id != 0)
+    {
+        BlockImage->setIncludedNPC(block.npc_id, true);
+    }
+    //////////////////////////////////////////////////////////////////////////////////
+
     if(PasteFromBuffer) BlockImage->setSelected(true);
 }
 
@@ -538,7 +541,6 @@ void LvlScene::placeBGO(LevelBGO &bgo, bool toGrid)
     BGOItem->setAnimator(animator);
     //BGOItem->setMainPixmap(tImg);
     BGOItem->setContextMenu(bgoMenu);
-    addItem(BGOItem);
 
 
     #ifdef _DEBUG_
@@ -573,6 +575,8 @@ void LvlScene::placeBGO(LevelBGO &bgo, bool toGrid)
     BGOItem->zOffset = pConfigs->main_bgo[j].zOffset;
     BGOItem->setZMode(bgo.z_mode, bgo.z_offset, true);
 
+    addItem(BGOItem);
+
     if(PasteFromBuffer) BGOItem->setSelected(true);
 }
 
@@ -695,12 +699,6 @@ void LvlScene::placeNPC(LevelNPC &npc, bool toGrid)
         //WriteToLog(QtDebugMsg, "NPC place -> set ContextMenu");
     NPCItem->setContextMenu(npcMenu);
 
-    #ifdef _DEBUG_
-        WriteToLog(QtDebugMsg, "NPC place -> Add to scene");
-    #endif
-
-    addItem(NPCItem);
-
     if(NPCItem->localProps.foreground)
         NPCItem->setZValue(Z_npcFore);
     else
@@ -709,6 +707,17 @@ void LvlScene::placeNPC(LevelNPC &npc, bool toGrid)
     else
         NPCItem->setZValue(Z_npcStd);
 
+    //Generator arrow and included NPC are scene items, so NPC must be in scene before them.
+    //Otherwise item is built completely and added to scene at end
+    bool addedToScene = (npc.generator || ((mergedSet.container)&&(npc.special_data>0)));
+    if(addedToScene)
+    {
+        #ifdef _DEBUG_
+            WriteToLog(QtDebugMsg, "NPC place -> Add to scene");
+        #endif
+        addItem(NPCItem);
+    }
+
     #ifdef _DEBUG_
         WriteToLog(QtDebugMsg, "NPC place -> set Generator");
     #endif
@@ -779,6 +788,16 @@ void LvlScene::placeNPC(LevelNPC &npc, bool toGrid)
     NPCItem->setData(9, QString::number(NPCItem->localProps.width) ); //width
     NPCItem->setData(10, QString::number(NPCItem->localProps.height) ); //height
 
+    if(!addedToScene)
+    {
+        #ifdef _DEBUG_
+            WriteToLog(QtDebugMsg, "NPC place -> Add to scene");
+        #endif
+        addItem(NPCItem);
+    }
+    else
+        updateGridItem(npcGrid, NPCItem); //Size is known now
+
     if(PasteFromBuffer) NPCItem->setSelected(true);
     #ifdef _DEBUG_
         WriteToLog(QtDebugMsg, "NPC place -> done");
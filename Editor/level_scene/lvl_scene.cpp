@@ -35,6 +35,8 @@
 #include "edit_modes/mode_fill.h"
 
 #include "../common_features/themes.h"
+#include "../file_formats/lvl_sort.h"
+#include "../networking/engine_intproc.h"
 
 LvlScene::LvlScene(GraphicsWorkspace * parentView, dataconfigs &configs, LevelData &FileData, QObject *parent) : QGraphicsScene(parent)
 {
@@ -157,8 +159,13 @@ LvlScene::LvlScene(GraphicsWorkspace * parentView, dataconfigs &configs, LevelDa
     Z_sys_interspace1 = 1000; // interSection space layer
     Z_sys_sctBorder = 1020; // section Border
 
+    arrayRemovalDepth=0;
+    bulkInsertionDepth=0;
+
     //HistoryIndex
     historyIndex=0;
+    historyCompressTimer.setSingleShot(true);
+    connect(&historyCompressTimer, SIGNAL(timeout()), this, SLOT(historyCompressStep()));
 
     historyChanged = false;
 
@@ -204,6 +211,10 @@ LvlScene::LvlScene(GraphicsWorkspace * parentView, dataconfigs &configs, LevelDa
 LvlScene::~LvlScene()
 {
     if(messageBox) delete messageBox;
+    if(IntEngine::engineSocket && IntEngine::engineSocket->isLiveSource(LvlData))
+        IntEngine::engineSocket->setLiveSource(NULL);
+    //Delete items while item grids are alive, items are unregistering themselves on destruction
+    clear();
     uBGs.clear();
     uBGOs.clear();
     uBlocks.clear();
@@ -224,87 +235,16 @@ LvlScene::~LvlScene()
 
 void LvlScene::sortBlockArray(QVector<LevelBlock > &blocks)
 {
-    LevelBlock tmp1;
-    int total = blocks.size();
-    long i;
-    unsigned long ymin;
-    long ymini;
-    long sorted = 0;
-
-
-        while(sorted < blocks.size())
-        {
-            ymin = blocks[sorted].array_id;
-            ymini = sorted;
-
-            for(i = sorted; i < total; i++)
-            {
-                if( blocks[i].array_id < ymin )
-                {
-                    ymin = blocks[i].array_id; ymini = i;
-                }
-            }
-            tmp1 = blocks[ymini];
-            blocks[ymini] = blocks[sorted];
-            blocks[sorted] = tmp1;
-            sorted++;
-        }
+    LvlSort::applyOrder(blocks, LvlSort::blocksByArrayID(blocks));
 }
 
 void LvlScene::sortBlockArrayByPos(QVector<LevelBlock > &blocks)
 {
-    LevelBlock tmp1;
-    int total = blocks.size();
-    long i;
-    long xmin;
-    long xmini;
-    long sorted = 0;
-
-
-        while(sorted < blocks.size())
-        {
-            xmin = blocks[sorted].x;
-            xmini = sorted;
-
-            for(i = sorted; i < total; i++)
-            {
-                if( blocks[i].x < xmin )
-                {
-                    xmin = blocks[i].x; xmini = i;
-                }
-            }
-            tmp1 = blocks[xmini];
-            blocks[xmini] = blocks[sorted];
-            blocks[sorted] = tmp1;
-            sorted++;
-        }
+    LvlSort::applyOrder(blocks, LvlSort::blocksByPos(blocks));
 }
 
 void LvlScene::sortBGOArray(QVector<LevelBGO > &bgos)
 {
-    LevelBGO tmp1;
-    int total = bgos.size();
-    long i;
-    unsigned long ymin;
-    unsigned long ymini;
-    long sorted = 0;
-
-        while(sorted < bgos.size())
-        {
-            ymin = bgos[sorted].array_id;
-            ymini = sorted;
-
-            for(i = sorted; i < total; i++)
-            {
-                if( bgos[i].array_id < ymin )
-                {
-                    ymin = bgos[i].array_id; ymini = i;
-                }
-            }
-            tmp1 = bgos[ymini];
-            bgos[ymini] = bgos[sorted];
-            bgos[sorted] = tmp1;
-            sorted++;
-        }
+    LvlSort::applyOrder(bgos, LvlSort::bgoByArrayID(bgos));
 }
 
@@ -53,6 +53,9 @@
 
 #include "../common_features/edit_mode_base.h"
 
+#include "lvl_array_index.h"
+#include "lvl_item_grid.h"
+
 class LvlScene : public QGraphicsScene
 {
     Q_OBJECT
@@ -148,6 +151,14 @@ public:
 
     bool checkGroupCollisions(QList<QGraphicsItem *> *items);
     QGraphicsItem * itemCollidesWith(QGraphicsItem * item, QList<QGraphicsItem *> *itemgrp = 0);
+
+    //Uniform grids of blocks, BGO and NPC, used by collision checks of placing tools
+    LvlItemGrid blocksGrid;
+    LvlItemGrid bgoGrid;
+    LvlItemGrid npcGrid;
+    void updateGridItem(LvlItemGrid &grid, QGraphicsItem *item);
+    void rebuildItemGrids();
+    bool collisionCandidates(QGraphicsItem *item, QList<QGraphicsItem *> &found);
     QGraphicsItem * itemCollidesCursor(QGraphicsItem * item);
     // //////////////////////////////////
 
@@ -204,6 +215,11 @@ public:
     void setNPC(QProgressDialog &progress);
     void setWaters(QProgressDialog &progress);
     void setDoors(QProgressDialog &progress);
+
+    //Bulk population: items are built before adding to scene, item grids are built once by endBulkInsertion()
+    int bulkInsertionDepth;
+    void beginBulkInsertion();
+    void endBulkInsertion();
     void setPlayerPoints();
 
     void doorPointsSync(long arrayID, bool remove=false);
@@ -252,6 +268,15 @@ public:
     QVector<bgoIndexes > index_bgo;
     QVector<npcIndexes > index_npc;
 
+    //Positions of items in the LvlData arrays by array_id
+    LvlArrayIndex<LevelBlock > blocks_byArrayId;
+    LvlArrayIndex<LevelBGO > bgo_byArrayId;
+    LvlArrayIndex<LevelNPC > npc_byArrayId;
+    //While active, removeFromArray() only marks items; arrays are compacted by endArrayRemoval()
+    int arrayRemovalDepth;
+    void beginArrayRemoval();
+    void endArrayRemoval();
+
     bool lock_bgo;
     bool lock_block;
     bool lock_npc;
@@ -328,6 +353,8 @@ public:
             LEVELHISTORY_RESIZEWATER,
             LEVELHISTORY_OVERWRITE
         };
+        HistoryOperation() : type(LEVELHISTORY_REMOVE), subtype(0), x(0), y(0),
+            packed(false), memSize(-1) {}
         HistoryType type;
         //used most of Operations
         LevelData data;
@@ -338,6 +365,12 @@ public:
         long x, y;
         //misc
         QVariant extraData;
+        //compressed copies of data and data_mod (made by history compressor)
+        bool packed;
+        QByteArray packedData;
+        QByteArray packedDataMod;
+        //approximated size of operation in memory (-1 - not calculated yet)
+        qint64 memSize;
     };
     struct CallbackData{
         QGraphicsItem* item;
@@ -473,6 +506,17 @@ public:
     int getHistroyIndex();
     bool canUndo();
     bool canRedo();
+    //history memory control
+    void historyApplyLimits();
+    qint64 historyMemoryUsage();
+    int historyPackedCount();
+    void historyCompressAll();
+    LevelData historyCompactMoveData(LevelData &data);
+    qint64 historyOperationSize(HistoryOperation &operation);
+    void historyPackOperation(HistoryOperation &operation);
+    void historyUnpackOperation(HistoryOperation &operation);
+    //live testing: sends changed blocks and BGO to running engine
+    void historySyncToEngine(const HistoryOperation &operation);
     //Callbackfunctions: Move
     void historyRedoMoveBlocks(CallbackData cbData, LevelBlock data);
     void historyRedoMoveBGO(CallbackData cbData, LevelBGO data);
@@ -625,6 +669,9 @@ public:
 public slots:
     void selectionChanged();
 
+private slots:
+    void historyCompressStep();
+
 signals:
     void screenshotSizeCaptured();
 
@@ -658,6 +705,7 @@ private:
     // ////////////////HistoryManager///////////////////
     int historyIndex;
     QList<HistoryOperation> operationList;
+    QTimer historyCompressTimer;
     // /////////////////////////////////////////////////
 
 };
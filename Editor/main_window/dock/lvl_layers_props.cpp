@@ -219,6 +219,7 @@ void MainWindow::RemoveLayerItems(QString layerName)
 {
     QList<QGraphicsItem*> ItemList = activeLvlEditWin()->scene->items();
     LevelData delData;
+    activeLvlEditWin()->scene->beginArrayRemoval();
     for (QList<QGraphicsItem*>::iterator it = ItemList.begin(); it != ItemList.end(); it++)
     {
         if((*it)->data(25).toString()=="CURSOR") continue; //skip cursor item
@@ -291,6 +292,7 @@ void MainWindow::RemoveLayerItems(QString layerName)
             }
         }
     }
+    activeLvlEditWin()->scene->endArrayRemoval();
     foreach (LevelLayers l, activeLvlEditWin()->LvlData.layers) {
         if(l.name == layerName){
             delData.layers.push_back(l);
@@ -973,6 +975,7 @@ void MainWindow::on_LvlLayerList_customContextMenuRequested(const QPoint &pos)
         //Apply layer's name/visibly to all items
         QList<QGraphicsItem*> ItemList = activeLvlEditWin()->scene->items();
 
+        activeLvlEditWin()->scene->beginArrayRemoval();
         for (QList<QGraphicsItem*>::iterator it = ItemList.begin(); it != ItemList.end(); it++)
         {
             if((*it)->data(0).toString()=="Block")
@@ -1039,6 +1042,7 @@ void MainWindow::on_LvlLayerList_customContextMenuRequested(const QPoint &pos)
                 //(*it)->setVisible(layerVisible);
             }
         }
+        activeLvlEditWin()->scene->endArrayRemoval();
         activeLvlEditWin()->LvlData.modified=true;
 
 
@@ -20,6 +20,7 @@
 
 QString GlobalSettings::locale="";
 long GlobalSettings::animatorItemsLimit=25000;
+long GlobalSettings::historyMemoryLimit=0;
 QString GlobalSettings::openPath=".";
 QString GlobalSettings::savePath=".";
 QString GlobalSettings::savePath_npctxt=".";
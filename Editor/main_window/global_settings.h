@@ -39,6 +39,7 @@ public:
 
     static QString locale; //Current language
     static long animatorItemsLimit; //If level map have too many items, animation will be stopped
+    static long historyMemoryLimit; //Maximal size of level history in megabytes (0 - unlimited)
 
     //Paths
     static QString savePath;
@@ -500,6 +500,7 @@ void MainWindow::loadSettings()
         ui->bookmarkBox->restoreGeometry(settings.value("bookmarks-box-geometry", ui->bookmarkBox->saveGeometry()).toByteArray());
 
         GlobalSettings::animatorItemsLimit = settings.value("animation-item-limit", "25000").toInt();
+        GlobalSettings::historyMemoryLimit = settings.value("history-memory-limit", "0").toInt();
 
     settings.endGroup();
 
@@ -589,6 +590,7 @@ void MainWindow::saveSettings()
     settings.setValue("animation", GlobalSettings::LvlOpts.animationEnabled);
     settings.setValue("collisions", GlobalSettings::LvlOpts.collisionsEnabled);
     settings.setValue("animation-item-limit", QString::number(GlobalSettings::animatorItemsLimit));
+    settings.setValue("history-memory-limit", QString::number(GlobalSettings::historyMemoryLimit));
 
     settings.setValue("language", GlobalSettings::locale);
 
@@ -1,6 +1,9 @@
 #include "engine_client.h"
 
 #include <QElapsedTimer>
+#include <QTimer>
+#include <QMutexLocker>
+#include <QSharedMemory>
 #include "../common_features/app_path.h"
 #include <QApplication>
 
@@ -13,13 +16,16 @@
 
 EngineClient::EngineClient()
 {
-    engine = new QLocalSocket();
-
-    connect(engine, SIGNAL(error(QLocalSocket::LocalSocketError)),
-            this, SLOT(displayError(QLocalSocket::LocalSocketError)));
+    engine = NULL;
 
-    readyToSendLvlx = false;
     _connected = true;
+    socketOpen = false;
+    connectionLost = false;
+    lastSeq = 0;
+    lastAckSeq = 0;
+    lastAckSuccess = false;
+    pingSent = false;
+    liveSource = NULL;
 }
 
 /**
@@ -28,86 +34,230 @@ EngineClient::EngineClient()
  */
 EngineClient::~EngineClient()
 {
-  engine->close();
-  delete engine;
+    exit();
+    wait();
 }
 
 void EngineClient::sendLevelData(LevelData _data)
 {
     if(!_data.ReadFileValid) return;
 
-    if(!engine->isOpen())
-        OpenConnection();
+    if(_data.path.isEmpty())
+    {
+        _data.path = ApplicationPath;
+        _data.filename = "_untitled";
+    }
 
+    QElapsedTimer time;
+    time.start();
 
-    QString sendLvlx;
-    if(!_data.path.isEmpty())
-        sendLvlx = QString("SEND_LVLX: %1/%2").arg(_data.path).arg(_data.filename);
-    else
-        sendLvlx = QString("SEND_LVLX: %1/%2").arg(ApplicationPath).arg("_untitled.lvlx");
+    qDebug() << "Sending data to engine...";
+    QByteArray raw = FileFormats::WriteLvlRawData(_data);
 
-    qDebug() << sendLvlx;
-    sendCommand(sendLvlx);
-    qApp->processEvents();
+    bool accepted=false;
+    bool sent=false;
 
-    if(engine->waitForReadyRead(1000))
+    //Big level is written into shared memory once and engine reads it from there,
+    //only key and size are going through the socket
+    if(raw.size() >= IntProcProto::shmThreshold)
     {
-        QByteArray data = engine->readAll();
-        QString acceptedData = QString::fromUtf8(data);
+        quint32 nextSeq;
+        ioLock.lock();
+        nextSeq = lastSeq+1;
+        ioLock.unlock();
 
-        if(!acceptedData.isEmpty())
+        QSharedMemory shm(QString("PGEEditorLevel_%1_%2").arg(QApplication::applicationPid()).arg(nextSeq));
+        if(shm.create(raw.size()))
         {
-            QStringList StrData = acceptedData.split("\n\n");
-            foreach(QString x, StrData)
+            shm.lock();
+            memcpy(shm.data(), raw.constData(), size_t(raw.size()));
+            shm.unlock();
+
+            quint32 seq = sendMessage(IntProcProto::MSG_LEVEL_DATA_SHM, IntProcProto::packShmHandle(shm.key(), quint32(raw.size())));
+            if(!waitForAck(seq, 10000, accepted))
             {
-                if(x=="READY")
-                {
-                    qDebug() << "Engine is ready to accept data";
-                    readyToSendLvlx = true;
-                }
+                qDebug() << "Time out: Engine is not answer, abort operation";
+                IntEngine::quit();
+                return;
             }
+            sent = accepted;
+            if(!sent)
+                qDebug() << "Engine can't read level from shared memory, sending through the socket";
         }
+        else
+            qDebug() << "Shared memory is unavailable:" << shm.errorString();
+        //Shared memory segment is destroyed here, engine already has the copy
     }
 
-    //Pause
-    QElapsedTimer time;
-    time.start();
-    while(!readyToSendLvlx)
+    if(!sent)
     {
-        if(time.elapsed()>5000)
+        quint32 seq = sendMessage(IntProcProto::MSG_LEVEL_DATA, raw);
+        if(!waitForAck(seq, 10000, accepted))
         {
             qDebug() << "Time out: Engine is not answer, abort operation";
             IntEngine::quit();
             return;
         }
     }
-    readyToSendLvlx=false;
 
-    QString rawData = FileFormats::WriteExtendedLvlFile(_data);
-    rawData.append("\n");
+    if(accepted)
+        qDebug() << "Level data accepted by engine in" << time.elapsed() << "ms, testing is started";
+    else
+        qDebug() << "Engine can't accept level data";
+}
 
-    qDebug() << "Sending data to engine...";
-    sendCommand(rawData);
-    sendCommand("PARSE_LVLX\n\n");
-    qDebug() << "Sent, testing is started";
+void EngineClient::sendCommand(QString command)
+{
+    sendMessage(IntProcProto::MSG_COMMAND, command.toUtf8());
+}
+
+/**
+ * @brief EngineClient::sendLevelDelta
+ *  Sends changes of the tested level. Doesn't wait for acknowledge to keep editor responsive,
+ *  answers are read by client thread.
+ */
+void EngineClient::sendLevelDelta(const IntProcProto::LevelDelta &delta)
+{
+    if(delta.isEmpty()) return;
+
+    ioLock.lock();
+    bool open = socketOpen;
+    ioLock.unlock();
+    if(!open) return;
 
-    msleep(100);
+    sendMessage(IntProcProto::MSG_LEVEL_DELTA, IntProcProto::packLevelDelta(delta));
 }
 
-void EngineClient::sendCommand(QString command)
+void EngineClient::setLiveSource(const LevelData *level)
+{
+    liveSource = level;
+}
+
+bool EngineClient::isLiveSource(const LevelData *level)
+{
+    QMutexLocker lock(&ioLock);
+    return (liveSource!=NULL) && (liveSource==level) && socketOpen;
+}
+
+/**
+ * @brief EngineClient::sendMessage
+ *  Queues message, it will be written by client thread. Can be called from any thread.
+ *  @return sequence number of the message
+ */
+quint32 EngineClient::sendMessage(quint16 type, const QByteArray &payload)
+{
+    quint32 seq;
+    ioLock.lock();
+    seq = ++lastSeq;
+    outQueue.push_back(IntProcProto::pack(type, seq, payload));
+    ioLock.unlock();
+
+    emit messageQueued();
+    return seq;
+}
+
+/**
+ * @brief EngineClient::writeQueued
+ *  Writes all queued messages, connection is opened on first message. Client thread only.
+ */
+void EngineClient::writeQueued()
 {
-    if(!engine->isOpen())
-            OpenConnection();
+    if(engine->state()!=QLocalSocket::ConnectedState)
+    {
+        OpenConnection();
+        if(engine->state()!=QLocalSocket::ConnectedState)
+        {
+            closeConnection();
+            return;
+        }
+        ioLock.lock();
+        socketOpen = true;
+        ioLock.unlock();
+    }
+
+    QList<QByteArray> frames;
+    ioLock.lock();
+    frames.swap(outQueue);
+    ioLock.unlock();
 
-    QByteArray bytes;
-    bytes = command.toUtf8();
-    engine->write(bytes);
-    if(!engine->waitForBytesWritten(10000))
+    foreach(QByteArray frame, frames)
+        engine->write(frame);
+    if(!frames.isEmpty() && !engine->waitForBytesWritten(10000))
     {
         qDebug()<<"Error of command sending";
     }
 }
 
+/**
+ * @brief EngineClient::waitForAck
+ *  Waits until client thread will receive acknowledge of the message with seq
+ *  @return false on time out or lost connection
+ */
+bool EngineClient::waitForAck(quint32 seq, int timeout, bool &success)
+{
+    QElapsedTimer time;
+    time.start();
+    QMutexLocker lock(&ioLock);
+    while(lastAckSeq!=seq)
+    {
+        if(connectionLost) return false;
+        int left = timeout-int(time.elapsed());
+        if(left<=0) return false;
+        ackReceived.wait(&ioLock, ulong(left));
+    }
+    success = lastAckSuccess;
+    return true;
+}
+
+/**
+ * @brief EngineClient::readAvailable
+ *  Processes all completely received messages without waiting. Client thread only.
+ *  @return false on broken stream
+ */
+bool EngineClient::readAvailable()
+{
+    inBuffer.append(engine->readAll());
+
+    QList<IntProcProto::Message> messages;
+    if(!IntProcProto::unpack(inBuffer, messages))
+    {
+        qDebug() << "Broken message from engine, connection closed";
+        inBuffer.clear();
+        closeConnection();
+        return false;
+    }
+
+    foreach(IntProcProto::Message msg, messages)
+        processMessage(msg);
+    return true;
+}
+
+void EngineClient::processMessage(const IntProcProto::Message &msg)
+{
+    switch(msg.type)
+    {
+    case IntProcProto::MSG_PING:
+        engine->write(IntProcProto::pack(IntProcProto::MSG_PONG, msg.seq));
+        engine->flush();
+        break;
+    case IntProcProto::MSG_PONG:
+        qDebug() << "Accepted PONG";
+        pingSent = false;
+        break;
+    case IntProcProto::MSG_ACK:
+        ioLock.lock();
+        IntProcProto::readAck(msg, lastAckSeq, lastAckSuccess);
+        ackReceived.wakeAll();
+        ioLock.unlock();
+        break;
+    case IntProcProto::MSG_COMMAND:
+        emit dataReceived(QString::fromUtf8(msg.payload));
+        break;
+    default:
+        qDebug() << "Unknown message from engine:" << msg.type;
+    }
+}
+
 void EngineClient::OpenConnection()
 {
     qDebug()<<"Connect to Engine " << ENGINE_SERVER_NAME;
@@ -127,88 +277,92 @@ bool EngineClient::isConnected()
     return _connected;
 }
 
+/**
+ * @brief EngineClient::sendPing
+ *  Checks that engine is alive, it must answer before the next ping. Client thread only.
+ */
+void EngineClient::sendPing()
+{
+    if(engine->state()!=QLocalSocket::ConnectedState)
+        return;
+
+    if(pingSent)
+    {
+        qDebug() << "Mr. Ping Timeout is here! :D. Engine is not answer";
+        closeConnection();
+        return;
+    }
+
+    qDebug() << "Ping";
+    pingSent=true;
+    sendMessage(IntProcProto::MSG_PING);
+}
+
+/**
+ * @brief EngineClient::closeConnection
+ *  Closes socket and wakes threads which are waiting for acknowledge. Client thread only.
+ */
+void EngineClient::closeConnection()
+{
+    ioLock.lock();
+    bool wasLost = connectionLost;
+    ioLock.unlock();
+    if(wasLost) return;
+
+    engine->abort();
+    ioLock.lock();
+    socketOpen = false;
+    connectionLost = true;
+    outQueue.clear();
+    ackReceived.wakeAll();
+    ioLock.unlock();
+    exit();
+}
 
+/**
+ * @brief EngineClient::run
+ *  Owns the socket: writes queued messages, reads answers and pings engine
+ *  in the event loop of this thread until connection will be closed.
+ */
 void EngineClient::run()
 {
     _connected=true;
-    msleep(100);
+    engine = new QLocalSocket();
+
+    //Context objects are living in this thread, so calls from other threads are queued here
+    connect(engine, SIGNAL(error(QLocalSocket::LocalSocketError)),
+            this, SLOT(displayError(QLocalSocket::LocalSocketError)), Qt::DirectConnection);
+    connect(this, &EngineClient::messageQueued, engine, [this]() { writeQueued(); }, Qt::QueuedConnection);
+    connect(engine, &QLocalSocket::readyRead, engine, [this]() { readAvailable(); });
+    connect(engine, &QLocalSocket::disconnected, engine, [this]() { closeConnection(); });
+
+    QTimer pingPong;
+    connect(&pingPong, &QTimer::timeout, engine, [this]() { sendPing(); });
+    pingPong.start(5000);
+    pingSent=false;
+
+    //Messages which were queued before thread was started
+    ioLock.lock();
+    bool hasQueued = !outQueue.isEmpty();
+    ioLock.unlock();
+    if(hasQueued)
+        emit messageQueued();
+
     exec();
-    _connected=false;
-}
 
-void EngineClient::exec()
-{
-    QElapsedTimer pingPong;
-    pingPong.start();
-    bool pingSent=false;
-      while(engine->isOpen() && !this->isFinished())
-      {
-            if(engine->waitForReadyRead(1000))
-            {
-                QByteArray data = engine->readAll();
-                QString acceptedData = QString::fromUtf8(data);
-
-                if(!acceptedData.isEmpty())
-                {
-                    QStringList StrData = acceptedData.split("\n\n");
-
-                    qDebug()<< "EngineClient::exec() accepted: " << acceptedData;
-
-                    foreach(QString x, StrData)
-                    {
-                        qDebug()<<"Accepted from engine: " << x;
-
-                        if(x=="PING")
-                        {
-                            QString str = QString("PONG\n\n");
-                            QByteArray bytes;
-                            bytes = str.toUtf8();
-                            engine->write(bytes);
-                            engine->flush();
-                        }
-                        else
-                        if(x=="PONG")
-                        {
-                            qDebug() << "Accepted PONG";
-                            pingSent = false;
-                        }
-                        else
-                        if(x=="READY")
-                        {
-                            qDebug() << "Accepted READY";
-                            readyToSendLvlx = true;
-                        }
-                    }
-                }
-            }
-            else
-                engine->close();
+    pingPong.stop();
+    engine->abort();
+    delete engine;
+    engine = NULL;
 
-            if(pingPong.elapsed()>5000)
-            {
-                if(pingSent)
-                {
-                    qDebug() << "Mr. Ping Timeout is here! :D. Engine is not answer";
-                    engine->close();
-                    _connected=false;
-                    break;
-                }
-                else
-                {
-                    qDebug() << "Ping";
-                    pingPong.restart();
-                    QString str = QString("PING\n\n");
-                    QByteArray bytes;
-                    bytes = str.toUtf8();
-                    engine->write(bytes);
-                    engine->flush();
-                    pingSent=true;
-                }
-            }
-            qDebug() << "Tick";
-            msleep(100);
-      }
-      qDebug() << "Connection with engine was finished";
+    ioLock.lock();
+    socketOpen = false;
+    connectionLost = true;
+    ackReceived.wakeAll();
+    ioLock.unlock();
+
+    qDebug() << "Connection with engine was finished";
+    _connected=false;
 }
 
 
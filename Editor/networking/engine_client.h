@@ -5,8 +5,12 @@
 #include <QVector>
 #include <QLocalServer>
 #include <QLocalSocket>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QList>
 
 #include "../file_formats/file_formats.h"
+#include "intproc_proto.h"
 
 #define ENGINE_SERVER_NAME "PGEEngine42e3j"
 
@@ -19,27 +23,56 @@ public:
 
     void sendLevelData(LevelData _data);
     void sendCommand(QString command);
+    void sendLevelDelta(const IntProcProto::LevelDelta &delta);
+
+    // Level which was sent to engine, it's changes are sent as deltas while engine is running
+    void setLiveSource(const LevelData *level);
+    bool isLiveSource(const LevelData *level);
     void OpenConnection();
     bool isConnected();
 
 protected:
     void run();
-    void exec();
 
 signals:
     void dataReceived(QString data);
     void privateDataReceived(QString data);
     void showUp();
     void openFile(QString path);
+    //! Internal: outgoing frames were queued, they are written by client thread
+    void messageQueued();
 
 private slots:
     void slotOnData(QString data);
     void displayError(QLocalSocket::LocalSocketError socketError);
 
 private:
+    // Socket is used by client thread only. Other threads are queueing messages
+    // and waiting for acknowledges, shared state is guarded by ioLock.
+    quint32 sendMessage(quint16 type, const QByteArray &payload=QByteArray());
+    bool waitForAck(quint32 seq, int timeout, bool &success);
+    void writeQueued();
+    bool readAvailable();
+    void processMessage(const IntProcProto::Message &msg);
+    void sendPing();
+    void closeConnection();
+
     QLocalSocket* engine;
     bool _connected;
-    bool readyToSendLvlx;
+
+    QMutex ioLock;
+    QWaitCondition ackReceived;
+    QList<QByteArray> outQueue; // Packed messages which are waiting to be written
+    bool socketOpen;       // Connection with engine is established
+    bool connectionLost;   // Connection was closed or can't be opened
+
+    QByteArray inBuffer;   // Bytes of not completely received messages (client thread)
+    quint32 lastSeq;       // Sequence number of last sent message
+    quint32 lastAckSeq;    // Last acknowledged message
+    bool lastAckSuccess;
+    bool pingSent;         // (client thread)
+
+    const LevelData *liveSource;
 };
 
 #endif // ENGINE_CLIENT_H
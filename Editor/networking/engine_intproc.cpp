@@ -17,8 +17,9 @@ void IntEngine::init()
 
 void IntEngine::quit()
 {
-    if(isWorking())
+    if(engineSocket!=NULL)
     {
+        //Client thread is stopped and joined by destructor
         engineSocket->exit();
         delete engineSocket;
         engineSocket = NULL;
@@ -27,7 +28,8 @@ void IntEngine::quit()
 
 bool IntEngine::isWorking()
 {
+    //Client thread is alive while connection with engine is opened or going to be opened
     bool isRuns=false;
-    isRuns = (engineSocket!=NULL && !engineSocket->isConnected());
+    isRuns = (engineSocket!=NULL && !engineSocket->isFinished());
     return isRuns;
 }
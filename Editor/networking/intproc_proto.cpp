@@ -0,0 +1,137 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "intproc_proto.h"
+
+#include <QtEndian>
+#include <QDataStream>
+
+#include "../file_formats/file_formats.h"
+
+QByteArray IntProcProto::pack(quint16 type, quint32 seq, const QByteArray &payload)
+{
+    QByteArray frame;
+    frame.resize(headerSize);
+    uchar *h = reinterpret_cast<uchar*>(frame.data());
+    qToBigEndian<quint32>(magic, h);
+    qToBigEndian<quint16>(version, h+4);
+    qToBigEndian<quint16>(type, h+6);
+    qToBigEndian<quint32>(seq, h+8);
+    qToBigEndian<quint32>(quint32(payload.size()), h+12);
+    frame.append(payload);
+    return frame;
+}
+
+QByteArray IntProcProto::packAck(quint32 seq, bool success)
+{
+    QByteArray payload;
+    payload.resize(5);
+    qToBigEndian<quint32>(seq, reinterpret_cast<uchar*>(payload.data()));
+    payload[4] = char(success ? 1 : 0);
+    return pack(MSG_ACK, 0, payload);
+}
+
+bool IntProcProto::readAck(const Message &msg, quint32 &seq, bool &success)
+{
+    if((msg.type!=MSG_ACK) || (msg.payload.size()<5))
+        return false;
+    seq = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(msg.payload.constData()));
+    success = (msg.payload[4]!=0);
+    return true;
+}
+
+bool IntProcProto::unpack(QByteArray &buffer, QList<Message> &messages)
+{
+    int pos = 0;
+    while(buffer.size()-pos >= headerSize)
+    {
+        const uchar *h = reinterpret_cast<const uchar*>(buffer.constData()+pos);
+        if(qFromBigEndian<quint32>(h) != magic)
+            return false;
+        if(qFromBigEndian<quint16>(h+4) != version)
+            return false;
+
+        quint32 size = qFromBigEndian<quint32>(h+12);
+        if(size > maxPayload)
+            return false;
+        if(quint32(buffer.size()-pos-headerSize) < size)
+            break; //Wait for rest of the message
+
+        Message msg;
+        msg.type = qFromBigEndian<quint16>(h+6);
+        msg.seq  = qFromBigEndian<quint32>(h+8);
+        msg.payload = buffer.mid(pos+headerSize, int(size));
+        messages.push_back(msg);
+        pos += headerSize+int(size);
+    }
+
+    if(pos>0)
+        buffer.remove(0, pos);
+    return true;
+}
+
+QByteArray IntProcProto::packShmHandle(const QString &key, quint32 size)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_8);
+    out << key << size;
+    return payload;
+}
+
+bool IntProcProto::readShmHandle(const QByteArray &payload, QString &key, quint32 &size)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_4_8);
+    in >> key >> size;
+    return (in.status()==QDataStream::Ok) && !key.isEmpty();
+}
+
+QByteArray IntProcProto::packLevelDelta(const LevelDelta &delta)
+{
+    //Items are stored as raw level data which contains only blocks and BGO
+    LevelData items = FileFormats::dummyLvlDataArray();
+    items.sections.clear();
+    items.layers.clear();
+    items.events.clear();
+    items.blocks = delta.blocks;
+    items.bgo = delta.bgo;
+
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_8);
+    out << delta.removedBlocks << delta.removedBGO << FileFormats::WriteLvlRawData(items);
+    return payload;
+}
+
+bool IntProcProto::unpackLevelDelta(const QByteArray &payload, LevelDelta &delta)
+{
+    QByteArray raw;
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_4_8);
+    in >> delta.removedBlocks >> delta.removedBGO >> raw;
+    if(in.status()!=QDataStream::Ok)
+        return false;
+
+    LevelData items = FileFormats::ReadLvlRawData(raw);
+    if(!items.ReadFileValid)
+        return false;
+    delta.blocks = items.blocks;
+    delta.bgo = items.bgo;
+    return true;
+}
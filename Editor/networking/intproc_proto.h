@@ -0,0 +1,101 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INTPROC_PROTO_H
+#define INTPROC_PROTO_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <QVector>
+
+#include "../file_formats/lvl_filedata.h"
+
+/**
+ * @brief Framed messages between editor and engine
+ *
+ * Every message is a fixed header followed by the payload:
+ *   quint32 magic, quint16 version, quint16 type, quint32 seq, quint32 payload size
+ * All numbers are big-endian. Receiver collects bytes until the whole frame is here,
+ * so payload may contain any binary data.
+ */
+class IntProcProto
+{
+public:
+    enum MessageType
+    {
+        MSG_PING=1,
+        MSG_PONG,
+        MSG_ACK,         //payload: quint32 seq of accepted message, quint8 success
+        MSG_COMMAND,     //payload: UTF-8 command text
+        MSG_LEVEL_DATA,  //payload: FileFormats::WriteLvlRawData()
+        MSG_LEVEL_DELTA, //payload: packLevelDelta()
+        MSG_LEVEL_DATA_SHM //payload: packShmHandle(), level data is in shared memory
+    };
+
+    struct Message
+    {
+        Message() : type(0), seq(0) {}
+        quint16 type;
+        quint32 seq;
+        QByteArray payload;
+    };
+
+    /**
+     * @brief Changes of the tested level made in the editor after it was sent to the engine
+     *
+     * Items are identified by array_id. Changed item is sent whole and replaces
+     * the old one with the same array_id, removed items are sent by array_id only.
+     */
+    struct LevelDelta
+    {
+        QList<quint32> removedBlocks;
+        QList<quint32> removedBGO;
+        QVector<LevelBlock> blocks; //Added or changed blocks
+        QVector<LevelBGO> bgo;      //Added or changed BGO
+        bool isEmpty() const
+        {
+            return removedBlocks.isEmpty() && removedBGO.isEmpty() &&
+                   blocks.isEmpty() && bgo.isEmpty();
+        }
+    };
+
+    static const quint32 magic = 0x4D454750; //"PGEM"
+    static const quint16 version = 1;
+    static const int headerSize = 16;
+    static const quint32 maxPayload = 512*1024*1024;
+    static const int shmThreshold = 256*1024; //Smaller levels are sent through the socket
+
+    static QByteArray pack(quint16 type, quint32 seq, const QByteArray &payload=QByteArray());
+    static QByteArray packAck(quint32 seq, bool success);
+    static bool readAck(const Message &msg, quint32 &seq, bool &success);
+
+    /**
+     * @brief Cuts all complete messages from begin of buffer
+     * @return false if stream is broken (bad magic, unsupported version or too big payload)
+     */
+    static bool unpack(QByteArray &buffer, QList<Message> &messages);
+
+    static QByteArray packShmHandle(const QString &key, quint32 size);
+    static bool readShmHandle(const QByteArray &payload, QString &key, quint32 &size);
+
+    static QByteArray packLevelDelta(const LevelDelta &delta);
+    static bool unpackLevelDelta(const QByteArray &payload, LevelDelta &delta);
+};
+
+#endif // INTPROC_PROTO_H
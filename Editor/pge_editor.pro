@@ -112,10 +112,11 @@ TRANSLATIONS += languages/editor_en.ts \
 
 SOURCES += main.cpp\
     mainwindow.cpp \
-    ../_Libs/EasyBMP/EasyBMP.cpp \
+    ../_common/bmp_reader.cpp \
     about_dialog/aboutdialog.cpp \
     common_features/flowlayout.cpp \
     common_features/graphics_funcs.cpp \
+    ../_common/mask_blend.cpp \
     common_features/graphicsworkspace.cpp \
     common_features/grid.cpp \
     common_features/item_rectangles.cpp \
@@ -171,6 +172,8 @@ SOURCES += main.cpp\
     file_formats/file_formats.cpp \
     file_formats/file_lvl.cpp \
     file_formats/file_lvlx.cpp \
+    file_formats/file_lvl_raw.cpp \
+    file_formats/lvl_sort.cpp \
     file_formats/file_npc_txt.cpp \
     file_formats/file_wld.cpp \
     file_formats/file_wldx.cpp \
@@ -193,6 +196,7 @@ SOURCES += main.cpp\
     level_scene/lvl_control.cpp \
     level_scene/lvl_init_filedata.cpp \
     level_scene/lvl_item_placing.cpp \
+    level_scene/lvl_item_grid.cpp \
     level_scene/lvl_items.cpp \
     level_scene/lvl_resizers.cpp \
     level_scene/lvl_section.cpp \
@@ -281,6 +285,7 @@ SOURCES += main.cpp\
     level_scene/edit_modes/mode_fill.cpp \
     networking/engine_intproc.cpp \
     networking/engine_client.cpp \
+    networking/intproc_proto.cpp \
     main_window/global_settings.cpp \
     world_scene/edit_modes/wld_mode_fill.cpp \
     main_window/dock/bookmark_box.cpp \
@@ -308,14 +313,12 @@ SOURCES += main.cpp\
 HEADERS  += defines.h \
     version.h \
     mainwindow.h \
-    ../_Libs/EasyBMP/EasyBMP_BMP.h \
-    ../_Libs/EasyBMP/EasyBMP_DataStructures.h \
-    ../_Libs/EasyBMP/EasyBMP_VariousBMPutilities.h \
-    ../_Libs/EasyBMP/EasyBMP.h \
+    ../_common/bmp_reader.h \
     about_dialog/aboutdialog.h \
     common_features/app_path.h \
     common_features/flowlayout.h \
     common_features/graphics_funcs.h \
+    ../_common/mask_blend.h \
     common_features/graphicsworkspace.h \
     common_features/grid.h \
     common_features/item_rectangles.h \
@@ -358,6 +361,7 @@ HEADERS  += defines.h \
     external_tools/png2gifs_gui.h \
     file_formats/file_formats.h \
     file_formats/lvl_filedata.h \
+    file_formats/lvl_sort.h \
     file_formats/npc_filedata.h \
     file_formats/wld_filedata.h \
     item_select_dialog/itemselectdialog.h \
@@ -369,6 +373,8 @@ HEADERS  += defines.h \
     level_scene/item_water.h \
     level_scene/itemmsgbox.h \
     level_scene/lvl_item_placing.h \
+    level_scene/lvl_array_index.h \
+    level_scene/lvl_item_grid.h \
     level_scene/newlayerbox.h \
     main_window/appsettings.h \
     main_window/dock/tileset_item_box.h \
@@ -414,6 +420,7 @@ HEADERS  += defines.h \
     level_scene/edit_modes/mode_fill.h \
     networking/engine_intproc.h \
     networking/engine_client.h \
+    networking/intproc_proto.h \
     world_scene/edit_modes/wld_mode_fill.h \
     file_formats/meta_filedata.h \
     ../_Libs/giflib/gif_hash.h \
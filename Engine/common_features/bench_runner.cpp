@@ -0,0 +1,156 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench_runner.h"
+#include "../scenes/scene_level.h"
+#include "../controls/input_record.h"
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QtDebug>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+static qint64 peakMemoryKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return qint64(pmc.PeakWorkingSetSize/1024);
+    return -1;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    #ifdef __APPLE__
+    return qint64(usage.ru_maxrss/1024); //bytes on OS X
+    #else
+    return qint64(usage.ru_maxrss);
+    #endif
+#endif
+}
+
+//Hold right, jump for a third of second every second
+static InputRecord benchScript(int ticks)
+{
+    InputRecord script;
+    controller_keys keys = ResetControlKeys();
+    keys.right = true;
+    int period = PGE_Window::PhysStep;
+    for(int i = 0; i < ticks; i++)
+    {
+        keys.jump = ((i % period) < period/3);
+        script.keys.push_back(InputRecord::packKeys(keys));
+    }
+    script.seed = 1;
+    return script;
+}
+
+static double toMs(qint64 ns)
+{
+    return double(ns)/1000000.0;
+}
+
+int BenchRunner::run(QString levelFile, int ticks, QString replayFile)
+{
+    QJsonObject result;
+    result["level"] = levelFile;
+
+    LevelScene *scene = new LevelScene();
+
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = scene->loadFile(levelFile);
+    result["load_ms"] = toMs(timer.nsecsElapsed());
+
+    if(ok)
+    {
+        timer.restart();
+        ok = scene->setEntrance(0) && scene->loadConfigs();
+        result["config_ms"] = toMs(timer.nsecsElapsed());
+    }
+
+    if(ok)
+    {
+        if(!replayFile.isEmpty())
+        {
+            scene->setInputReplay(replayFile);
+            ok = scene->isInputReplay;
+            result["input"] = replayFile;
+        }
+        else
+        {
+            InputRecord script = benchScript(ticks);
+            script.levelHash = scene->levelHash();
+            scene->setInputScript(script);
+            result["input"] = QString("script");
+        }
+    }
+
+    if(ok)
+    {
+        timer.restart();
+        ok = scene->init();
+        result["init_ms"] = toMs(timer.nsecsElapsed());
+    }
+
+    if(!ok)
+    {
+        qCritical() << "Benchmark: can't start level" << levelFile << scene->getLastError();
+        delete scene;
+        return 2;
+    }
+
+    scene->isProfiling = true;
+    qint64 maxTick = 0;
+    int done = 0;
+    QElapsedTimer tickTimer;
+    timer.restart();
+    for(; (done < ticks) && !scene->doExit; done++)
+    {
+        tickTimer.start();
+        scene->update();
+        qint64 t = tickTimer.nsecsElapsed();
+        if(t > maxTick) maxTick = t;
+    }
+    qint64 total = timer.nsecsElapsed();
+
+    result["ticks"] = done;
+    result["update_ms"] = toMs(total);
+    result["tick_us_avg"] = done ? toMs(total)*1000.0/done : 0.0;
+    result["tick_us_max"] = toMs(maxTick)*1000.0;
+    result["step_ms"] = toMs(scene->profStepTime);
+    result["cull_sort_ms"] = toMs(scene->profCullTime);
+    result["bodies"] = scene->physBodiesCount();
+    result["diverged_tick"] = scene->inputReplay.divergedTick();
+
+    timer.restart();
+    delete scene;
+    result["unload_ms"] = toMs(timer.nsecsElapsed());
+    result["peak_memory_kb"] = double(peakMemoryKb());
+
+    QTextStream(stdout) << QJsonDocument(result).toJson(QJsonDocument::Compact) << "\n";
+    return 0;
+}
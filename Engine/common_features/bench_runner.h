@@ -0,0 +1,37 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCH_RUNNER_H
+#define BENCH_RUNNER_H
+
+#include <QString>
+
+///
+/// \brief Runs level without window and prints timings as JSON into stdout
+///
+/// Level is loaded, initialized and updated for given number of physics ticks.
+/// Input is taken from replay file, or from built-in script: run to the right
+/// and jump periodically.
+///
+class BenchRunner
+{
+public:
+    static int run(QString levelFile, int ticks, QString replayFile);
+};
+
+#endif // BENCH_RUNNER_H
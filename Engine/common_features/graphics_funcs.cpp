@@ -24,52 +24,20 @@
 #include <QtOpenGL/QGLWidget>
 
 #include "graphics_funcs.h"
-#include "../../_Libs/EasyBMP/EasyBMP.h"
+#include "../../_common/mask_blend.h"
+#include "../../_common/bmp_reader.h"
+#include "../graphics/gl_renderer.h"
 
 #include <QtDebug>
 
 QImage GraphicsHelps::setAlphaMask(QImage image, QImage mask)
 {
-    if(mask.isNull())
-        return image;
-
-    if(image.isNull())
-        return image;
-
-    QImage target = image;
-    QImage newmask = mask;
-
-    if(target.size()!= newmask.size())
-    {
-        newmask = newmask.copy(0,0, target.width(), target.height());
-    }
-
-    newmask.invertPixels();
-
-    target.setAlphaChannel(newmask);
-
-    return target;
+    return MaskBlend::applyMask(image, mask);
 }
 
 QImage GraphicsHelps::fromBMP(QString &file)
 {
-    QImage errImg;
-
-    BMP tarBMP;
-    if(!tarBMP.ReadFromFile( file.toLocal8Bit().data() )){
-        return errImg; //Check if empty with errImg.isNull();
-    }
-
-    QImage bmpImg(tarBMP.TellWidth(),tarBMP.TellHeight(),QImage::Format_RGB666);
-
-    for(int x = 0; x < tarBMP.TellWidth(); x++){
-        for(int y = 0; y < tarBMP.TellHeight(); y++){
-            RGBApixel pixAt = tarBMP.GetPixel(x,y);
-            bmpImg.setPixel(x,y,qRgb(pixAt.Red, pixAt.Green, pixAt.Blue));
-        }
-    }
-
-    return bmpImg;
+    return BmpReader::load(file);
 }
 
 //QPixmap GraphicsHelps::loadPixmap(QString file)
@@ -85,14 +53,35 @@ QImage GraphicsHelps::loadQImage(QString file)
     return image;
 }
 
+QImage GraphicsHelps::loadTextureImage(QString path, QString maskPath)
+{
+    QImage sourceImage = loadQImage(path);
+    if(sourceImage.isNull())
+        return sourceImage;
+
+    //Apply Alpha mask
+    if(!maskPath.isEmpty() && QFileInfo(maskPath).exists())
+    {
+        QImage maskImage = loadQImage(maskPath);
+        sourceImage = setAlphaMask(sourceImage, maskImage);
+    }
+
+    return sourceImage.convertToFormat(QImage::Format_ARGB32);
+}
+
 PGE_Texture GraphicsHelps::loadTexture(PGE_Texture &target, QString path, QString maskPath)
 {
     QImage sourceImage;
     // Load the OpenGL texture
-    sourceImage = loadQImage(path); // Gives us the information to make the texture
+    sourceImage = loadTextureImage(path, maskPath); // Gives us the information to make the texture
 
     if(sourceImage.isNull())
     {
+        if(GlRenderer::isHeadless())
+        {
+            qCritical() << "Error loading of image file:" << path;
+            exit(1);
+        }
         SDL_Quit();
         //if(ErrorCheck::hardMode)
         //{
@@ -104,14 +93,11 @@ PGE_Texture GraphicsHelps::loadTexture(PGE_Texture &target, QString path, QStrin
         return target;
     }
 
-    //Apply Alpha mask
-    if(!maskPath.isEmpty() && QFileInfo(maskPath).exists())
-    {
-        QImage maskImage = loadQImage(maskPath);
-        sourceImage = setAlphaMask(sourceImage, maskImage);
-    }
+    return makeTexture(target, sourceImage);
+}
 
-    sourceImage.convertToFormat(QImage::Format_ARGB32);
+PGE_Texture GraphicsHelps::makeTexture(PGE_Texture &target, QImage sourceImage)
+{
     QRgb upperColor = sourceImage.pixel(0,0);
     target.ColorUpper.r = float(qRed(upperColor))/255.0f;
     target.ColorUpper.g = float(qGreen(upperColor))/255.0f;
@@ -124,6 +110,18 @@ PGE_Texture GraphicsHelps::loadTexture(PGE_Texture &target, QString path, QStrin
 
     //qDebug() << path << sourceImage.size();
 
+    //Without OpenGL context texture is a placeholder with unique ID
+    if(GlRenderer::isHeadless())
+    {
+        static GLuint headlessTextureId = 0;
+        target.w = sourceImage.width();
+        target.h = sourceImage.height();
+        target.nOfColors = 4;
+        target.format = GL_RGBA;
+        target.texture = ++headlessTextureId;
+        return target;
+    }
+
     sourceImage = QGLWidget::convertToGLFormat(sourceImage).mirrored(false, true);
 
     target.nOfColors = 4;
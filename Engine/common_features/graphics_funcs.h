@@ -38,6 +38,10 @@ public:
     static QImage fromBMP(QString& file);
     static QImage loadQImage(QString file);
     static PGE_Texture loadTexture(PGE_Texture &target, QString path, QString maskPath="");
+    //! Reads image and applies mask, can be called out of main thread. Returns null image on error
+    static QImage loadTextureImage(QString path, QString maskPath="");
+    //! Makes texture from already decoded image
+    static PGE_Texture makeTexture(PGE_Texture &target, QImage sourceImage);
     static QPixmap squareImage(QPixmap image, QSize targetSize);
     static SDL_Surface *QImage_toSDLSurface(const QImage &sourceImage);
 
@@ -0,0 +1,229 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "level_prefetch.h"
+#include "graphics_funcs.h"
+#include "texture_cache.h"
+#include "../data_configs/config_manager.h"
+#include "../data_configs/custom_data.h"
+
+#include <QThreadPool>
+#include <QRunnable>
+#include <QFileInfo>
+#include <QDir>
+
+static QThreadPool prefetchPool;
+
+QString LevelPrefetch::file;
+bool LevelPrefetch::started=false;
+QMutex LevelPrefetch::lock;
+QWaitCondition LevelPrefetch::loaded;
+bool LevelPrefetch::finished=false;
+LevelData LevelPrefetch::data;
+QVector<LevelPrefetch::Image > LevelPrefetch::images;
+QAtomicInt LevelPrefetch::generation;
+
+class LevelPrefetchTask : public QRunnable
+{
+public:
+    LevelPrefetchTask(const LevelPrefetch::Setup &setup) : setup(setup) {}
+
+    void run()
+    {
+        //Task was dropped while it was waiting in the queue
+        if(setup.generation != LevelPrefetch::generation.load())
+            return;
+        LevelPrefetch::load(setup);
+    }
+
+private:
+    LevelPrefetch::Setup setup;
+};
+
+void LevelPrefetch::start(QString levelFile)
+{
+    levelFile = QDir::cleanPath(levelFile);
+    if(started && (file==levelFile))
+        return;
+
+    cancel();
+    if(!QFileInfo(levelFile).exists())
+        return;
+
+    Setup setup;
+    setup.generation = generation.load();
+    setup.file = levelFile;
+    setup.blockPath = ConfigManager::PathLevelBlock();
+    setup.bgoPath = ConfigManager::PathLevelBGO();
+    setup.bgPath = ConfigManager::PathLevelBG();
+
+    for(long i=0; i<=ConfigManager::lvl_block_indexes.maxID(); i++)
+    {
+        if(!ConfigManager::lvl_block_indexes.contains(i)) continue;
+        obj_block &block = ConfigManager::lvl_block_indexes[i];
+        setup.blocks[i] = qMakePair(block.image_n, block.mask_n);
+    }
+
+    for(long i=0; i<=ConfigManager::lvl_bgo_indexes.maxID(); i++)
+    {
+        if(!ConfigManager::lvl_bgo_indexes.contains(i)) continue;
+        obj_bgo &bgo = ConfigManager::lvl_bgo_indexes[i];
+        setup.bgo[i] = qMakePair(bgo.image_n, bgo.mask_n);
+    }
+
+    for(long i=0; i<=ConfigManager::lvl_bg_indexes.maxID(); i++)
+    {
+        if(!ConfigManager::lvl_bg_indexes.contains(i)) continue;
+        obj_BG &bg = ConfigManager::lvl_bg_indexes[i];
+        setup.bg[i] = qMakePair(bg.image_n, (bg.type==1) ? bg.second_image_n : QString());
+    }
+
+    setup.resident = TextureCache::residentKeys();
+
+    file = levelFile;
+    started = true;
+    //Dropped task may still be parsing its file, new one waits for it in the queue
+    prefetchPool.setMaxThreadCount(1);
+    prefetchPool.start(new LevelPrefetchTask(setup));
+}
+
+bool LevelPrefetch::take(QString levelFile, LevelData &target)
+{
+    if(!started)
+        return false;
+
+    if(file != QDir::cleanPath(levelFile))
+    {
+        cancel();
+        return false;
+    }
+
+    lock.lock();
+    while(!finished)
+        loaded.wait(&lock);
+    LevelData level = data;
+    QVector<Image > decoded = images;
+    lock.unlock();
+    reset();
+
+    bool valid = level.ReadFileValid;
+    if(valid)
+    {
+        target = level;
+        foreach(const Image &img, decoded)
+            TextureCache::addDecoded(img.path, img.maskPath, img.image);
+    }
+    return valid;
+}
+
+void LevelPrefetch::cancel()
+{
+    if(!started)
+        return;
+    reset();
+}
+
+void LevelPrefetch::shutdown()
+{
+    cancel();
+    prefetchPool.waitForDone();
+}
+
+void LevelPrefetch::reset()
+{
+    QMutexLocker locker(&lock);
+    //Result of running task will be dropped
+    generation.ref();
+    finished = false;
+    data = LevelData();
+    images.clear();
+
+    started = false;
+    file.clear();
+}
+
+void LevelPrefetch::load(const Setup &setup)
+{
+    //Validators of file formats are per-thread, so parsing is safe here
+    LevelData level = FileFormats::OpenLevelFile(setup.file);
+
+    QVector<Image > decoded;
+    QSet<QString> queued = setup.resident;
+
+    //Same paths as main thread will give to TextureCache::acquire()
+    auto decode = [&](QString path, QString maskPath)
+    {
+        QString key = TextureCache::key(path, maskPath);
+        if(queued.contains(key) || (generation.load() != setup.generation))
+            return;
+        queued.insert(key);
+
+        Image img;
+        img.path = path;
+        img.maskPath = maskPath;
+        img.image = GraphicsHelps::loadTextureImage(path, maskPath);
+        if(!img.image.isNull())
+            decoded.push_back(img);
+    };
+
+    if(level.ReadFileValid)
+    {
+        CustomDirManager dirBlocks(level.path, level.filename, setup.blockPath);
+        CustomDirManager dirBGO(level.path, level.filename, setup.bgoPath);
+        CustomDirManager dirBG(level.path, level.filename, setup.bgPath);
+
+        QSet<long> ids;
+        foreach(const LevelSection &section, level.sections)
+            ids.insert(section.background);
+        foreach(long id, ids)
+        {
+            if(!setup.bg.contains(id)) continue;
+            decode(dirBG.getCustomFile(setup.bg[id].first), "");
+            if(!setup.bg[id].second.isEmpty())
+                decode(dirBG.getCustomFile(setup.bg[id].second), "");
+        }
+
+        ids.clear();
+        foreach(const LevelBlock &block, level.blocks)
+            ids.insert(block.id);
+        foreach(long id, ids)
+        {
+            if(!setup.blocks.contains(id)) continue;
+            decode(dirBlocks.getCustomFile(setup.blocks[id].first),
+                   dirBlocks.getCustomFile(setup.blocks[id].second));
+        }
+
+        ids.clear();
+        foreach(const LevelBGO &bgo, level.bgo)
+            ids.insert(bgo.id);
+        foreach(long id, ids)
+        {
+            if(!setup.bgo.contains(id)) continue;
+            decode(dirBGO.getCustomFile(setup.bgo[id].first),
+                   dirBGO.getCustomFile(setup.bgo[id].second));
+        }
+    }
+
+    QMutexLocker locker(&lock);
+    if(generation.load() != setup.generation)
+        return; //Level isn't needed anymore
+    data = level;
+    images = decoded;
+    finished = true;
+    loaded.wakeAll();
+}
@@ -0,0 +1,94 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVEL_PREFETCH_H
+#define LEVEL_PREFETCH_H
+
+#include <QString>
+#include <QImage>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <file_formats.h>
+
+///
+/// \brief Loads next level in background while player is entering the warp
+///
+/// Level file is parsed and images of blocks, BGO and backgrounds used by it
+/// are decoded on worker thread. When main thread loads the same file, parsed
+/// data is taken as is and decoded images are given to TextureCache,
+/// so only uploading of textures is left for the loader.
+///
+class LevelPrefetch
+{
+public:
+    //! Starts loading of level file, does nothing if same file is already loading
+    static void start(QString levelFile);
+    //! Waits for loading of the file and gives its data. Returns false if file wasn't prefetched
+    static bool take(QString levelFile, LevelData &target);
+    //! Drops result of background loading, worker isn't waited and finishes on its own
+    static void cancel();
+    //! Drops result and waits for the worker, must be called before exit
+    static void shutdown();
+
+private:
+    friend class LevelPrefetchTask;
+
+    //! Snapshot of settings taken by main thread, worker never touches ConfigManager
+    struct Setup
+    {
+        int generation;                               //!< Result is dropped when it's not actual anymore
+        QString file;
+        QString blockPath;
+        QString bgoPath;
+        QString bgPath;
+        QHash<long, QPair<QString, QString> > blocks; //!< Image and mask of each block ID
+        QHash<long, QPair<QString, QString> > bgo;    //!< Image and mask of each BGO ID
+        QHash<long, QPair<QString, QString> > bg;     //!< First and second image of each background ID
+        QSet<QString> resident;                       //!< Textures which are already loaded
+    };
+
+    struct Image
+    {
+        QString path;
+        QString maskPath;
+        QImage image;
+    };
+
+    static void load(const Setup &setup);
+    static void reset();
+
+    //Used by main thread only
+    static QString file;
+    static bool started;
+
+    //Guarded by lock, worker gives result only if its generation is still actual
+    static QMutex lock;
+    static QWaitCondition loaded;
+    static bool finished;
+    static LevelData data;
+    static QVector<Image > images;
+    static QAtomicInt generation;
+};
+
+#endif // LEVEL_PREFETCH_H
@@ -23,11 +23,13 @@
 
 SimpleAnimator::SimpleAnimator()
 {
+    timer_id = 0;
     construct(false, 1, 64, 0, -1, false, false);
 }
 
 SimpleAnimator::SimpleAnimator(const SimpleAnimator &animator)
 {
+    timer_id = 0;
     construct(animator.animated,
               animator.framesQ,
               animator.speed,
@@ -39,6 +41,7 @@ SimpleAnimator::SimpleAnimator(const SimpleAnimator &animator)
 
 SimpleAnimator::SimpleAnimator(bool enables, int framesq, int fspeed, int First, int Last, bool rev, bool bid)
 {
+    timer_id = 0;
     construct(enables, framesq, fspeed, First, Last, rev, bid);
 }
 
@@ -87,6 +90,7 @@ bool SimpleAnimator::operator==(const SimpleAnimator &animator) const
 
 SimpleAnimator &SimpleAnimator::operator=(const SimpleAnimator &animator)
 {
+    this->stop();
     this->construct(animator.animated,
               animator.framesQ,
               animator.speed,
@@ -151,12 +155,6 @@ void SimpleAnimator::nextFrame()
 
     pos1 = CurrentFrame/framesQ;
     pos2 = CurrentFrame/framesQ + 1.0d/framesQ;
-
-    if(isEnabled)
-        timer_id = SDL_AddTimer(speed, &SimpleAnimator::TickAnimation, this);
-    else
-        SDL_RemoveTimer(timer_id);
-
 }
 
 
@@ -185,7 +183,7 @@ void SimpleAnimator::start()
 
     if((frameLast>0)&&((frameLast-frameFirst)<=1)) return; //Don't start singleFrame animation
     isEnabled=true;
-    timer_id = SDL_AddTimer(speed, &SimpleAnimator::TickAnimation, this);
+    timer_id = TimerScheduler::add(speed, &SimpleAnimator::TickAnimation, this);
 }
 
 void SimpleAnimator::stop()
@@ -193,7 +191,8 @@ void SimpleAnimator::stop()
     if(!animated) return;
     if(!isEnabled) return;
     isEnabled=false;
-    SDL_RemoveTimer(timer_id);
+    TimerScheduler::remove(timer_id);
+    timer_id = 0;
     setFrame(frameFirst);
 }
 
@@ -202,7 +201,7 @@ unsigned int SimpleAnimator::TickAnimation(unsigned int x, void *p)
     Q_UNUSED(x);
     SimpleAnimator *self = reinterpret_cast<SimpleAnimator *>(p);
     self->nextFrame();
-    return 0;
+    return self->isEnabled ? self->speed : 0;
 }
 
 
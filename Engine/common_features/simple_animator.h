@@ -19,7 +19,7 @@
 #ifndef SIMPLE_ANIMATOR_H
 #define SIMPLE_ANIMATOR_H
 
-#include <SDL2/SDL_timer.h>
+#include "timer_scheduler.h"
 #include <utility>
 
 typedef std::pair<double, double > AniPos;
@@ -69,7 +69,7 @@ private:
     int frameCurrent;
 
     bool isEnabled;
-    SDL_TimerID timer_id;
+    int timer_id;
 
     double framesQ;
     int frameSize; // size of one frame
@@ -0,0 +1,182 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "texture_cache.h"
+#include "graphics_funcs.h"
+#include "../graphics/gl_renderer.h"
+
+#include <QtDebug>
+
+QHash<QString, TextureCache::Entry > TextureCache::entries;
+QHash<GLuint, QString > TextureCache::keys;
+QHash<QString, QImage > TextureCache::decoded;
+qint64  TextureCache::_budget = 256*1024*1024;
+qint64  TextureCache::_resident = 0;
+quint64 TextureCache::_useCounter = 0;
+quint64 TextureCache::_hits = 0;
+quint64 TextureCache::_misses = 0;
+quint64 TextureCache::_evicted = 0;
+
+PGE_Texture TextureCache::acquire(QString path, QString maskPath)
+{
+    QString key = TextureCache::key(path, maskPath);
+
+    QHash<QString, Entry >::iterator it = entries.find(key);
+    if(it != entries.end())
+    {
+        it->refs++;
+        it->lastUse = ++_useCounter;
+        _hits++;
+        return it->texture;
+    }
+
+    _misses++;
+
+    Entry entry;
+    entry.texture.w = 0;
+    entry.texture.h = 0;
+    entry.texture.texture = 0;
+    entry.texture.texture_layout = NULL;
+    entry.texture.format = 0;
+    entry.texture.nOfColors = 0;
+
+    QHash<QString, QImage >::iterator ready = decoded.find(key);
+    if(ready != decoded.end())
+    {
+        GraphicsHelps::makeTexture(entry.texture, ready.value());
+        decoded.erase(ready);
+    }
+    else
+        GraphicsHelps::loadTexture(entry.texture, path, maskPath);
+
+    entry.refs = 1;
+    entry.bytes = qint64(entry.texture.w) * entry.texture.h * 4;
+    entry.lastUse = ++_useCounter;
+
+    entries.insert(key, entry);
+    keys.insert(entry.texture.texture, key);
+    _resident += entry.bytes;
+
+    trim();
+    return entry.texture;
+}
+
+void TextureCache::release(GLuint texture)
+{
+    QHash<GLuint, QString >::iterator k = keys.find(texture);
+    if(k == keys.end())
+        return;
+
+    QHash<QString, Entry >::iterator it = entries.find(k.value());
+    if((it != entries.end()) && (it->refs > 0))
+        it->refs--;
+}
+
+void TextureCache::trim()
+{
+    while(_resident > _budget)
+    {
+        QHash<QString, Entry >::iterator victim = entries.end();
+        for(QHash<QString, Entry >::iterator it = entries.begin(); it != entries.end(); it++)
+        {
+            if(it->refs > 0) continue;
+            if((victim == entries.end()) || (it->lastUse < victim->lastUse))
+                victim = it;
+        }
+
+        //Everything is used by current level
+        if(victim == entries.end())
+            break;
+
+        if(!GlRenderer::isHeadless())
+        {
+            glDisable(GL_TEXTURE_2D);
+            glDeleteTextures(1, &(victim->texture.texture));
+        }
+        _resident -= victim->bytes;
+        _evicted++;
+        keys.remove(victim->texture.texture);
+        entries.erase(victim);
+    }
+}
+
+void TextureCache::clear()
+{
+    if(!GlRenderer::isHeadless())
+    {
+        glDisable(GL_TEXTURE_2D);
+        for(QHash<QString, Entry >::iterator it = entries.begin(); it != entries.end(); it++)
+            glDeleteTextures(1, &(it->texture.texture));
+    }
+
+    qDebug() << "Texture cache: hits" << _hits << "misses" << _misses << "evicted" << _evicted;
+
+    entries.clear();
+    keys.clear();
+    decoded.clear();
+    _resident = 0;
+}
+
+void TextureCache::addDecoded(QString path, QString maskPath, const QImage &image)
+{
+    QString k = key(path, maskPath);
+    if(image.isNull() || entries.contains(k))
+        return;
+    decoded.insert(k, image);
+}
+
+void TextureCache::clearDecoded()
+{
+    decoded.clear();
+}
+
+QString TextureCache::key(QString path, QString maskPath)
+{
+    return path + "\n" + maskPath;
+}
+
+QSet<QString> TextureCache::residentKeys()
+{
+    return QSet<QString>::fromList(entries.keys());
+}
+
+void TextureCache::setBudget(int megabytes)
+{
+    _budget = qint64(megabytes)*1024*1024;
+    trim();
+}
+
+int TextureCache::budget()
+{
+    return int(_budget/(1024*1024));
+}
+
+qint64 TextureCache::residentBytes()
+{
+    return _resident;
+}
+
+QString TextureCache::stats()
+{
+    quint64 requests = _hits + _misses;
+    return QString("Textures %1, %2 of %3 MB, hits %4%")
+            .arg(entries.size())
+            .arg(double(_resident)/(1024.0*1024.0), 0, 'f', 1)
+            .arg(budget())
+            .arg(requests ? (_hits*100/requests) : 0);
+}
@@ -0,0 +1,82 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "pge_texture.h"
+#include <QString>
+#include <QHash>
+#include <QImage>
+#include <QSet>
+
+/*!
+ * \brief Keeps level textures loaded between levels
+ *
+ * Textures are counted by references. Textures which are not used by current level
+ * stay resident to be reused by next level, and are deleted in least-recently-used
+ * order only when resident memory exceeds the budget.
+ */
+class TextureCache
+{
+public:
+    //! Returns texture of image and mask pair, loads it if it's not resident
+    static PGE_Texture acquire(QString path, QString maskPath="");
+    //! Texture is not used by caller anymore, it stays resident until it will be evicted
+    static void release(GLuint texture);
+    //! Deletes unused textures while resident memory is over budget
+    static void trim();
+    //! Deletes all textures, must be called while OpenGL context is alive
+    static void clear();
+
+    //! Image which was decoded in background, it will be used instead of the file on acquiring
+    static void addDecoded(QString path, QString maskPath, const QImage &image);
+    //! Drops decoded images which were never acquired
+    static void clearDecoded();
+    //! Key of image and mask pair
+    static QString key(QString path, QString maskPath);
+    //! Keys of all loaded textures
+    static QSet<QString> residentKeys();
+
+    static void setBudget(int megabytes);
+    static int budget();
+    static qint64 residentBytes();
+    //! Line for debug overlay: resident textures, memory and hit rate
+    static QString stats();
+
+private:
+    struct Entry
+    {
+        PGE_Texture texture;
+        int refs;
+        qint64 bytes;
+        quint64 lastUse;
+    };
+
+    static QHash<QString, Entry > entries;
+    static QHash<GLuint, QString > keys;
+    static QHash<QString, QImage > decoded;
+    static qint64 _budget;
+    static qint64 _resident;
+    static quint64 _useCounter;
+    static quint64 _hits;
+    static quint64 _misses;
+    static quint64 _evicted;
+};
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,119 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timer_scheduler.h"
+
+#include <SDL2/SDL_timer.h>
+#include <algorithm>
+
+QVector<TimerScheduler::Timer > TimerScheduler::heap;
+QSet<int > TimerScheduler::alive;
+double TimerScheduler::_now=0.0;
+unsigned int TimerScheduler::lastWallClock=0;
+int TimerScheduler::lastId=0;
+
+//After longer freeze (loading, debugger) periodic timers are not catching up
+static const double maxTimerLag = 1000.0;
+
+bool TimerScheduler::later(const Timer &a, const Timer &b)
+{
+    if(a.deadline != b.deadline)
+        return a.deadline > b.deadline;
+    return a.id > b.id; //Timers with same deadline are called in order of adding
+}
+
+int TimerScheduler::add(unsigned int delay, Callback callback, void *param)
+{
+    if(!callback)
+        return 0;
+
+    if(lastId == 0x7FFFFFFF) lastId = 0;
+    Timer t;
+    t.deadline = _now + delay;
+    t.id = ++lastId;
+    t.interval = delay;
+    t.callback = callback;
+    t.param = param;
+
+    alive.insert(t.id);
+    heap.push_back(t);
+    std::push_heap(heap.begin(), heap.end(), &TimerScheduler::later);
+    return t.id;
+}
+
+void TimerScheduler::remove(int id)
+{
+    //Entry stays in the heap and is dropped when it will expire
+    alive.remove(id);
+    if(alive.isEmpty())
+        heap.clear();
+}
+
+void TimerScheduler::advance(double ms)
+{
+    if(ms > 0.0)
+        _now += ms;
+    lastWallClock = SDL_GetTicks();
+
+    while(!heap.isEmpty() && (heap.first().deadline <= _now))
+    {
+        std::pop_heap(heap.begin(), heap.end(), &TimerScheduler::later);
+        Timer t = heap.last();
+        heap.pop_back();
+
+        if(!alive.contains(t.id))
+            continue;
+
+        unsigned int next = t.callback(t.interval, t.param);
+
+        //Callback is able to cancel own timer
+        if(!alive.contains(t.id))
+            continue;
+
+        if(next == 0)
+        {
+            alive.remove(t.id);
+            continue;
+        }
+
+        t.interval = next;
+        t.deadline += next;
+        if(t.deadline < _now - maxTimerLag)
+            t.deadline = _now + next;
+        heap.push_back(t);
+        std::push_heap(heap.begin(), heap.end(), &TimerScheduler::later);
+    }
+}
+
+void TimerScheduler::sync()
+{
+    unsigned int wallClock = SDL_GetTicks();
+    if(lastWallClock == 0)
+        lastWallClock = wallClock;
+    advance(double(wallClock - lastWallClock));
+}
+
+double TimerScheduler::now()
+{
+    return _now;
+}
+
+int TimerScheduler::count()
+{
+    return alive.size();
+}
@@ -0,0 +1,71 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMER_SCHEDULER_H
+#define TIMER_SCHEDULER_H
+
+#include <QVector>
+#include <QSet>
+
+///
+/// \brief Timers of animators, faders and delayed actions, processed by main thread
+///
+/// Deadlines are kept in min-heap. Time is moved forward by fixed step of
+/// level simulation (advance) or by wall clock while simulation is not running,
+/// like loading or message boxes (sync). Callbacks are called only from these
+/// functions, so they can change game state without locks.
+///
+class TimerScheduler
+{
+public:
+    //! Returns delay of next call in milliseconds, 0 - timer is finished
+    typedef unsigned int (*Callback)(unsigned int interval, void *param);
+
+    //! Calls function after delay in milliseconds, returns ID of timer
+    static int add(unsigned int delay, Callback callback, void *param);
+    //! Cancels timer, it's safe to call it for finished timers and from callbacks
+    static void remove(int id);
+
+    //! Moves time forward and calls all expired timers
+    static void advance(double ms);
+    //! Moves time forward by wall clock passed since last advance or sync
+    static void sync();
+
+    static double now();
+    //! Number of active timers
+    static int count();
+
+private:
+    struct Timer
+    {
+        double deadline;
+        int id;
+        unsigned int interval;
+        Callback callback;
+        void *param;
+    };
+    static bool later(const Timer &a, const Timer &b);
+
+    static QVector<Timer > heap;
+    static QSet<int > alive;
+    static double _now;
+    static unsigned int lastWallClock;
+    static int lastId;
+};
+
+#endif // TIMER_SCHEDULER_H
@@ -0,0 +1,72 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "controller_replay.h"
+
+#include <QtDebug>
+
+ReplayController::ReplayController()
+{
+    tick = 0;
+    diverged = -1;
+}
+
+bool ReplayController::open(QString filePath)
+{
+    tick = 0;
+    diverged = -1;
+    return record.load(filePath);
+}
+
+void ReplayController::update()
+{
+    if(isFinished())
+    {
+        keys = noKeys();
+        return;
+    }
+    keys = InputRecord::unpackKeys(record.keys[tick]);
+    tick++;
+}
+
+bool ReplayController::isFinished()
+{
+    return tick >= record.keys.size();
+}
+
+int ReplayController::currentTick()
+{
+    return tick;
+}
+
+void ReplayController::checkState(quint32 state)
+{
+    if(diverged >= 0) return;
+    if((tick <= 0) || (tick > record.states.size())) return;
+
+    if(record.states[tick-1] != state)
+    {
+        diverged = tick-1;
+        qWarning() << "Replay: physics state diverged from record at tick" << diverged;
+    }
+}
+
+int ReplayController::divergedTick()
+{
+    return diverged;
+}
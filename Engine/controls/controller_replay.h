@@ -0,0 +1,49 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONTROLLER_REPLAY_H
+#define CONTROLLER_REPLAY_H
+
+#include "controller.h"
+#include "input_record.h"
+
+///
+/// \brief Feeds keys from input record, one set per physics tick
+///
+class ReplayController : public Controller
+{
+public:
+    ReplayController();
+    bool open(QString filePath);
+
+    void update();
+    bool isFinished();
+    int currentTick();
+
+    //! Compares state of players after current tick with recorded one
+    void checkState(quint32 state);
+    int divergedTick(); //!< First tick where state differs from record, -1 if none
+
+    InputRecord record;
+
+private:
+    int tick;
+    int diverged;
+};
+
+#endif // CONTROLLER_REPLAY_H
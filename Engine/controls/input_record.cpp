@@ -0,0 +1,150 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_record.h"
+#include "controller.h"
+
+#include <QFile>
+#include <QDataStream>
+#include <string.h>
+
+static const char  inputRecordMagic[8] = {'P','G','E','I','N','P','U','T'};
+static const quint32 inputRecordVersion = 1;
+
+InputRecord::InputRecord()
+{
+    clear();
+}
+
+void InputRecord::clear()
+{
+    seed = 0;
+    levelHash.clear();
+    keys.clear();
+    states.clear();
+    errorString.clear();
+}
+
+bool InputRecord::save(QString filePath)
+{
+    QFile file(filePath);
+    if(!file.open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        errorString = "Can't open file for write: "+filePath;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out.writeRawData(inputRecordMagic, sizeof(inputRecordMagic));
+    out << inputRecordVersion << seed << levelHash;
+    out << quint32(keys.size());
+    for(int i = 0; i < keys.size(); i++)
+        out << keys[i] << ((i < states.size()) ? states[i] : quint32(0));
+
+    return out.status() == QDataStream::Ok;
+}
+
+bool InputRecord::load(QString filePath)
+{
+    clear();
+    QFile file(filePath);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        errorString = "Can't open file: "+filePath;
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    char magic[sizeof(inputRecordMagic)];
+    quint32 version = 0;
+    if((in.readRawData(magic, sizeof(magic)) != sizeof(magic)) ||
+       (memcmp(magic, inputRecordMagic, sizeof(magic)) != 0))
+    {
+        errorString = "Not an input record file";
+        return false;
+    }
+
+    in >> version;
+    if(version != inputRecordVersion)
+    {
+        errorString = QString("Unsupported input record version %1").arg(version);
+        return false;
+    }
+
+    quint32 count = 0;
+    in >> seed >> levelHash >> count;
+    //Every frame is a quint16 key and a quint32 state
+    if((in.status() != QDataStream::Ok) ||
+       (quint64(count)*6 > quint64(file.bytesAvailable())))
+    {
+        errorString = "Input record is damaged";
+        return false;
+    }
+
+    keys.reserve(count);
+    states.reserve(count);
+    for(quint32 i = 0; i < count; i++)
+    {
+        quint16 k;
+        quint32 s;
+        in >> k >> s;
+        if(in.status() != QDataStream::Ok)
+        {
+            errorString = "Input record is damaged";
+            return false;
+        }
+        keys.push_back(k);
+        states.push_back(s);
+    }
+    return true;
+}
+
+quint16 InputRecord::packKeys(const controller_keys &keys)
+{
+    quint16 bits = 0;
+    if(keys.start)    bits |= 1 << Controller::key_start;
+    if(keys.left)     bits |= 1 << Controller::key_left;
+    if(keys.right)    bits |= 1 << Controller::key_right;
+    if(keys.up)       bits |= 1 << Controller::key_up;
+    if(keys.down)     bits |= 1 << Controller::key_down;
+    if(keys.run)      bits |= 1 << Controller::key_run;
+    if(keys.jump)     bits |= 1 << Controller::key_jump;
+    if(keys.alt_run)  bits |= 1 << Controller::key_altrun;
+    if(keys.alt_jump) bits |= 1 << Controller::key_altjump;
+    if(keys.drop)     bits |= 1 << Controller::key_drop;
+    return bits;
+}
+
+controller_keys InputRecord::unpackKeys(quint16 bits)
+{
+    controller_keys keys;
+    keys.start    = (bits & (1 << Controller::key_start)) != 0;
+    keys.left     = (bits & (1 << Controller::key_left)) != 0;
+    keys.right    = (bits & (1 << Controller::key_right)) != 0;
+    keys.up       = (bits & (1 << Controller::key_up)) != 0;
+    keys.down     = (bits & (1 << Controller::key_down)) != 0;
+    keys.run      = (bits & (1 << Controller::key_run)) != 0;
+    keys.jump     = (bits & (1 << Controller::key_jump)) != 0;
+    keys.alt_run  = (bits & (1 << Controller::key_altrun)) != 0;
+    keys.alt_jump = (bits & (1 << Controller::key_altjump)) != 0;
+    keys.drop     = (bits & (1 << Controller::key_drop)) != 0;
+    return keys;
+}
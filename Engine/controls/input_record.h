@@ -0,0 +1,54 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include "control_keys.h"
+
+///
+/// \brief Controller keys of every physics tick of level session
+///
+/// Together with random seed and hash of level data it is enough to repeat
+/// the session. Checksums of players state are stored to find the tick where
+/// physics of replayed session went other way.
+///
+class InputRecord
+{
+public:
+    InputRecord();
+    void clear();
+
+    bool save(QString filePath);
+    bool load(QString filePath);
+
+    static quint16 packKeys(const controller_keys &keys);
+    static controller_keys unpackKeys(quint16 bits);
+
+    quint32 seed;
+    QByteArray levelHash;
+    QVector<quint16> keys;   //!< Packed controller keys of every tick
+    QVector<quint32> states; //!< Checksum of players state after every tick
+
+    QString errorString;
+};
+
+#endif // INPUT_RECORD_H
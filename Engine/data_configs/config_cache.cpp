@@ -0,0 +1,342 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config_manager.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QCryptographicHash>
+
+#include <QtDebug>
+
+//Level items settings are parsed from INI-files once, then are stored into binary cache
+//which is valid while INI-files are keeping same size and modification time
+
+QByteArray ConfigManager::level_settings_stamp;
+
+static const char    levelCacheMagic[] = "PGECFGC";
+static const quint32 levelCacheVersion = 1;
+
+static const char *levelSettingsFiles[] = {"lvl_blocks.ini", "lvl_bgo.ini", "lvl_bkgrd.ini"};
+
+
+static inline void writeInt(QDataStream &out, qint64 value)
+{
+    out << value;
+}
+
+static inline qint64 readInt(QDataStream &in)
+{
+    qint64 value=0;
+    in >> value;
+    return value;
+}
+
+
+static void writeBlock(QDataStream &out, const obj_block &b)
+{
+    writeInt(out, b.id);
+    out << b.image_n << b.mask_n << b.name << b.group << b.category;
+    writeInt(out, b.grid);
+    out << b.sizable;
+    writeInt(out, b.danger);
+    writeInt(out, b.collision);
+    out << b.slopeslide;
+    writeInt(out, b.phys_shape);
+    out << b.lava << b.destroyable << b.destroyable_by_bomb << b.destroyable_by_fireball << b.spawn;
+    writeInt(out, b.spawn_obj);
+    writeInt(out, b.spawn_obj_id);
+    writeInt(out, b.effect);
+    out << b.bounce << b.hitable;
+    writeInt(out, b.transfororm_on_hit_into);
+    writeInt(out, b.algorithm);
+    writeInt(out, b.view);
+    out << b.animated << b.animation_rev << b.animation_bid;
+    writeInt(out, b.frames);
+    writeInt(out, b.framespeed);
+    writeInt(out, b.frame_h);
+    writeInt(out, b.display_frame);
+    out << b.default_slippery << b.default_slippery_value;
+    out << b.default_invisible << b.default_invisible_value;
+    out << b.default_content;
+    writeInt(out, b.default_content_value);
+}
+
+static void readBlock(QDataStream &in, obj_block &b)
+{
+    b.id = readInt(in);
+    in >> b.image_n >> b.mask_n >> b.name >> b.group >> b.category;
+    b.grid = readInt(in);
+    in >> b.sizable;
+    b.danger = readInt(in);
+    b.collision = readInt(in);
+    in >> b.slopeslide;
+    b.phys_shape = readInt(in);
+    in >> b.lava >> b.destroyable >> b.destroyable_by_bomb >> b.destroyable_by_fireball >> b.spawn;
+    b.spawn_obj = readInt(in);
+    b.spawn_obj_id = readInt(in);
+    b.effect = readInt(in);
+    in >> b.bounce >> b.hitable;
+    b.transfororm_on_hit_into = readInt(in);
+    b.algorithm = readInt(in);
+    b.view = readInt(in);
+    in >> b.animated >> b.animation_rev >> b.animation_bid;
+    b.frames = readInt(in);
+    b.framespeed = readInt(in);
+    b.frame_h = readInt(in);
+    b.display_frame = readInt(in);
+    in >> b.default_slippery >> b.default_slippery_value;
+    in >> b.default_invisible >> b.default_invisible_value;
+    in >> b.default_content;
+    b.default_content_value = readInt(in);
+}
+
+
+static void writeBgo(QDataStream &out, const obj_bgo &b)
+{
+    writeInt(out, b.id);
+    out << b.name << b.group << b.category;
+    writeInt(out, b.grid);
+    writeInt(out, b.view);
+    writeInt(out, b.offsetX);
+    writeInt(out, b.offsetY);
+    writeInt(out, b.zOffset);
+    out << b.image_n << b.mask_n;
+    out << b.climbing << b.animated;
+    writeInt(out, b.frames);
+    writeInt(out, b.framespeed);
+    writeInt(out, b.frame_h);
+    writeInt(out, b.display_frame);
+}
+
+static void readBgo(QDataStream &in, obj_bgo &b)
+{
+    b.id = readInt(in);
+    in >> b.name >> b.group >> b.category;
+    b.grid = readInt(in);
+    b.view = readInt(in);
+    b.offsetX = readInt(in);
+    b.offsetY = readInt(in);
+    b.zOffset = readInt(in);
+    in >> b.image_n >> b.mask_n;
+    in >> b.climbing >> b.animated;
+    b.frames = readInt(in);
+    b.framespeed = readInt(in);
+    b.frame_h = readInt(in);
+    b.display_frame = readInt(in);
+}
+
+
+static void writeBG(QDataStream &out, const obj_BG &b)
+{
+    writeInt(out, b.id);
+    out << b.name << b.image_n;
+    writeInt(out, b.type);
+    out << b.repeat_h;
+    writeInt(out, b.repead_v);
+    writeInt(out, b.attached);
+    out << b.editing_tiled << b.animated;
+    writeInt(out, b.frames);
+    writeInt(out, b.frame_h);
+    writeInt(out, b.display_frame);
+    out << b.magic;
+    writeInt(out, b.magic_strips);
+    out << b.magic_splits << b.magic_splits_i << b.magic_speeds << b.magic_speeds_i;
+    out << b.second_image_n << b.second_repeat_h;
+    writeInt(out, b.second_repeat_v);
+    writeInt(out, b.second_attached);
+}
+
+static void readBG(QDataStream &in, obj_BG &b)
+{
+    b.id = readInt(in);
+    in >> b.name >> b.image_n;
+    b.type = readInt(in);
+    in >> b.repeat_h;
+    b.repead_v = readInt(in);
+    b.attached = readInt(in);
+    in >> b.editing_tiled >> b.animated;
+    b.frames = readInt(in);
+    b.frame_h = readInt(in);
+    b.display_frame = readInt(in);
+    in >> b.magic;
+    b.magic_strips = readInt(in);
+    in >> b.magic_splits >> b.magic_splits_i >> b.magic_speeds >> b.magic_speeds_i;
+    in >> b.second_image_n >> b.second_repeat_h;
+    b.second_repeat_v = readInt(in);
+    b.second_attached = readInt(in);
+}
+
+
+template<class T>
+static void writeIndex(QDataStream &out, ConfigIndex<T> &index, void (*writeItem)(QDataStream &, const T &))
+{
+    writeInt(out, index.maxID());
+    writeInt(out, index.size());
+    for(long i=0; i<=index.maxID(); i++)
+    {
+        if(index.contains(i))
+            writeItem(out, index[i]);
+    }
+}
+
+template<class T>
+static bool readIndex(QDataStream &in, ConfigIndex<T> &index, void (*readItem)(QDataStream &, T &))
+{
+    long maxID = readInt(in);
+    long count = readInt(in);
+    //Every item has at least its 8-byte ID
+    if((in.status()!=QDataStream::Ok) || (maxID<0) || (count<0) || (count>maxID+1) ||
+       (count > in.device()->bytesAvailable()/8))
+        return false;
+
+    //IDs are going in a row, index grows by insert() if the file has gaps
+    index.allocate(qMin(maxID, count));
+    T item;
+    for(long i=0; i<count; i++)
+    {
+        item = T();
+        readItem(in, item);
+        if(in.status()!=QDataStream::Ok)
+            return false;
+        //All texture links are initializing per level
+        item.isInit = false;
+        item.image = NULL;
+        item.textureArrayId = 0;
+        item.animator_ID = 0;
+        index.insert(item.id, item);
+    }
+    return true;
+}
+
+
+QByteArray ConfigManager::levelSettingsStamp()
+{
+    QByteArray stamp;
+    QDataStream out(&stamp, QIODevice::WriteOnly);
+    out << config_dir;
+    for(unsigned int i=0; i<sizeof(levelSettingsFiles)/sizeof(levelSettingsFiles[0]); i++)
+    {
+        QFileInfo ini(config_dir + levelSettingsFiles[i]);
+        out << ini.exists() << (qint64)ini.size() << (qint64)ini.lastModified().toMSecsSinceEpoch();
+    }
+    return stamp;
+}
+
+QString ConfigManager::levelSettingsCacheFile()
+{
+    QByteArray key = QCryptographicHash::hash(config_dir.toUtf8(), QCryptographicHash::Md5);
+    return ApplicationPath + "/cache/" + QString::fromLatin1(key.toHex()) + ".cache";
+}
+
+bool ConfigManager::loadLevelSettingsCache(const QByteArray &stamp)
+{
+    QFile file(levelSettingsCacheFile());
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    QByteArray raw = file.readAll();
+    file.close();
+
+    QDataStream in(raw);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    QByteArray magic;
+    quint32 version=0;
+    QByteArray cacheStamp;
+    in >> magic >> version >> cacheStamp;
+    if((in.status()!=QDataStream::Ok) || (magic!=levelCacheMagic) ||
+       (version!=levelCacheVersion) || (cacheStamp!=stamp))
+        return false;
+
+    if( !readIndex(in, lvl_block_indexes, &readBlock) ||
+        !readIndex(in, lvl_bgo_indexes, &readBgo) ||
+        !readIndex(in, lvl_bg_indexes, &readBG) )
+    {
+        qWarning() << "Config cache is broken, INI-files will be parsed" << file.fileName();
+        lvl_block_indexes.clear();
+        lvl_bgo_indexes.clear();
+        lvl_bg_indexes.clear();
+        return false;
+    }
+
+    for(long i=0; i<=lvl_bg_indexes.maxID(); i++)
+    {
+        if(!lvl_bg_indexes.contains(i)) continue;
+        lvl_bg_indexes[i].second_isInit = false;
+        lvl_bg_indexes[i].second_image = NULL;
+        lvl_bg_indexes[i].second_textureArrayId = 0;
+        lvl_bg_indexes[i].second_animator_ID = 0;
+    }
+
+    total_data += lvl_block_indexes.size() + lvl_bgo_indexes.size() + lvl_bg_indexes.size();
+    return true;
+}
+
+void ConfigManager::saveLevelSettingsCache(const QByteArray &stamp)
+{
+    QDir().mkpath(ApplicationPath + "/cache");
+
+    QSaveFile file(levelSettingsCacheFile());
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Can't write config cache" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << QByteArray(levelCacheMagic) << levelCacheVersion << stamp;
+    writeIndex(out, lvl_block_indexes, &writeBlock);
+    writeIndex(out, lvl_bgo_indexes, &writeBgo);
+    writeIndex(out, lvl_bg_indexes, &writeBG);
+
+    if(!file.commit())
+        qWarning() << "Can't write config cache" << file.fileName() << file.errorString();
+}
+
+bool ConfigManager::loadLevelSettings()
+{
+    QByteArray stamp = levelSettingsStamp();
+
+    //Settings are already loaded and INI-files are not changed since
+    if(!level_settings_stamp.isEmpty() && (level_settings_stamp==stamp))
+        return true;
+
+    level_settings_stamp.clear();
+
+    if(loadLevelSettingsCache(stamp))
+    {
+        level_settings_stamp = stamp;
+        return true;
+    }
+
+    bool success = true;
+    success = loadLevelBlocks() && success; //!< Blocks
+    success = loadLevelBGO() && success;    //!< BGO
+    success = loadLevelBackG() && success;  //!< Backgrounds
+
+    if(success)
+    {
+        level_settings_stamp = stamp;
+        saveLevelSettingsCache(stamp);
+    }
+    return success;
+}
@@ -0,0 +1,91 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONFIG_INDEX_H
+#define CONFIG_INDEX_H
+
+#include <QVector>
+
+/*!
+ * \brief Dense table of config items where element position is an item ID
+ *
+ * Items of config packs have sequential IDs from 1 to total, so plain array
+ * gives constant time lookup. Storage is allocated once per loading,
+ * pointers to items are stable until next allocate() or clear().
+ */
+template<class T>
+class ConfigIndex
+{
+public:
+    void allocate(long maxID)
+    {
+        items.clear();
+        exists.clear();
+        if(maxID<0) maxID=0;
+        items.resize(maxID+1);
+        exists.fill(false, maxID+1);
+        count=0;
+    }
+
+    void insert(long id, const T &item)
+    {
+        if(id<0) return;
+        if(id>=items.size())
+        {
+            items.resize(id+1);
+            exists.resize(id+1);
+        }
+        if(!exists[id]) count++;
+        items[id] = item;
+        exists[id] = true;
+    }
+
+    inline bool contains(long id) const
+    {
+        return (id>=0) && (id<exists.size()) && exists[id];
+    }
+
+    inline T &operator[](long id)
+    {
+        return items[id];
+    }
+
+    inline const T &operator[](long id) const
+    {
+        return items[id];
+    }
+
+    void clear()
+    {
+        items.clear();
+        exists.clear();
+        count=0;
+    }
+
+    //! Number of existing items
+    inline int size() const { return count; }
+    //! Biggest possible ID
+    inline long maxID() const { return items.size()-1; }
+
+private:
+    QVector<T> items;
+    QVector<bool> exists;
+    int count = 0;
+};
+
+#endif // CONFIG_INDEX_H
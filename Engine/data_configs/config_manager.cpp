@@ -20,6 +20,7 @@
 #include "config_manager.h"
 
 #include "../common_features/graphics_funcs.h"
+#include "../common_features/texture_cache.h"
 
 #include <QMessageBox>
 #include <QDir>
@@ -43,6 +44,9 @@ unsigned int ConfigManager::screen_height=600;
 
 ConfigManager::screenType ConfigManager::screen_type = ConfigManager::SCR_Static;
 
+int ConfigManager::npc_activation_time=3000;
+int ConfigManager::npc_activation_padding=128;
+
 //Loading Screen setings
 LoadingScreenData ConfigManager::LoadingScreen;
 
@@ -199,6 +203,11 @@ bool ConfigManager::loadBasics()
             screen_type = SCR_Static;
     engineset.endGroup();
 
+    engineset.beginGroup("level");
+        npc_activation_time = engineset.value("npc-activation-time", 3000).toInt();
+        npc_activation_padding = engineset.value("npc-activation-padding", 128).toInt();
+    engineset.endGroup();
+
 
 
     ////// World map settings
@@ -292,57 +301,74 @@ void ConfigManager::addError(QString bug, QtMsgType level)
 bool ConfigManager::unloadLevelConfigs()
 {
 
-    ///Clear texture bank
+    ///Clear texture bank, textures are staying in the cache for next level
     while(!level_textures.isEmpty())
     {
-        glDisable(GL_TEXTURE_2D);
-        glDeleteTextures( 1, &(level_textures.last().texture) );
+        TextureCache::release(level_textures.last().texture);
         level_textures.pop_back();
     }
+    TextureCache::trim();
+    TextureCache::clearDecoded();
 
 
 
     /***************Clear animators*************/
-//    foreach(SimpleAnimator x, Animator_Blocks)
-//        x->stop();
-    Animator_Blocks.clear();
-//    while(!Animator_Blocks.isEmpty())
-//    {
-//        SimpleAnimator * x = Animator_Blocks.first();
-//        Animator_Blocks.pop_front();
-//        delete x;
-//    }
-
-
-//    foreach(SimpleAnimator * x, Animator_BGO)
-//        x->stop();
-    Animator_BGO.clear();
-//    while(!Animator_BGO.isEmpty())
-//    {
-//        SimpleAnimator * x = Animator_BGO.first();
-//        Animator_BGO.pop_front();
-//        delete x;
-//    }
-
-//    foreach(SimpleAnimator * x, Animator_BG)
-//        x->stop();
-    Animator_BG.clear();
-//    while(!Animator_BG.isEmpty())
-//    {
-//        SimpleAnimator * x = Animator_BG.first();
-//        Animator_BG.pop_front();
-//        delete x;
-//    }
-
-    /***************Clear settings*************/
-    lvl_block_indexes.clear();
-    lvl_blocks.clear();
-
-    lvl_bgo_indexes.clear();
-    lvl_bgo.clear();
-
-    lvl_bg_indexes.clear();
-    lvl_bg.clear();
+    while(!Animator_Blocks.isEmpty())
+    {
+        SimpleAnimator * x = Animator_Blocks.last();
+        Animator_Blocks.pop_back();
+        delete x;
+    }
+
+    while(!Animator_BGO.isEmpty())
+    {
+        SimpleAnimator * x = Animator_BGO.last();
+        Animator_BGO.pop_back();
+        delete x;
+    }
+
+    while(!Animator_BG.isEmpty())
+    {
+        SimpleAnimator * x = Animator_BG.last();
+        Animator_BG.pop_back();
+        delete x;
+    }
+
+    /***************Reset textures of settings*************/
+    //Settings are staying loaded for next level, only links to textures are dropped
+    for(long i=0; i<=lvl_block_indexes.maxID(); i++)
+    {
+        if(!lvl_block_indexes.contains(i)) continue;
+        obj_block &block = lvl_block_indexes[i];
+        block.isInit = false;
+        block.image = NULL;
+        block.textureArrayId = 0;
+        block.animator_ID = 0;
+    }
+
+    for(long i=0; i<=lvl_bgo_indexes.maxID(); i++)
+    {
+        if(!lvl_bgo_indexes.contains(i)) continue;
+        obj_bgo &bgo = lvl_bgo_indexes[i];
+        bgo.isInit = false;
+        bgo.image = NULL;
+        bgo.textureArrayId = 0;
+        bgo.animator_ID = 0;
+    }
+
+    for(long i=0; i<=lvl_bg_indexes.maxID(); i++)
+    {
+        if(!lvl_bg_indexes.contains(i)) continue;
+        obj_BG &bg = lvl_bg_indexes[i];
+        bg.isInit = false;
+        bg.image = NULL;
+        bg.textureArrayId = 0;
+        bg.animator_ID = 0;
+        bg.second_isInit = false;
+        bg.second_image = NULL;
+        bg.second_textureArrayId = 0;
+        bg.second_animator_ID = 0;
+    }
 
     //level_textures.clear();
     return true;
@@ -26,6 +26,7 @@
 #include "obj_block.h"
 #include "obj_bgo.h"
 #include "obj_bg.h"
+#include "config_index.h"
 
 
 #include <QMap>
@@ -151,6 +152,10 @@ public:
     };
     static screenType screen_type;
 
+    //Level settings
+    static int npc_activation_time;    //!< Milliseconds of life of NPC out of cameras
+    static int npc_activation_padding; //!< Expansion of camera rectangle where NPCs are waked
+
     //LoadingScreen
     static LoadingScreenData LoadingScreen;
 
@@ -171,6 +176,8 @@ public:
     //Load settings
     static bool loadBasics();
     static bool unloadLevelConfigs();
+    //! Loads level items configs from binary cache or from INI-files if they was changed
+    static bool loadLevelSettings();
 
 
     //Level config Data
@@ -179,20 +186,18 @@ public:
     static bool loadLevelBlocks();
     static long getBlockTexture(long blockID);
     /*****************************/
-    static QVector<obj_block >     lvl_blocks;
-    static QMap<long, obj_block>   lvl_block_indexes;
+    static ConfigIndex<obj_block > lvl_block_indexes;
     static CustomDirManager Dir_Blocks;
-    static QVector<SimpleAnimator > Animator_Blocks;
+    static QVector<SimpleAnimator * > Animator_Blocks;
     /*****Level blocks************/
 
     /*****Level BGO************/
     static bool loadLevelBGO();
     static long getBgoTexture(long bgoID);
     /*****************************/
-    static QVector<obj_bgo >     lvl_bgo;
-    static QMap<long, obj_bgo>   lvl_bgo_indexes;
+    static ConfigIndex<obj_bgo >   lvl_bgo_indexes;
     static CustomDirManager Dir_BGO;
-    static QVector<SimpleAnimator > Animator_BGO;
+    static QVector<SimpleAnimator * > Animator_BGO;
     /*****Level BGO************/
 
 
@@ -200,10 +205,9 @@ public:
     static bool loadLevelBackG();
     static long getBGTexture(long bgID, bool isSecond=false);
     /*****************************/
-    static QVector<obj_BG >     lvl_bg;
-    static QMap<long, obj_BG>   lvl_bg_indexes;
+    static ConfigIndex<obj_BG >    lvl_bg_indexes;
     static CustomDirManager Dir_BG;
-    static QVector<SimpleAnimator > Animator_BG;
+    static QVector<SimpleAnimator * > Animator_BG;
     /*****Level Backgrounds************/
 
 
@@ -255,6 +259,12 @@ private:
 
     static QString commonGPath;
 
+    //Level settings cache
+    static QByteArray levelSettingsStamp();
+    static QString levelSettingsCacheFile();
+    static bool loadLevelSettingsCache(const QByteArray &stamp);
+    static void saveLevelSettingsCache(const QByteArray &stamp);
+    static QByteArray level_settings_stamp; //!< Stamp of currently loaded INI-files
 
 };
 
@@ -18,6 +18,7 @@
 
 #include "config_manager.h"
 #include "../common_features/graphics_funcs.h"
+#include "../common_features/texture_cache.h"
 
 long  ConfigManager::getBlockTexture(long blockID)
 {
@@ -39,24 +40,11 @@ long  ConfigManager::getBlockTexture(long blockID)
         QString imgFile = Dir_Blocks.getCustomFile(lvl_block_indexes[blockID].image_n);
         QString maskFile = Dir_Blocks.getCustomFile(lvl_block_indexes[blockID].mask_n);
 
-        PGE_Texture texture;
-        texture.w = 0;
-        texture.h = 0;
-        texture.texture = 0;
-        texture.texture_layout = NULL;
-        texture.format = 0;
-        texture.nOfColors = 0;
-
         long id = level_textures.size();
 
         lvl_block_indexes[blockID].textureArrayId = id;
 
-        level_textures.push_back(texture);
-
-        GraphicsHelps::loadTexture( level_textures[id],
-             imgFile,
-             maskFile
-             );
+        level_textures.push_back(TextureCache::acquire(imgFile, maskFile));
 
         lvl_block_indexes[blockID].image = &(level_textures[id]);
         lvl_block_indexes[blockID].textureID = level_textures[id].texture;
@@ -107,7 +95,8 @@ long  ConfigManager::getBlockTexture(long blockID)
                             lvl_block_indexes[blockID].animation_bid
                         );
 
-            Animator_Blocks.push_back(animator);
+            //Running timers are keeping address of animator, so it must not be moved
+            Animator_Blocks.push_back(new SimpleAnimator(animator));
             lvl_block_indexes[blockID].animator_ID = Animator_Blocks.size()-1;
 
         }
@@ -143,24 +132,11 @@ long  ConfigManager::getBgoTexture(long bgoID)
         QString imgFile = Dir_BGO.getCustomFile(lvl_bgo_indexes[bgoID].image_n);
         QString maskFile = Dir_BGO.getCustomFile(lvl_bgo_indexes[bgoID].mask_n);
 
-        PGE_Texture texture;
-        texture.w = 0;
-        texture.h = 0;
-        texture.texture = 0;
-        texture.texture_layout = NULL;
-        texture.format = 0;
-        texture.nOfColors = 0;
-
         long id = level_textures.size();
 
         lvl_bgo_indexes[bgoID].textureArrayId = id;
 
-        level_textures.push_back(texture);
-
-        GraphicsHelps::loadTexture( level_textures[id],
-             imgFile,
-             maskFile
-             );
+        level_textures.push_back(TextureCache::acquire(imgFile, maskFile));
 
         lvl_bgo_indexes[bgoID].image = &(level_textures[id]);
         lvl_bgo_indexes[bgoID].textureID = level_textures[id].texture;
@@ -190,7 +166,7 @@ long  ConfigManager::getBgoTexture(long bgoID)
                             false
                         );
 
-            Animator_BGO.push_back(animator);
+            Animator_BGO.push_back(new SimpleAnimator(animator));
             lvl_bgo_indexes[bgoID].animator_ID = Animator_BGO.size()-1;
 
         }
@@ -242,14 +218,6 @@ long  ConfigManager::getBGTexture(long bgID, bool isSecond)
         else
             imgFile = Dir_BG.getCustomFile(lvl_bg_indexes[bgID].image_n);
 
-        PGE_Texture texture;
-        texture.w = 0;
-        texture.h = 0;
-        texture.texture = 0;
-        texture.texture_layout = NULL;
-        texture.format = 0;
-        texture.nOfColors = 0;
-
         long id = level_textures.size();
 
         if(isSecond)
@@ -257,9 +225,7 @@ long  ConfigManager::getBGTexture(long bgID, bool isSecond)
         else
             lvl_bg_indexes[bgID].textureArrayId = id;
 
-        level_textures.push_back(texture);
-
-        GraphicsHelps::loadTexture( level_textures[id], imgFile );
+        level_textures.push_back(TextureCache::acquire(imgFile));
 
         if(isSecond)
         {
@@ -302,7 +268,7 @@ long  ConfigManager::getBGTexture(long bgID, bool isSecond)
                             false
                         );
 
-            Animator_BG.push_back(animator);
+            Animator_BG.push_back(new SimpleAnimator(animator));
             lvl_bg_indexes[bgID].animator_ID = Animator_BG.size()-1;
         }
 
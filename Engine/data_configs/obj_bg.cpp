@@ -22,10 +22,9 @@
 
 
 /*****Level BG************/
-QVector<obj_BG >     ConfigManager::lvl_bg;
-QMap<long, obj_BG>   ConfigManager::lvl_bg_indexes;
+ConfigIndex<obj_BG >    ConfigManager::lvl_bg_indexes;
 CustomDirManager ConfigManager::Dir_BG;
-QVector<SimpleAnimator > ConfigManager::Animator_BG;
+QVector<SimpleAnimator * > ConfigManager::Animator_BG;
 /*****Level BG************/
 
 bool ConfigManager::loadLevelBackG()
@@ -45,18 +44,19 @@ bool ConfigManager::loadLevelBackG()
     QSettings bgset(bg_ini, QSettings::IniFormat);
     bgset.setIniCodec("UTF-8");
 
-    lvl_bg.clear();   //Clear old
-    lvl_bg_indexes.clear();
+    lvl_bg_indexes.clear();   //Clear old
 
     bgset.beginGroup("background2-main");
         bg_total = bgset.value("total", "0").toInt();
         total_data +=bg_total;
     bgset.endGroup();
 
+    lvl_bg_indexes.allocate(bg_total);
+
     QStringList tmp;
     for(i=1; i<=bg_total; i++)
     {
-
+        sbg = obj_BG();
         sbg.isInit = false;
         sbg.image = NULL;
         sbg.textureArrayId = 0;
@@ -157,10 +157,9 @@ bool ConfigManager::loadLevelBackG()
 
 
             sbg.id = i;
-            lvl_bg.push_back(sbg);
 
             //Add to Index
-            lvl_bg_indexes[lvl_bg.last().id] = lvl_bg.last();
+            lvl_bg_indexes.insert(sbg.id, sbg);
 
         skipBG:
         bgset.endGroup();
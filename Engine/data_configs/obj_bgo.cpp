@@ -18,12 +18,12 @@
 
 #include "config_manager.h"
 #include "../gui/pge_msgbox.h"
+#include "../graphics/gl_renderer.h"
 
 /*****Level BGO************/
-QVector<obj_bgo >     ConfigManager::lvl_bgo;
-QMap<long, obj_bgo>   ConfigManager::lvl_bgo_indexes;
+ConfigIndex<obj_bgo >   ConfigManager::lvl_bgo_indexes;
 CustomDirManager ConfigManager::Dir_BGO;
-QVector<SimpleAnimator > ConfigManager::Animator_BGO;
+QVector<SimpleAnimator * > ConfigManager::Animator_BGO;
 /*****Level BGO************/
 
 bool ConfigManager::loadLevelBGO()
@@ -37,27 +37,30 @@ bool ConfigManager::loadLevelBGO()
     if(!QFile::exists(bgo_ini))
     {
         addError(QString("ERROR LOADING lvl_bgo.ini: file does not exist"), QtCriticalMsg);
-        PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_bgo.ini: file does not exist"),
-                          PGE_MsgBox::msg_fatal);
-        msgBox.exec();
+        if(!GlRenderer::isHeadless()) //Error is already logged
+        {
+            PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_bgo.ini: file does not exist"),
+                              PGE_MsgBox::msg_fatal);
+            msgBox.exec();
+        }
         return false;
     }
 
     QSettings bgoset(bgo_ini, QSettings::IniFormat);
     bgoset.setIniCodec("UTF-8");
 
-    lvl_bgo.clear();   //Clear old
-    lvl_bgo_indexes.clear();
+    lvl_bgo_indexes.clear();   //Clear old
 
     bgoset.beginGroup("background-main");
         bgo_total = bgoset.value("total", "0").toInt();
         total_data +=bgo_total;
     bgoset.endGroup();
 
+    lvl_bgo_indexes.allocate(bgo_total);
 
     for(i=1; i<=bgo_total; i++)
     {
-
+        sbgo = obj_bgo();
         sbgo.isInit = false;
         sbgo.image = NULL;
         sbgo.textureArrayId = 0;
@@ -122,10 +125,9 @@ bool ConfigManager::loadLevelBGO()
 
             sbgo.display_frame = bgoset.value("display-frame", "0").toInt();
             sbgo.id = i;
-            lvl_bgo.push_back(sbgo);
 
             //Add to Index
-            lvl_bgo_indexes[lvl_bgo.last().id] = lvl_bgo.last();
+            lvl_bgo_indexes.insert(sbgo.id, sbgo);
 
         skipBGO:
         bgoset.endGroup();
@@ -136,12 +138,15 @@ bool ConfigManager::loadLevelBGO()
         }
     }
 
-    if((unsigned int)lvl_bgo.size()<bgo_total)
+    if((unsigned int)lvl_bgo_indexes.size()<bgo_total)
     {
-        addError(QString("Not all BGOs loaded! Total: %1, Loaded: %2").arg(bgo_total).arg(lvl_bgo.size()));
-        PGE_MsgBox msgBox(NULL, QString("Not all BGOs loaded! Total: %1, Loaded: %2").arg(bgo_total).arg(lvl_bgo.size()),
-                          PGE_MsgBox::msg_error);
-        msgBox.exec();
+        addError(QString("Not all BGOs loaded! Total: %1, Loaded: %2").arg(bgo_total).arg(lvl_bgo_indexes.size()));
+        if(!GlRenderer::isHeadless()) //Error is already logged
+        {
+            PGE_MsgBox msgBox(NULL, QString("Not all BGOs loaded! Total: %1, Loaded: %2").arg(bgo_total).arg(lvl_bgo_indexes.size()),
+                              PGE_MsgBox::msg_error);
+            msgBox.exec();
+        }
     }
     return true;
 }
@@ -18,12 +18,12 @@
 
 #include "config_manager.h"
 #include "../gui/pge_msgbox.h"
+#include "../graphics/gl_renderer.h"
 
 /*****Level blocks************/
-QVector<obj_block >     ConfigManager::lvl_blocks;
-QMap<long, obj_block>   ConfigManager::lvl_block_indexes;
+ConfigIndex<obj_block > ConfigManager::lvl_block_indexes;
 CustomDirManager ConfigManager::Dir_Blocks;
-QVector<SimpleAnimator > ConfigManager::Animator_Blocks;
+QVector<SimpleAnimator * > ConfigManager::Animator_Blocks;
 /*****Level blocks************/
 
 namespace loadLevelBlocks_fnc
@@ -46,17 +46,19 @@ bool ConfigManager::loadLevelBlocks()
     if(!QFile::exists(block_ini))
     {
         addError(QString("ERROR LOADING lvl_blocks.ini: file does not exist"), QtCriticalMsg);
-        PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini: file does not exist"),
-                          PGE_MsgBox::msg_fatal);
-        msgBox.exec();
+        if(!GlRenderer::isHeadless()) //Error is already logged
+        {
+            PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini: file does not exist"),
+                              PGE_MsgBox::msg_fatal);
+            msgBox.exec();
+        }
         return false;
     }
 
     QSettings blockset(block_ini, QSettings::IniFormat);
     blockset.setIniCodec("UTF-8");
 
-    lvl_blocks.clear();   //Clear old
-    lvl_block_indexes.clear();
+    lvl_block_indexes.clear();   //Clear old
 
     blockset.beginGroup("blocks-main");
         block_total = blockset.value("total", "0").toInt();
@@ -68,17 +70,21 @@ bool ConfigManager::loadLevelBlocks()
     if(block_total==0)
     {
         addError(QString("ERROR LOADING lvl_blocks.ini: number of items not define, or empty config"), QtCriticalMsg);
-        PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini: number of items not define, or empty config"),
-                          PGE_MsgBox::msg_fatal);
-        msgBox.exec();
+        if(!GlRenderer::isHeadless()) //Error is already logged
+        {
+            PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini: number of items not define, or empty config"),
+                              PGE_MsgBox::msg_fatal);
+            msgBox.exec();
+        }
 
         return false;
     }
 
+    lvl_block_indexes.allocate(block_total);
 
         for(i=1; i<=block_total; i++)
         {
-
+            sblock = obj_block();
             sblock.isInit=false;
             sblock.image = NULL;
             sblock.textureArrayId = 0;
@@ -189,10 +195,9 @@ bool ConfigManager::loadLevelBlocks()
                 sblock.default_content_value = (iTmp>=0) ? (iTmp<1000? iTmp*-1 : iTmp-1000) : 0;
 
                 sblock.id = i;
-                lvl_blocks.push_back(sblock);
 
                 //Add to Index
-                lvl_block_indexes[lvl_blocks.last().id] = lvl_blocks.last();
+                lvl_block_indexes.insert(sblock.id, sblock);
 
             skipBLOCK:
             blockset.endGroup();
@@ -201,17 +206,20 @@ bool ConfigManager::loadLevelBlocks()
           {
             addError(QString("ERROR LOADING lvl_blocks.ini N:%1 (block-%2)").arg(blockset.status()).arg(i), QtCriticalMsg);
 
-            PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini N:%1 (block-%2)").arg(blockset.status()).arg(i),
-                              PGE_MsgBox::msg_error);
-            msgBox.exec();
+            if(!GlRenderer::isHeadless()) //Error is already logged
+            {
+                PGE_MsgBox msgBox(NULL, QString("ERROR LOADING lvl_blocks.ini N:%1 (block-%2)").arg(blockset.status()).arg(i),
+                                  PGE_MsgBox::msg_error);
+                msgBox.exec();
+            }
 
              break;
           }
        }
 
-       if((unsigned int)lvl_blocks.size()<block_total)
+       if((unsigned int)lvl_block_indexes.size()<block_total)
        {
-           addError(QString("Not all blocks loaded! Total: %1, Loaded: %2)").arg(block_total).arg(lvl_blocks.size()), QtWarningMsg);
+           addError(QString("Not all blocks loaded! Total: %1, Loaded: %2)").arg(block_total).arg(lvl_block_indexes.size()), QtWarningMsg);
        }
 
        return true;
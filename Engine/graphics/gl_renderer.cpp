@@ -31,9 +31,108 @@
 #include <QDateTime>
 #include <QMessageBox>
 #include <QGLWidget>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
 #include <QtDebug>
+#include <cstring>
 
 bool GlRenderer::_isReady=false;
+bool GlRenderer::_isHeadless=false;
+bool GlRenderer::_shotRequested=false;
+bool GlRenderer::_isRecording=false;
+QString GlRenderer::_recordPath="";
+int GlRenderer::_recordFrame=0;
+
+//Pixel buffer objects (OpenGL 2.1 or ARB_pixel_buffer_object) let glReadPixels
+//return immediately, frame is taken from the buffer on the next captureFrame() call
+static PFNGLGENBUFFERSPROC    pge_glGenBuffers = NULL;
+static PFNGLDELETEBUFFERSPROC pge_glDeleteBuffers = NULL;
+static PFNGLBINDBUFFERPROC    pge_glBindBuffer = NULL;
+static PFNGLBUFFERDATAPROC    pge_glBufferData = NULL;
+static PFNGLMAPBUFFERPROC     pge_glMapBuffer = NULL;
+static PFNGLUNMAPBUFFERPROC   pge_glUnmapBuffer = NULL;
+
+static bool    pboSupported = false;
+static bool    vboSupported = false; //Vertex buffer objects (OpenGL 1.5 or ARB_vertex_buffer_object)
+static GLuint  pbo[2] = {0, 0};
+static int     pboWidth = 0;
+static int     pboHeight = 0;
+static int     pboIndex = 0; //Buffer which receives next frame
+static bool    pboPending[2] = {false, false};
+static QString pboTarget[2];
+static int     pboQuality[2] = {-1, -1};
+
+//Frames are flipped and encoded in background.
+//When writers can't keep up, game waits for them: recorded frames are never dropped
+static QThreadPool frameWriters;
+static QSemaphore  frameSlots(16);
+
+class FrameWriter : public QRunnable
+{
+public:
+    FrameWriter(const QImage &frame, const QString &path, int quality)
+        : frame(frame), path(path), quality(quality) {}
+
+    void run()
+    {
+        //OpenGL rows are bottom-up. Alpha of framebuffer is not meaningful,
+        //but Format_RGB32 ignores it, so rows are copied as is
+        QImage image(frame.width(), frame.height(), QImage::Format_RGB32);
+        int rowSize = qMin(frame.bytesPerLine(), image.bytesPerLine());
+        for(int y=0; y<frame.height(); y++)
+            memcpy(image.scanLine(y), frame.constScanLine(frame.height()-1-y), size_t(rowSize));
+
+        if(!image.save(path, "PNG", quality))
+            qDebug() << "Can't save frame" << path;
+        frameSlots.release();
+    }
+
+private:
+    QImage frame;
+    QString path;
+    int quality;
+};
+
+static void writeFrame(const QImage &frame, const QString &path, int quality)
+{
+    frameSlots.acquire();
+    frameWriters.start(new FrameWriter(frame, path, quality));
+}
+
+static void initBuffers()
+{
+    pge_glGenBuffers    = (PFNGLGENBUFFERSPROC)SDL_GL_GetProcAddress("glGenBuffers");
+    pge_glDeleteBuffers = (PFNGLDELETEBUFFERSPROC)SDL_GL_GetProcAddress("glDeleteBuffers");
+    pge_glBindBuffer    = (PFNGLBINDBUFFERPROC)SDL_GL_GetProcAddress("glBindBuffer");
+    pge_glBufferData    = (PFNGLBUFFERDATAPROC)SDL_GL_GetProcAddress("glBufferData");
+    pge_glMapBuffer     = (PFNGLMAPBUFFERPROC)SDL_GL_GetProcAddress("glMapBuffer");
+    pge_glUnmapBuffer   = (PFNGLUNMAPBUFFERPROC)SDL_GL_GetProcAddress("glUnmapBuffer");
+
+    bool haveBuffers = pge_glGenBuffers && pge_glDeleteBuffers && pge_glBindBuffer && pge_glBufferData;
+
+    vboSupported = haveBuffers && SDL_GL_ExtensionSupported("GL_ARB_vertex_buffer_object");
+
+    pboSupported = haveBuffers && pge_glMapBuffer && pge_glUnmapBuffer &&
+                   SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object");
+    if(pboSupported)
+        pge_glGenBuffers(2, pbo);
+}
+
+static void readPBO(int slot)
+{
+    pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+    const uchar *src = reinterpret_cast<const uchar*>(pge_glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+    if(src)
+    {
+        QImage frame(pboWidth, pboHeight, QImage::Format_RGB32);
+        memcpy(frame.bits(), src, size_t(frame.byteCount()));
+        pge_glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        writeFrame(frame, pboTarget[slot], pboQuality[slot]);
+    }
+    pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    pboPending[slot] = false;
+}
 
 bool GlRenderer::init()
 {
@@ -87,6 +186,7 @@ bool GlRenderer::init()
     SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
     ScreenshotPath = ApplicationPath+"/screenshots/";
+    initBuffers();
     _isReady=true;
 
     return true;
@@ -94,7 +194,48 @@ bool GlRenderer::init()
 
 bool GlRenderer::uninit()
 {
-    return false;
+    if(!_isReady) return false;
+
+    if(_isRecording) toggleRecording();
+    finishReadback();
+    frameWriters.waitForDone();
+
+    if(pboSupported)
+        pge_glDeleteBuffers(2, pbo);
+    pboSupported = false;
+    vboSupported = false;
+    _isReady=false;
+    return true;
+}
+
+bool GlRenderer::vertexBuffersSupported()
+{
+    return vboSupported && !_isHeadless;
+}
+
+unsigned int GlRenderer::createVertexBuffer(const void *data, long size)
+{
+    if(!vertexBuffersSupported())
+        return 0;
+
+    GLuint buffer = 0;
+    pge_glGenBuffers(1, &buffer);
+    pge_glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    pge_glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+    pge_glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+void GlRenderer::deleteVertexBuffer(unsigned int buffer)
+{
+    if(buffer && vboSupported)
+        pge_glDeleteBuffers(1, &buffer);
+}
+
+void GlRenderer::bindVertexBuffer(unsigned int buffer)
+{
+    if(vboSupported)
+        pge_glBindBuffer(GL_ARRAY_BUFFER, buffer);
 }
 
 QPointF GlRenderer::mapToOpengl(QPoint s)
@@ -106,40 +247,126 @@ QPointF GlRenderer::mapToOpengl(QPoint s)
 
 QString GlRenderer::ScreenshotPath = "";
 
+QString GlRenderer::timestamp()
+{
+    QDate date = QDate::currentDate();
+    QTime time = QTime::currentTime();
+    return QString("%1_%2_%3_%4_%5_%6_%7")
+            .arg(date.year()).arg(date.month()).arg(date.day())
+            .arg(time.hour()).arg(time.minute()).arg(time.second()).arg(time.msec());
+}
+
 void GlRenderer::makeShot()
 {
     if(!_isReady) return;
 
-    // Make the BYTE array, factor of 3 because it's RBG.
-    uchar* pixels = new uchar[ 3 * PGE_Window::Width * PGE_Window::Height];
-    glReadPixels(0, 0, PGE_Window::Width, PGE_Window::Height, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    if(!QDir(ScreenshotPath).exists()) QDir().mkdir(ScreenshotPath);
+    _shotRequested = true;
+}
 
-    QImage shotImg = QImage(PGE_Window::Width, PGE_Window::Height, QImage::Format_ARGB32);
-    shotImg.fill(Qt::black);
+void GlRenderer::toggleRecording()
+{
+    if(!_isReady) return;
 
-    for(int i=0, x=0, y=PGE_Window::Height-1; i<3*PGE_Window::Width*PGE_Window::Height; i+=3, x++)
+    if(_isRecording)
     {
-        if(x==PGE_Window::Width) {x=0; y--;}
-        shotImg.setPixel( QPoint(x,y), qRgb(pixels[i],pixels[i+1], pixels[i+2]) );
+        _isRecording = false;
+        finishReadback();
+        qDebug() << "Recording stopped:" << _recordFrame << "frames in" << _recordPath;
+        return;
     }
 
-    if(!QDir(ScreenshotPath).exists()) QDir().mkdir(ScreenshotPath);
+    _recordPath = QString("%1Rec_%2/").arg(ScreenshotPath).arg(timestamp());
+    QDir().mkpath(_recordPath);
+    _recordFrame = 0;
+    _isRecording = true;
+    qDebug() << "Recording started:" << _recordPath;
+}
 
-    QDate date = QDate::currentDate();
-    QTime time = QTime::currentTime();
+bool GlRenderer::isRecording()
+{
+    return _isRecording;
+}
 
-    QString saveTo = QString("%1Scr_%2_%3_%4_%5_%6_%7_%8.png").arg(ScreenshotPath)
-            .arg(date.year()).arg(date.month()).arg(date.day())
-            .arg(time.hour()).arg(time.minute()).arg(time.second()).arg(time.msec());
+void GlRenderer::captureFrame()
+{
+    if(!_isReady) return;
+
+    QString saveTo;
+    int quality = -1;
+    if(_isRecording)
+    {
+        //Fast zlib level: PNG stays lossless for comparison of frames
+        saveTo = QString("%1frame_%2.png").arg(_recordPath).arg(_recordFrame++, 6, 10, QChar('0'));
+        quality = 80;
+    }
+    else if(_shotRequested)
+        saveTo = QString("%1Scr_%2.png").arg(ScreenshotPath).arg(timestamp());
+    _shotRequested = false;
+
+    int w = PGE_Window::Width;
+    int h = PGE_Window::Height;
+
+    if(!pboSupported)
+    {
+        if(saveTo.isEmpty()) return;
+        QImage frame(w, h, QImage::Format_RGB32);
+        glReadPixels(0, 0, w, h, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, frame.bits());
+        writeFrame(frame, saveTo, quality);
+        return;
+    }
 
-    qDebug() << saveTo << shotImg.width() << shotImg.height() << pixels[0];
+    if(saveTo.isEmpty() && !pboPending[0] && !pboPending[1])
+        return;
 
-    shotImg.save(saveTo, "PNG");
+    if((pboWidth != w) || (pboHeight != h))
+    {
+        finishReadback();
+        for(int i=0; i<2; i++)
+        {
+            pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+            pge_glBufferData(GL_PIXEL_PACK_BUFFER, w*h*4, NULL, GL_STREAM_READ);
+        }
+        pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        pboWidth = w;
+        pboHeight = h;
+    }
+
+    if(!saveTo.isEmpty())
+    {
+        pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[pboIndex]);
+        glReadPixels(0, 0, w, h, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, 0);
+        pge_glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        pboPending[pboIndex] = true;
+        pboTarget[pboIndex] = saveTo;
+        pboQuality[pboIndex] = quality;
+    }
 
-    delete [] pixels;
+    //Previous frame is already transferred while this one was rendered
+    pboIndex ^= 1;
+    if(pboPending[pboIndex])
+        readPBO(pboIndex);
+}
+
+void GlRenderer::finishReadback()
+{
+    if(!pboSupported) return;
+    //Older frame first
+    if(pboPending[pboIndex]) readPBO(pboIndex);
+    if(pboPending[pboIndex^1]) readPBO(pboIndex^1);
 }
 
 bool GlRenderer::ready()
 {
     return _isReady;
 }
+
+void GlRenderer::setHeadless(bool headless)
+{
+    _isHeadless = headless;
+}
+
+bool GlRenderer::isHeadless()
+{
+    return _isHeadless;
+}
@@ -31,10 +31,36 @@ public:
     static QPointF mapToOpengl(QPoint s);
 
     static QString ScreenshotPath;
+    //! Screenshot of next frame will be taken by captureFrame()
     static void makeShot();
+    //! Starts or stops writing of every frame into Rec_<date> folder of screenshots
+    static void toggleRecording();
+    static bool isRecording();
+    //! Reads back rendered frame if requested, must be called before swapping of buffers
+    static void captureFrame();
     static bool ready();
+
+    //! Work without window and OpenGL context: textures are only decoded
+    static void setHeadless(bool headless);
+    static bool isHeadless();
+
+    //! Static geometry can be stored in video memory
+    static bool vertexBuffersSupported();
+    //! Returns 0 if vertex buffers are not supported, geometry should be drawn from client memory
+    static unsigned int createVertexBuffer(const void *data, long size);
+    static void deleteVertexBuffer(unsigned int buffer);
+    //! 0 - unbind buffer
+    static void bindVertexBuffer(unsigned int buffer);
 private:
     static bool _isReady;
+    static bool _isHeadless;
+    static bool _shotRequested;
+    static bool _isRecording;
+    static QString _recordPath;
+    static int _recordFrame;
+
+    static QString timestamp();
+    static void finishReadback();
 };
 
 #endif // GL_RENDERER_H
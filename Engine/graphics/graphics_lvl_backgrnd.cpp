@@ -45,6 +45,10 @@ void LVL_Background::construct()
     isAnimated = false;
     isMagic = false;
     animator_ID = 0;
+    setup = NULL;
+    geometryValid = false;
+    geometryWidth = 0;
+    geometryHeight = 0;
     glClearColor(color.r, color.g, color.b, 1.0f);
 }
 
@@ -57,6 +61,7 @@ LVL_Background::~LVL_Background()
 void LVL_Background::setBg(obj_BG &bg)
 {
     setup = &bg;
+    geometryValid = false;
 
     bgType = (type)bg.type;
 
@@ -173,6 +178,7 @@ void LVL_Background::setBg(obj_BG &bg)
 void LVL_Background::setNone()
 {
     setup = NULL;
+    geometryValid = false;
     color.r = 0.0f;
     color.g = 0.0f;
     color.b = 0.0f;
@@ -266,99 +272,50 @@ void LVL_Background::draw(float x, float y)
         //PGE_Window::Height
         //pos_y
 
-        QRectF backgrndG;
-        //draw!
-
+        if(!geometryValid || (geometryWidth != PGE_Window::Width) || (geometryHeight != PGE_Window::Height))
+            buildGeometry();
 
-        AniPos ani_x(0,1);
+        //draw!
+        if(bgType==tiled)
+            imgPos_Y -= txData1.h * ( (setup->attached==0)? -1 : 1 );
 
-        if(isAnimated) //Get current animated frame
-            ani_x = ConfigManager::Animator_BG[animator_ID].image();
-        int lenght=0;
-        int lenght_v=0;
-        //for Tiled repeats
-        int verticalRepeats=1;
+        glColor4f( 1.f, 1.f, 1.f, 1.f);
+        glEnable(GL_TEXTURE_2D);
+        geometry.bind();
 
-        if(bgType==tiled)
+        glBindTexture( GL_TEXTURE_2D, txData1.texture );
+        if(isMagic)
         {
-            verticalRepeats=0;
-            lenght_v -= txData1.h;
-            imgPos_Y -= txData1.h * ( (setup->attached==0)? -1 : 1 );
-            while(lenght_v <= PGE_Window::Height*2  ||  (lenght_v <=txData1.h*2))
+            for(int mg=0; mg < strips.size(); mg++)
             {
-                verticalRepeats++;
-                lenght_v += txData1.h;
+                int draw_x = (int)round((pCamera->s_left-x)/strips[mg].repeat_h) % (int)round(txData1.w);
+                drawLayer(stripLayers[mg], draw_x, imgPos_Y);
             }
         }
-
-        int draw_x = imgPos_X;
-        while(verticalRepeats > 0)
+        else
         {
-            draw_x = imgPos_X;
-            lenght = 0;
-            while((lenght <= PGE_Window::Width*2) || (lenght <=txData1.w*2))
+            //Frames of animation are scrolled by texture matrix
+            if(isAnimated)
             {
-                int magicRepeat=1;
-                if(isMagic)
-                {
-                    magicRepeat = strips.size();
-                }
-                else
-                {
-                    backgrndG = QRectF(QPointF(draw_x, imgPos_Y), QPointF(draw_x+txData1.w, imgPos_Y+txData1.h) );
-                }
-
-                int drawedHeight=0;
-                float d_top    = ani_x.first;
-                float d_bottom = ani_x.second;
-                for(int mg=0; mg < magicRepeat;mg++)
-                {
-                    if(isMagic)
-                    {
-                        draw_x = (int)round((pCamera->s_left-x)/strips[mg].repeat_h) % (int)round(txData1.w);
-                        draw_x += lenght;
-                        backgrndG = QRectF(QPointF(draw_x, imgPos_Y+drawedHeight),
-                                           QPointF(draw_x+txData1.w, imgPos_Y+drawedHeight+
-                                                                                           strips[mg].height) );
-                        drawedHeight += strips[mg].height;
-                        d_top = strips[mg].top;
-                        d_bottom = strips[mg].bottom;
-                    }
-                    glColor4f( 1.f, 1.f, 1.f, 1.f);
-                    glEnable(GL_TEXTURE_2D);
-                    glBindTexture( GL_TEXTURE_2D, txData1.texture );
-                    glBegin( GL_QUADS );
-                        glTexCoord2f( 0, d_top );
-                        glVertex2f( backgrndG.left(), backgrndG.top());
-
-                        glTexCoord2f( 1, d_top );
-                        glVertex2f(  backgrndG.right(), backgrndG.top());
-
-                        glTexCoord2f( 1, d_bottom );
-                        glVertex2f(  backgrndG.right(),  backgrndG.bottom());
-
-                        glTexCoord2f( 0, d_bottom );
-                        glVertex2f( backgrndG.left(),  backgrndG.bottom());
-
-                    glEnd();
-                }
-                lenght += txData1.w;
-                draw_x += txData1.w;
+                AniPos ani_x = ConfigManager::Animator_BG[animator_ID]->image();
+                glMatrixMode(GL_TEXTURE);
+                glPushMatrix();
+                glTranslatef(0.0f, ani_x.first, 0.0f);
+                glMatrixMode(GL_MODELVIEW);
             }
 
-            verticalRepeats--;
-            if(verticalRepeats>0)
+            drawLayer(firstRow, imgPos_X, imgPos_Y);
+
+            if(isAnimated)
             {
-                imgPos_Y += txData1.h * ( (setup->attached==0)? -1 : 1 );
+                glMatrixMode(GL_TEXTURE);
+                glPopMatrix();
+                glMatrixMode(GL_MODELVIEW);
             }
         }
 
-
-
         if(bgType==double_row)
         {
-            ani_x = AniPos(0,1);
-
             if(setup->second_attached==0) // over first
                 imgPos_Y = pCamera->s_bottom-y-txData1.h - txData2.h;
             else
@@ -370,32 +327,95 @@ void LVL_Background::draw(float x, float y)
 
             int imgPos_X = (int)round((pCamera->s_left-x)/setup->second_repeat_h) % (int)round(txData2.w);
 
-            lenght = 0;
-            while((lenght <= PGE_Window::Width*2) || (lenght <=txData1.w*2))
+            glBindTexture( GL_TEXTURE_2D, txData2.texture );
+            drawLayer(secondRow, imgPos_X, imgPos_Y);
+        }
+
+        geometry.release();
+    }
+}
+
+void LVL_Background::drawLayer(const Layer &layer, float x, float y)
+{
+    glPushMatrix();
+    glTranslatef(x, y, 0.0f);
+    geometry.drawRange(layer.first, layer.count);
+    glPopMatrix();
+}
+
+void LVL_Background::buildGeometry()
+{
+    geometry.clear();
+    stripLayers.clear();
+    firstRow.first = 0;
+    firstRow.count = 0;
+    secondRow.first = 0;
+    secondRow.count = 0;
+
+    geometryWidth = PGE_Window::Width;
+    geometryHeight = PGE_Window::Height;
+    geometryValid = true;
+
+    if(!setup) return;
+
+    //Tiles are covering same area as they was drawn by every frame,
+    //layer's origin is moved by parallax offsets
+    if((txData1.w > 0) && (txData1.h > 0))
+    {
+        int tiles=0;
+        for(int lenght=0; (lenght <= PGE_Window::Width*2) || (lenght <= txData1.w*2); lenght += txData1.w)
+            tiles++;
+
+        int verticalRepeats=1;
+        int rowStep=0;
+        if(bgType==tiled)
+        {
+            verticalRepeats=0;
+            int lenght_v = -txData1.h;
+            while(lenght_v <= PGE_Window::Height*2  ||  (lenght_v <=txData1.h*2))
             {
-                backgrndG = QRectF(QPointF(imgPos_X, imgPos_Y), QPointF(imgPos_X+txData2.w, imgPos_Y+txData2.h) );
-                glColor4f( 1.f, 1.f, 1.f, 1.f);
-                glEnable(GL_TEXTURE_2D);
-                glBindTexture( GL_TEXTURE_2D, txData2.texture );
-                glBegin( GL_QUADS );
-                    glTexCoord2f( 0, ani_x.first );
-                    glVertex2f( backgrndG.left(), backgrndG.top());
-
-                    glTexCoord2f( 1, ani_x.first );
-                    glVertex2f(  backgrndG.right(), backgrndG.top());
-
-                    glTexCoord2f( 1, ani_x.second );
-                    glVertex2f(  backgrndG.right(),  backgrndG.bottom());
-
-                    glTexCoord2f( 0, ani_x.second );
-                    glVertex2f( backgrndG.left(),  backgrndG.bottom());
-
-                glEnd();
-                lenght += txData2.w;
-                imgPos_X += txData2.w;
+                verticalRepeats++;
+                lenght_v += txData1.h;
             }
+            rowStep = txData1.h * ( (setup->attached==0)? -1 : 1 );
         }
 
+        if(isMagic)
+        {
+            int drawedHeight=0;
+            for(int mg=0; mg < strips.size(); mg++)
+            {
+                Layer layer;
+                layer.first = geometry.quadsCount();
+                for(int row=0; row < verticalRepeats; row++)
+                    for(int i=0; i < tiles; i++)
+                        geometry.addQuad(QRectF(i*txData1.w, row*rowStep+drawedHeight, txData1.w, strips[mg].height),
+                                         0.0f, strips[mg].top, 1.0f, strips[mg].bottom);
+                layer.count = geometry.quadsCount()-layer.first;
+                stripLayers.push_back(layer);
+                drawedHeight += strips[mg].height;
+            }
+        }
+        else
+        {
+            float frameBottom = 1.0f;
+            if(isAnimated && (setup->frames > 0))
+                frameBottom = 1.0f/setup->frames;
+
+            firstRow.first = geometry.quadsCount();
+            for(int row=0; row < verticalRepeats; row++)
+                for(int i=0; i < tiles; i++)
+                    geometry.addQuad(QRectF(i*txData1.w, row*rowStep, txData1.w, txData1.h),
+                                     0.0f, 0.0f, 1.0f, frameBottom);
+            firstRow.count = geometry.quadsCount()-firstRow.first;
+        }
     }
-}
 
+    if((bgType==double_row) && (txData2.w > 0))
+    {
+        secondRow.first = geometry.quadsCount();
+        for(int lenght=0, i=0; (lenght <= PGE_Window::Width*2) || (lenght <= txData1.w*2); lenght += txData2.w, i++)
+            geometry.addQuad(QRectF(i*txData2.w, 0, txData2.w, txData2.h), 0.0f, 0.0f, 1.0f, 1.0f);
+        secondRow.count = geometry.quadsCount()-secondRow.first;
+    }
+}
@@ -22,6 +22,7 @@
 #include "../data_configs/obj_bg.h"
 #include "../common_features/pge_texture.h"
 #include "lvl_camera.h"
+#include "quad_buffer.h"
 
 
 //Magic background strip value
@@ -70,6 +71,24 @@ public:
 
 private:
     void construct();
+
+    //Range of quads in geometry which are drawn with same offset
+    struct Layer
+    {
+        int first;
+        int count;
+    };
+    //! Builds tiles of all rows, it's done once per background and window size
+    void buildGeometry();
+    void drawLayer(const Layer &layer, float x, float y);
+
+    QuadBuffer geometry;
+    Layer firstRow;
+    QVector<Layer > stripLayers;
+    Layer secondRow;
+    bool geometryValid;
+    int geometryWidth;
+    int geometryHeight;
 };
 
 
@@ -20,6 +20,7 @@
 #include "window.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 PGE_LevelCamera::PGE_LevelCamera()
 {
@@ -32,6 +33,12 @@ PGE_LevelCamera::PGE_LevelCamera()
     width=800;
     height=600;
     BackgroundID = 0;
+
+    fader_opacity = 0.0f;
+    target_opacity = 0.0f;
+    fade_step = 0.0f;
+    fadeSpeed = 25;
+    fader_timer_id = 0;
 }
 
 PGE_LevelCamera::~PGE_LevelCamera()
@@ -39,6 +46,8 @@ PGE_LevelCamera::~PGE_LevelCamera()
 
     qDebug() << "Destroy camera";
 
+    TimerScheduler::remove(fader_timer_id);
+
 //    if(sensor && worldPtr)
 //    {
 //        worldPtr->DestroyBody(sensor);
@@ -54,6 +63,11 @@ void PGE_LevelCamera::setWorld(b2World *wld)
     worldPtr = wld;
 }
 
+b2World *PGE_LevelCamera::world()
+{
+    return worldPtr;
+}
+
 
 void PGE_LevelCamera::init(float x, float y, float w, float h)
 {
@@ -198,31 +212,11 @@ void PGE_LevelCamera::update()
 
 
     //Sort array
-    PGE_Phys_Object * tmp1;
-    int total = objects_to_render.size();
-    long i;
-    double ymin;
-    long ymini;
-    long sorted = 0;
-
-
-        while(sorted < objects_to_render.size())
-        {
-            ymin = objects_to_render[sorted]->z_index;
-            ymini = sorted;
-
-            for(i = sorted; i < total; i++)
-            {
-                if( objects_to_render[i]->z_index < ymin )
-                {
-                    ymin = objects_to_render[i]->z_index; ymini = i;
-                }
-            }
-            tmp1 = objects_to_render[ymini];
-            objects_to_render[ymini] = objects_to_render[sorted];
-            objects_to_render[sorted] = tmp1;
-            sorted++;
-        }
+    std::stable_sort(objects_to_render.begin(), objects_to_render.end(),
+                     [](PGE_Phys_Object *a, PGE_Phys_Object *b)
+                     {
+                         return a->z_index < b->z_index;
+                     });
 
     //qDebug() << "VisibleItems" << objects_to_render.size()  << contacts;
 }
@@ -281,7 +275,8 @@ void PGE_LevelCamera::setFade(int speed, float target, float step)
     fade_step = fabs(step);
     target_opacity = target;
     fadeSpeed = speed;
-    fader_timer_id = SDL_AddTimer(speed, &PGE_LevelCamera::nextOpacity, this);
+    TimerScheduler::remove(fader_timer_id);
+    fader_timer_id = TimerScheduler::add(speed, &PGE_LevelCamera::nextOpacity, this);
 }
 
 unsigned int PGE_LevelCamera::nextOpacity(unsigned int x, void *p)
@@ -289,7 +284,7 @@ unsigned int PGE_LevelCamera::nextOpacity(unsigned int x, void *p)
     Q_UNUSED(x);
     PGE_LevelCamera *self = reinterpret_cast<PGE_LevelCamera *>(p);
     self->fadeStep();
-    return 0;
+    return self->fadeSpeed;
 }
 
 void PGE_LevelCamera::fadeStep()
@@ -300,8 +295,9 @@ void PGE_LevelCamera::fadeStep()
         fader_opacity-=fade_step;
 
     if(fader_opacity>=1.0 || fader_opacity<=0.0)
-        SDL_RemoveTimer(fader_timer_id);
-    else
-        fader_timer_id = SDL_AddTimer(fadeSpeed, &PGE_LevelCamera::nextOpacity, this);
+    {
+        TimerScheduler::remove(fader_timer_id);
+        fader_timer_id = 0;
+    }
 }
 /**************************Fader**end**************************/
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <file_formats.h>
+#include "../common_features/timer_scheduler.h"
 
 typedef QVector<PGE_Phys_Object *>  PGE_RenderList;
 
@@ -39,6 +40,7 @@ public:
     qreal posY(); //!< Position Y
 
     void setWorld(b2World * wld);
+    b2World *world();
     void init(float x, float y, float w, float h);
 
     void setPos(float x, float y);
@@ -81,7 +83,7 @@ public:
     void setFade(int speed, float target, float step);
     static unsigned int nextOpacity(unsigned int x, void *p);
     void fadeStep();
-    SDL_TimerID fader_timer_id;
+    int fader_timer_id;
     /**************Fader**************/
 
 private:
@@ -0,0 +1,117 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quad_buffer.h"
+#include "gl_renderer.h"
+
+static const GLsizei quadVertexStride = 4*sizeof(GLfloat);
+
+QuadBuffer::QuadBuffer()
+{
+    vbo = 0;
+    uploaded = false;
+}
+
+QuadBuffer::~QuadBuffer()
+{
+    clear();
+}
+
+void QuadBuffer::clear()
+{
+    if(vbo)
+        GlRenderer::deleteVertexBuffer(vbo);
+    vbo = 0;
+    uploaded = false;
+    vertices.clear();
+}
+
+void QuadBuffer::addQuad(const QRectF &rect, float texLeft, float texTop, float texRight, float texBottom)
+{
+    GLfloat quad[16] =
+    {
+        GLfloat(rect.left()),  GLfloat(rect.top()),    texLeft,  texTop,
+        GLfloat(rect.right()), GLfloat(rect.top()),    texRight, texTop,
+        GLfloat(rect.right()), GLfloat(rect.bottom()), texRight, texBottom,
+        GLfloat(rect.left()),  GLfloat(rect.bottom()), texLeft,  texBottom
+    };
+    for(int i=0; i<16; i++)
+        vertices.push_back(quad[i]);
+    uploaded = false;
+}
+
+int QuadBuffer::quadsCount() const
+{
+    return vertices.size()/16;
+}
+
+bool QuadBuffer::isEmpty() const
+{
+    return vertices.isEmpty();
+}
+
+void QuadBuffer::upload()
+{
+    if(vbo)
+        GlRenderer::deleteVertexBuffer(vbo);
+    vbo = 0;
+    uploaded = true;
+    if(vertices.isEmpty()) return;
+    vbo = GlRenderer::createVertexBuffer(vertices.constData(), long(vertices.size())*sizeof(GLfloat));
+}
+
+void QuadBuffer::bind()
+{
+    if(!uploaded) upload();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    if(vbo)
+    {
+        GlRenderer::bindVertexBuffer(vbo);
+        glVertexPointer(2, GL_FLOAT, quadVertexStride, (const GLvoid*)0);
+        glTexCoordPointer(2, GL_FLOAT, quadVertexStride, (const GLvoid*)(2*sizeof(GLfloat)));
+    }
+    else
+    {
+        glVertexPointer(2, GL_FLOAT, quadVertexStride, vertices.constData());
+        glTexCoordPointer(2, GL_FLOAT, quadVertexStride, vertices.constData()+2);
+    }
+}
+
+void QuadBuffer::drawRange(int first, int count)
+{
+    if(count <= 0) return;
+    glDrawArrays(GL_QUADS, first*4, count*4);
+}
+
+void QuadBuffer::release()
+{
+    if(vbo)
+        GlRenderer::bindVertexBuffer(0);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+void QuadBuffer::draw()
+{
+    if(isEmpty()) return;
+    bind();
+    drawRange(0, quadsCount());
+    release();
+}
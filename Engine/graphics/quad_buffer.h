@@ -0,0 +1,63 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUAD_BUFFER_H
+#define QUAD_BUFFER_H
+
+#include "graphics.h"
+
+#include <QRectF>
+#include <QVector>
+
+///
+/// \brief Cached textured quads which are drawn by one call
+///
+/// Vertices are interleaved as x, y, s, t. Geometry is stored in vertex buffer
+/// object when it's supported, otherwise it's drawn as vertex array from memory.
+/// Position of geometry is set by modelview matrix, it's not rebuilt when it moves.
+///
+class QuadBuffer
+{
+public:
+    QuadBuffer();
+    ~QuadBuffer();
+
+    void clear();
+    void addQuad(const QRectF &rect, float texLeft, float texTop, float texRight, float texBottom);
+    int quadsCount() const;
+    bool isEmpty() const;
+
+    //! Binds geometry to vertex and texture coordinate arrays
+    void bind();
+    //! Draws part of quads, buffer must be bound
+    void drawRange(int first, int count);
+    void release();
+    //! Draws all quads
+    void draw();
+
+private:
+    Q_DISABLE_COPY(QuadBuffer)
+
+    void upload();
+
+    QVector<GLfloat > vertices;
+    GLuint vbo;
+    bool uploaded;
+};
+
+#endif // QUAD_BUFFER_H
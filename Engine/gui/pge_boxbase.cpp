@@ -14,16 +14,24 @@ PGE_BoxBase::PGE_BoxBase()
     fade_step = 0.02f;
     target_opacity=0.0f;
     fadeSpeed=10;
+    fader_timer_id=0;
 }
 
 PGE_BoxBase::PGE_BoxBase(Scene *_parentScene)
 {
     parentScene = _parentScene;
+
+    fader_opacity = 0.0f;
+    fade_step = 0.02f;
+    target_opacity=0.0f;
+    fadeSpeed=10;
+    fader_timer_id=0;
     if(!parentScene) glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 }
 
 PGE_BoxBase::~PGE_BoxBase()
 {
+    TimerScheduler::remove(fader_timer_id);
 
 }
 
@@ -47,8 +55,8 @@ void PGE_BoxBase::setFade(int speed, float target, float step)
     target_opacity = target;
     fadeSpeed = speed;
 
-    fader_timer_id = SDL_AddTimer(speed, &PGE_BoxBase::nextOpacity, this);
-    if(!fader_timer_id) fader_opacity = target_opacity;
+    TimerScheduler::remove(fader_timer_id);
+    fader_timer_id = TimerScheduler::add(speed, &PGE_BoxBase::nextOpacity, this);
 }
 
 unsigned int PGE_BoxBase::nextOpacity(unsigned int x, void *p)
@@ -56,7 +64,7 @@ unsigned int PGE_BoxBase::nextOpacity(unsigned int x, void *p)
     Q_UNUSED(x);
     PGE_BoxBase *self = reinterpret_cast<PGE_BoxBase *>(p);
     self->fadeStep();
-    return 0;
+    return self->fadeSpeed;
 }
 
 void PGE_BoxBase::fadeStep()
@@ -67,12 +75,10 @@ void PGE_BoxBase::fadeStep()
         fader_opacity-=fade_step;
 
     if(fader_opacity>=1.0f || fader_opacity<=0.0f)
-        SDL_RemoveTimer(fader_timer_id);
-    else
-        {
-            fader_timer_id = SDL_AddTimer(fadeSpeed, &PGE_BoxBase::nextOpacity, this);
-            if(!fader_timer_id) fader_opacity = target_opacity;
-        }
+    {
+        TimerScheduler::remove(fader_timer_id);
+        fader_timer_id = 0;
+    }
 
     if(fader_opacity>1.0f) fader_opacity = 1.0f;
     else
@@ -5,6 +5,7 @@
 #include <QString>
 
 #include <SDL2/SDL_timer.h>
+#include "../common_features/timer_scheduler.h"
 
 ///
 /// \brief The PGE_BoxBase class
@@ -28,7 +29,7 @@ public:
     void setFade(int speed, float target, float step);
     static unsigned int nextOpacity(unsigned int x, void *p);
     void fadeStep();
-    SDL_TimerID fader_timer_id;
+    int fader_timer_id;
     /**************Fader**************/
 
 protected:
@@ -117,6 +117,7 @@ void PGE_MsgBox::exec()
             fader_opacity = 1.0f;
 
         start_render=SDL_GetTicks();
+        TimerScheduler::sync();
 
         PGE_BoxBase::exec();
 
@@ -129,6 +130,7 @@ void PGE_MsgBox::exec()
             glVertex2f( PGE_Window::Width/2 - width*fader_opacity - padding, PGE_Window::Height/2 + height*fader_opacity + padding);
         glEnd();
 
+        GlRenderer::captureFrame();
         glFlush();
         SDL_GL_SwapWindow(PGE_Window::window);
 
@@ -158,6 +160,7 @@ void PGE_MsgBox::exec()
     {
 
         start_render=SDL_GetTicks();
+        TimerScheduler::sync();
 
         PGE_BoxBase::exec();
 
@@ -178,6 +181,7 @@ void PGE_MsgBox::exec()
                                          PGE_Window::Height/2-height,
                                          &textTexture);
 
+        GlRenderer::captureFrame();
         glFlush();
         SDL_GL_SwapWindow(PGE_Window::window);
 
@@ -246,6 +250,7 @@ void PGE_MsgBox::exec()
             fader_opacity = 0.0f;
 
         start_render=SDL_GetTicks();
+        TimerScheduler::sync();
 
         PGE_BoxBase::exec();
 
@@ -262,6 +267,7 @@ void PGE_MsgBox::exec()
                         PGE_Window::Height/2 + height*fader_opacity + padding);
         glEnd();
 
+        GlRenderer::captureFrame();
         glFlush();
         SDL_GL_SwapWindow(PGE_Window::window);
 
@@ -29,6 +29,9 @@
 
 #include "common_features/app_path.h"
 #include "common_features/graphics_funcs.h"
+#include "common_features/texture_cache.h"
+#include "common_features/bench_runner.h"
+#include "common_features/level_prefetch.h"
 
 #include "data_configs/select_config.h"
 #include "data_configs/config_manager.h"
@@ -49,6 +52,7 @@
 #include <Box2D/Box2D.h>
 
 #include <iostream>
+#include <string.h>
 using namespace std;
 
 
@@ -59,6 +63,13 @@ int main(int argc, char *argv[])
 
     QApplication::addLibraryPath( QFileInfo(argv[0]).dir().path() );
 
+    //Benchmark must work on machines without display
+    for(int i=1; i<argc; i++)
+    {
+        if((strcmp(argv[i], "--bench")==0) && qgetenv("QT_QPA_PLATFORM").isEmpty())
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
 
@@ -78,6 +89,10 @@ int main(int argc, char *argv[])
     QString fileToPpen = "";//ApplicationPath+"/physics.lvl";
     bool debugMode=false; //enable debug mode
     bool interprocessing=false; //enable interprocessing
+    QString recordInput; //save keys of first played level into file
+    QString replayInput; //take keys of first played level from file
+    bool benchMode=false; //run level without window and print timings
+    int benchTicks=3000;
 
     bool skipFirst=true;
     foreach(QString param, a.arguments())
@@ -104,6 +119,37 @@ int main(int argc, char *argv[])
             debugMode=true;
         }
         else
+        if(param.startsWith("--texture-cache="))
+        {
+            bool ok;
+            int megabytes = param.section('=', 1).toInt(&ok);
+            if(ok && (megabytes >= 0))
+                TextureCache::setBudget(megabytes);
+        }
+        else
+        if(param.startsWith("--record-input="))
+        {
+            recordInput = FileFormats::removeQuotes(param.section('=', 1));
+        }
+        else
+        if(param.startsWith("--replay-input="))
+        {
+            replayInput = FileFormats::removeQuotes(param.section('=', 1));
+        }
+        else
+        if(param == ("--bench"))
+        {
+            benchMode=true;
+        }
+        else
+        if(param.startsWith("--bench-ticks="))
+        {
+            bool ok;
+            int ticks = param.section('=', 1).toInt(&ok);
+            if(ok && (ticks > 0))
+                benchTicks = ticks;
+        }
+        else
         if(param == ("--interprocessing"))
         {
             IntProc::init();
@@ -131,6 +177,17 @@ int main(int argc, char *argv[])
 
     QString configPath_manager = cmanager->isPreLoaded();
 
+    if(benchMode && configPath.isEmpty())
+    {
+        if(configPath_manager.isEmpty())
+        {
+            qCritical() << "Benchmark: configuration is not selected, use --config=<path>";
+            delete cmanager;
+            exit(1);
+        }
+        configPath = configPath_manager;
+    }
+
     //If application runned first time or target configuration is not exist
     if(configPath_manager.isEmpty() && configPath.isEmpty())
     {
@@ -159,6 +216,25 @@ int main(int argc, char *argv[])
     ConfigManager::setConfigPath(configPath);
     if(!ConfigManager::loadBasics()) exit(1);
 
+    if(benchMode)
+    {
+        if(fileToPpen.isEmpty())
+        {
+            qCritical() << "Benchmark: level file is not given";
+            exit(1);
+        }
+        //No window and no OpenGL, only SDL clock is used by level
+        SDL_Init(SDL_INIT_TIMER);
+        GlRenderer::setHeadless(true);
+        int result = BenchRunner::run(fileToPpen, benchTicks, replayInput);
+        LevelPrefetch::shutdown();
+        ConfigManager::unloadLevelConfigs();
+        TextureCache::clear();
+        SDL_Quit();
+        IntProc::quit();
+        return result;
+    }
+
     //Init Window
     if(!PGE_Window::init(QString("Platformer Game Engine - v")+_FILE_VERSION+_FILE_RELEASE)) exit(1);
 
@@ -168,6 +244,9 @@ int main(int argc, char *argv[])
     //Init font manager
     FontManager::init();
 
+    //Level settings are staying loaded between levels
+    if(!ConfigManager::loadLevelSettings()) exit(1);
+
     glFlush();
     SDL_GL_SwapWindow(PGE_Window::window);
 
@@ -234,6 +313,12 @@ int main(int argc, char *argv[])
             if(sceneResult)
                 sceneResult = lScene->loadConfigs();
 
+            //Input is recorded or replayed for the first level only
+            lScene->setInputRecording(recordInput);
+            lScene->setInputReplay(replayInput);
+            recordInput.clear();
+            replayInput.clear();
+
             if(sceneResult)
                 sceneResult = lScene->init();
             lScene->stopLoaderAnimation();
@@ -277,6 +362,9 @@ int main(int argc, char *argv[])
 
     FontManager::quit();
 
+    LevelPrefetch::shutdown();
+    TextureCache::clear();
+    GlRenderer::uninit();
     PGE_Window::uninit();
     return 0;
 }
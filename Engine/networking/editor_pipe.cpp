@@ -5,6 +5,7 @@
 #include <QtDebug>
 #include <QElapsedTimer>
 #include <QApplication>
+#include <QSharedMemory>
 
 #include "../common_features/app_path.h"
 
@@ -14,63 +15,109 @@
  */
 EditorPipe::EditorPipe()
 {
-    do_acceptLevelData=false;
-    do_parseLevelData=false;
-
-    accepted_lvl_raw="";
     accepted_lvl.ReadFileValid = false;
 
-    levelAccepted=false;
+    levelAccepted.store(0);
+    server=NULL;
+    editorSocket=NULL;
 }
 
 /**
  * @brief EditorPipe::~LocalServer
- *  Destructor
+ *  Destructor. Sockets are closed by the pipe thread when it's finished
  */
 EditorPipe::~EditorPipe()
-{
-    server->close();
-    for(int i = 0; i < clients.size(); ++i)
-    {
-        if(clients[i]) clients[i]->close();
-    }
-}
+{}
 
 void EditorPipe::shut()
 {
     sendToEditor("CMD:ENGINE_CLOSED");
+    //Make sure the command is sent before engine will be closed
+    if(isRunning())
+        emit outQueueFlushRequested();
 }
 
 bool EditorPipe::levelIsLoad()
 {
-    bool state = levelAccepted;
-    levelAccepted=false;
-    return state;
+    return (levelAccepted.fetchAndStoreAcquire(0)!=0);
 }
 
 
+/**
+ * @brief EditorPipe::takeLevelDeltas
+ *  Moves all received level deltas into the given list
+ *  @return false if nothing was received
+ */
+bool EditorPipe::takeLevelDeltas(QList<IntProcProto::LevelDelta> &deltas)
+{
+    levelDeltasMutex.lock();
+    bool received = !levelDeltas.isEmpty();
+    deltas.append(levelDeltas);
+    levelDeltas.clear();
+    levelDeltasMutex.unlock();
+    return received;
+}
 
 void EditorPipe::sendToEditor(QString command)
 {
-    QLocalSocket socket;
+    outQueueMutex.lock();
+    outQueue.enqueue(command);
+    outQueueMutex.unlock();
+    emit outQueueChanged();
+}
+
+/**
+ * @brief EditorPipe::flushOutQueue
+ *  Sends all queued commands through the persistent connection to the editor.
+ *  Called in the pipe thread
+ */
+void EditorPipe::flushOutQueue()
+{
+    outQueueMutex.lock();
+    bool empty = outQueue.isEmpty();
+    outQueueMutex.unlock();
 
-    // Attempt to connect to the LocalServer
-    socket.connectToServer("PGEEditor335jh3c3n8g7");
+    if(empty)
+        return;
 
-    if(socket.waitForConnected(100))
+    if(!editorSocket)
+        editorSocket = new QLocalSocket();
+
+    if(editorSocket->state()!=QLocalSocket::ConnectedState)
     {
-        QString str = QString(command);
-        QByteArray bytes;
-        bytes = str.toUtf8();
-        socket.write(bytes);
-        socket.flush();
-        QThread::msleep(100);
-        socket.close();
+        // Attempt to connect to the LocalServer, commands are kept in queue until next attempt
+        editorSocket->connectToServer("PGEEditor335jh3c3n8g7");
+        if(!editorSocket->waitForConnected(100))
+        {
+            qDebug() << "sendToEditor(QString command)" << editorSocket->errorString();
+            return;
+        }
     }
-    else
+
+    outQueueMutex.lock();
+    QQueue<QString> commands = outQueue;
+    outQueue.clear();
+    outQueueMutex.unlock();
+
+    QByteArray bytes;
+    foreach(QString command, commands)
     {
-        qDebug() << "sendToEditor(QString command)" << socket.errorString();
+        //Editor splits commands by new line
+        bytes.append(command.toUtf8());
+        bytes.append('\n');
     }
+
+    if(editorSocket->write(bytes) < 0)
+    {
+        qDebug() << "sendToEditor(QString command)" << editorSocket->errorString();
+        //Put commands back before the ones which were queued meanwhile
+        outQueueMutex.lock();
+        commands.append(outQueue);
+        outQueue = commands;
+        outQueueMutex.unlock();
+        return;
+    }
+    editorSocket->flush();
 }
 
 /**
@@ -81,14 +128,18 @@ void EditorPipe::sendToEditor(QString command)
 
 /**
  * @brief run
- *  Initiate the thread.
+ *  Initiate the thread and run the event loop of it
  */
 void EditorPipe::run()
 {
   server = new QLocalServer();
 
-  QObject::connect(server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()));
+  //Server and sockets are living in this thread, their signals are processed by the thread's event loop
+  QObject::connect(server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()), Qt::DirectConnection);
   QObject::connect(this, SIGNAL(privateDataReceived(QString)), this, SLOT(slotOnData(QString)));
+  QObject::connect(this, &EditorPipe::outQueueChanged, server, [this]() { flushOutQueue(); });
+  QObject::connect(this, &EditorPipe::outQueueFlushRequested, server, [this]() { flushOutQueue(); },
+                   Qt::BlockingQueuedConnection);
 
 #ifdef Q_OS_UNIX
   // Make sure the temp address file is deleted
@@ -107,102 +158,158 @@ void EditorPipe::run()
   }
   qDebug() << "Listen " << server->isListening() << serverName;
 
+  //Commands which are queued before server was started
+  flushOutQueue();
+
   exec();
 
+  for(int i = 0; i < clients.size(); ++i)
+  {
+      clients[i]->close();
+      delete clients[i];
+  }
+  clients.clear();
+  clientBuffers.clear();
+  if(editorSocket)
+  {
+      editorSocket->close();
+      delete editorSocket;
+      editorSocket = NULL;
+  }
+  server->close();
+  delete server;
+  server = NULL;
+
   qDebug()<< "Server closed";
 }
 
 
 
 /**
- * @brief EditorPipe::exec
- *  Keeps the thread alive. Waits for incomming connections
+ * @brief EditorPipe::readClient
+ *  Accepts available data of client and processes all completely received messages
  */
-void EditorPipe::exec()
+void EditorPipe::readClient(QLocalSocket *client)
 {
-    loop:
-    while(server->isListening())
+    int i = clients.indexOf(client);
+    if(i<0) return;
+
+    clientBuffers[i].append(client->readAll());
+
+    QList<IntProcProto::Message> messages;
+    if(!IntProcProto::unpack(clientBuffers[i], messages))
     {
-        msleep(100);
-        if(!server->waitForNewConnection(100))
-            {
-                QString msg = server->errorString();
-                if(!msg.isEmpty())
-                qDebug() << "exec()" << msg;
-            }
+        qDebug() << "Broken message from editor, connection closed";
+        clientBuffers[i].clear();
+        client->close();
+        return;
+    }
 
+    foreach(IntProcProto::Message msg, messages)
+        processMessage(client, msg);
+}
 
-        for(int i = 0; i < clients.size(); ++i)
+void EditorPipe::processMessage(QLocalSocket *client, const IntProcProto::Message &msg)
+{
+    switch(msg.type)
+    {
+    case IntProcProto::MSG_LEVEL_DATA:
+        {
+            bool valid = acceptLevelData(msg.payload);
+            client->write(IntProcProto::packAck(msg.seq, valid));
+            client->flush();
+            levelAccepted.storeRelease(1);
+        }
+        break;
+    case IntProcProto::MSG_LEVEL_DATA_SHM:
+        {
+            //On fail editor will send the level through the socket, so don't mark it as accepted
+            bool valid = acceptLevelDataShm(msg.payload);
+            client->write(IntProcProto::packAck(msg.seq, valid));
+            client->flush();
+            if(valid)
+                levelAccepted.storeRelease(1);
+        }
+        break;
+    case IntProcProto::MSG_LEVEL_DELTA:
         {
-            if(clients[i]->waitForReadyRead(100))
+            IntProcProto::LevelDelta delta;
+            bool valid = IntProcProto::unpackLevelDelta(msg.payload, delta);
+            if(valid)
             {
-                QByteArray data = clients[i]->readAll();
-                QString acceptedData = QString::fromUtf8(data);
-                emit privateDataReceived(QString::fromUtf8(data));
-
-                if(do_acceptLevelData)
-                {
-                    accepted_lvl_raw.append(acceptedData);
-                    if(acceptedData.endsWith("\n\n"))
-                        do_acceptLevelData=false;
-                }
-                else
-                if(acceptedData.startsWith("SEND_LVLX: ", Qt::CaseSensitive))
-                {
-                    qDebug() << acceptedData;
-
-                    acceptedData.remove("SEND_LVLX: ");
-                    accepted_lvl_path = acceptedData;
-                    do_acceptLevelData=true;
-
-                    qDebug() << "Send 'Ready'";
-
-                    QByteArray toClient = QString("READY\n\n").toUtf8();
-                    clients[i]->write(toClient);
-                    clients[i]->flush();
-                    if(clients[i]->waitForBytesWritten(100))
-                        qDebug() << "'Ready' sent";
-                    else
-                        qDebug() << "Fail to send 'Ready'";
-
-                }
-                else
-                if(acceptedData=="PARSE_LVLX\n\n")
-                {
-                    do_parseLevelData=true;
-                    accepted_lvl = FileFormats::ReadExtendedLvlFile(accepted_lvl_raw, accepted_lvl_path);
-                    qDebug()<<"Level data parsed, Valid:" << accepted_lvl.ReadFileValid;
-                    levelAccepted=true;
-                }
-                else
-                if(acceptedData=="PING\n\n")
-                {
-                    QByteArray toClient = QString("PONG\n\n").toUtf8();
-                    clients[i]->write(toClient);
-                    clients[i]->flush();
-                    if(clients[i]->waitForBytesWritten(100))
-                        qDebug() << "sent";
-                    else
-                        qDebug() << "error";
-
-                    qDebug()<< "Ping-Pong!";
-                }
+                levelDeltasMutex.lock();
+                levelDeltas.push_back(delta);
+                levelDeltasMutex.unlock();
             }
+            else
+                qDebug() << "Broken level delta from editor";
+
+            client->write(IntProcProto::packAck(msg.seq, valid));
+            client->flush();
         }
+        break;
+    case IntProcProto::MSG_PING:
+        client->write(IntProcProto::pack(IntProcProto::MSG_PONG, msg.seq));
+        client->flush();
+        qDebug()<< "Ping-Pong!";
+        break;
+    case IntProcProto::MSG_PONG:
+        break;
+    case IntProcProto::MSG_COMMAND:
+        emit privateDataReceived(QString::fromUtf8(msg.payload));
+        client->write(IntProcProto::packAck(msg.seq, true));
+        client->flush();
+        break;
+    default:
+        qDebug() << "Unknown message from editor:" << msg.type;
+        client->write(IntProcProto::packAck(msg.seq, false));
+        client->flush();
     }
-    qDebug() << "Listen " << server->isListening() << LOCAL_SERVER_NAME;
-    msleep(100);
-    goto loop;
 }
 
+bool EditorPipe::acceptLevelData(const QByteArray &raw)
+{
+    QElapsedTimer time;
+    time.start();
+    accepted_lvl = FileFormats::ReadLvlRawData(raw);
+    //Deltas which are not applied yet belong to the previous level
+    levelDeltasMutex.lock();
+    levelDeltas.clear();
+    levelDeltasMutex.unlock();
+    qDebug()<<"Level data accepted in" << time.elapsed() << "ms, Valid:" << accepted_lvl.ReadFileValid;
+    return accepted_lvl.ReadFileValid;
+}
 
+/**
+ * @brief EditorPipe::acceptLevelDataShm
+ *  Reads level from shared memory segment of editor. Segment is mapped read-only
+ *  and parsed in place, editor destroys it after acknowledge
+ */
+bool EditorPipe::acceptLevelDataShm(const QByteArray &handle)
+{
+    QString key;
+    quint32 size=0;
+    if(!IntProcProto::readShmHandle(handle, key, size))
+        return false;
 
+    QSharedMemory shm(key);
+    if(!shm.attach(QSharedMemory::ReadOnly))
+    {
+        qDebug() << "Can't attach shared memory:" << shm.errorString();
+        return false;
+    }
+    if(quint32(shm.size()) < size)
+    {
+        shm.detach();
+        return false;
+    }
 
-
-
-
-
-
+    shm.lock();
+    bool valid = acceptLevelData(QByteArray::fromRawData(static_cast<const char*>(shm.constData()), int(size)));
+    shm.unlock();
+    shm.detach();
+    return valid;
+}
 
 
 /**
@@ -213,22 +320,37 @@ void EditorPipe::exec()
 
 void EditorPipe::slotNewConnection()
 {
-    qDebug() << "New connection!";
-    clients.push_front(server->nextPendingConnection());
+    while(server->hasPendingConnections())
+    {
+        QLocalSocket *client = server->nextPendingConnection();
+        qDebug() << "New connection!";
+        clients.push_front(client);
+        clientBuffers.push_front(QByteArray());
+
+        //Connection is kept open, data is processed as soon as it comes
+        QObject::connect(client, &QLocalSocket::readyRead, client, [this, client]() { readClient(client); });
+        QObject::connect(client, SIGNAL(disconnected()), this, SLOT(slotClientDisconnected()), Qt::DirectConnection);
+
+        if(client->bytesAvailable()>0)
+            readClient(client);
+    }
     qDebug() << clients.size();
 }
 
-
-void EditorPipe::slotOnData(QString data)
+void EditorPipe::slotClientDisconnected()
 {
+    QLocalSocket *client = qobject_cast<QLocalSocket *>(sender());
+    int i = clients.indexOf(client);
+    if(i<0) return;
+
+    clients.remove(i);
+    clientBuffers.remove(i);
+    client->deleteLater();
+}
 
-  if(do_acceptLevelData)
-  {
-      accepted_lvl = FileFormats::ReadExtendedLvlFile(data, accepted_lvl_path);
-      qDebug() << "Accepted level data";
-      return;
-  }
 
+void EditorPipe::slotOnData(QString data)
+{
   QStringList args = data.split('\n');
   foreach(QString c, args)
   {
@@ -5,8 +5,12 @@
 #include <QVector>
 #include <QLocalServer>
 #include <QLocalSocket>
+#include <QQueue>
+#include <QMutex>
+#include <QAtomicInt>
 
 #include <file_formats.h>
+#include "../../Editor/networking/intproc_proto.h"
 
 #define LOCAL_SERVER_NAME "PGEEngine42e3j"
 
@@ -18,36 +22,47 @@ public:
     ~EditorPipe();
     void shut();
 
-                               // SEND_LVLX: /some/path/to/level file\n\n
-    QString accepted_lvl_path; // Send to client the "READY\n\n" before accent raw data
-    bool do_acceptLevelData;
-    QString accepted_lvl_raw;  // accept any raw data before will be accepted '\n\n'
-    bool do_parseLevelData;
-    LevelData accepted_lvl;    // When accepted PARSE_LVLX\n\n, parse data and call signal
+    LevelData accepted_lvl;    // Level data accepted by MSG_LEVEL_DATA message
     bool levelIsLoad();
-    void sendToEditor(QString command);
+    void sendToEditor(QString command); // Puts command into queue, it will be sent by pipe thread
+    bool takeLevelDeltas(QList<IntProcProto::LevelDelta> &deltas); // Changes of tested level, applied by main thread
 
 private:
-    bool levelAccepted;
+    QAtomicInt levelAccepted;
+    QList<IntProcProto::LevelDelta> levelDeltas;
+    QMutex levelDeltasMutex;
 
 protected:
     void run();
-    void exec();
 
 signals:
     void dataReceived(QString data);
     void privateDataReceived(QString data);
     void showUp();
     void openFile(QString path);
+    void outQueueChanged();
+    void outQueueFlushRequested();
 
 private slots:
     void slotNewConnection();
+    void slotClientDisconnected();
     void slotOnData(QString data);
     void displayError(QLocalSocket::LocalSocketError socketError);
 
 private:
+    void readClient(QLocalSocket *client);
+    void processMessage(QLocalSocket *client, const IntProcProto::Message &msg);
+    bool acceptLevelData(const QByteArray &raw);
+    bool acceptLevelDataShm(const QByteArray &handle);
+    void flushOutQueue();
+
     QLocalServer* server;
     QVector<QLocalSocket*> clients;
+    QVector<QByteArray> clientBuffers; // Not completely received messages of each client
+
+    QLocalSocket* editorSocket;        // Persistent connection to the editor
+    QQueue<QString> outQueue;          // Commands to the editor
+    QMutex outQueueMutex;
 };
 
 #endif // EDITOR_PIPE_H
@@ -22,7 +22,10 @@ void IntProc::quit()
 {
     if(editor!=NULL)
     {
-        editor->terminate();
+        //Stop event loop of the pipe, it will close all sockets
+        editor->quit();
+        if(!editor->wait(1000))
+            editor->terminate();
         delete editor;
         editor = NULL;
         enabled=false;
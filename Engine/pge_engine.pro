@@ -50,6 +50,7 @@ win32: {
 LIBS += -lSDL2
 win32: LIBS += -lSDL2main
 win32: LIBS += libversion
+win32: LIBS += -lpsapi
 unix:  LIBS += -lglut -lGLU
 
 RC_FILE = _resources/engine.rc
@@ -104,6 +105,8 @@ SOURCES += main.cpp \
     ../Editor/file_formats/file_formats.cpp \
     ../Editor/file_formats/file_lvl.cpp \
     ../Editor/file_formats/file_lvlx.cpp \
+    ../Editor/file_formats/file_lvl_raw.cpp \
+    ../Editor/file_formats/lvl_sort.cpp \
     ../Editor/file_formats/file_npc_txt.cpp \
     ../Editor/file_formats/file_wld.cpp \
     ../Editor/file_formats/file_wldx.cpp \
@@ -112,6 +115,7 @@ SOURCES += main.cpp \
     ../Editor/file_formats/pge_x.cpp \
     ../Editor/file_formats/smbx64.cpp \
     ../Editor/file_formats/wld_filedata.cpp \
+    ../Editor/networking/intproc_proto.cpp \
     physics/base_object.cpp \
     physics/phys_util.cpp \
     graphics/lvl_camera.cpp \
@@ -124,6 +128,7 @@ SOURCES += main.cpp \
     scenes/scene_gameover.cpp \
     scenes/scene_intro.cpp \
     graphics/gl_renderer.cpp \
+    graphics/quad_buffer.cpp \
     graphics/window.cpp \
     graphics/graphics_lvl_backgrnd.cpp \
     controls/controllable_object.cpp \
@@ -133,9 +138,16 @@ SOURCES += main.cpp \
     data_configs/config_manager.cpp \
     common_features/app_path.cpp \
     common_features/graphics_funcs.cpp \
-    ../_Libs/EasyBMP/EasyBMP.cpp \
+    common_features/texture_cache.cpp \
+    common_features/bench_runner.cpp \
+    common_features/level_prefetch.cpp \
+    common_features/timer_scheduler.cpp \
+    ../_common/mask_blend.cpp \
+    ../_common/bmp_reader.cpp \
     data_configs/obj_block.cpp \
     controls/controller_keyboard.cpp \
+    controls/controller_replay.cpp \
+    controls/input_record.cpp \
     data_configs/select_config.cpp \
     common_features/util.cpp \
     scenes/level/lvl_block.cpp \
@@ -145,7 +157,10 @@ SOURCES += main.cpp \
     data_configs/config_textures.cpp \
     data_configs/obj_bgo.cpp \
     scenes/level/lvl_bgo.cpp \
+    scenes/level/lvl_npc.cpp \
+    scenes/level/lvl_npc_activator.cpp \
     data_configs/obj_bg.cpp \
+    data_configs/config_cache.cpp \
     physics/contact_listener.cpp \
     scenes/level/lvl_warp.cpp \
     scenes/level/lvl_scene_ptr.cpp \
@@ -213,8 +228,10 @@ HEADERS  += \
     ../_Libs/Box2D/Rope/b2Rope.h \
     ../Editor/file_formats/file_formats.h \
     ../Editor/file_formats/lvl_filedata.h \
+    ../Editor/file_formats/lvl_sort.h \
     ../Editor/file_formats/npc_filedata.h \
     ../Editor/file_formats/wld_filedata.h \
+    ../Editor/networking/intproc_proto.h \
     physics/base_object.h \
     physics/phys_util.h \
     graphics/lvl_camera.h \
@@ -227,6 +244,7 @@ HEADERS  += \
     scenes/scene_gameover.h \
     scenes/scene_intro.h \
     graphics/gl_renderer.h \
+    graphics/quad_buffer.h \
     graphics/window.h \
     controls/controllable_object.h \
     controls/controller.h \
@@ -236,12 +254,16 @@ HEADERS  += \
     data_configs/obj_block.h \
     common_features/app_path.h \
     common_features/graphics_funcs.h \
+    common_features/texture_cache.h \
+    common_features/bench_runner.h \
+    common_features/level_prefetch.h \
+    common_features/timer_scheduler.h \
+    ../_common/mask_blend.h \
     common_features/pge_texture.h \
-    ../_Libs/EasyBMP/EasyBMP.h \
-    ../_Libs/EasyBMP/EasyBMP_BMP.h \
-    ../_Libs/EasyBMP/EasyBMP_DataStructures.h \
-    ../_Libs/EasyBMP/EasyBMP_VariousBMPutilities.h \
+    ../_common/bmp_reader.h \
     controls/controller_keyboard.h \
+    controls/controller_replay.h \
+    controls/input_record.h \
     data_configs/select_config.h \
     common_features/util.h \
     scenes/level/lvl_block.h \
@@ -249,7 +271,10 @@ HEADERS  += \
     common_features/simple_animator.h \
     data_configs/obj_bgo.h \
     scenes/level/lvl_bgo.h \
+    scenes/level/lvl_npc.h \
+    scenes/level/lvl_npc_activator.h \
     data_configs/obj_bg.h \
+    data_configs/config_index.h \
     graphics/graphics_lvl_backgrnd.h \
     version.h \
     physics/contact_listener.h \
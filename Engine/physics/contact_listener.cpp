@@ -233,11 +233,17 @@ void PGEContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManif
 
         if(platformFixture)
         {
+            //NPCs are also dynamic bodies, only players are having ground and bump states
+            LVL_Player *player = (bodyChar->type == PGE_Phys_Object::LVLPlayer) ?
+                                  dynamic_cast<LVL_Player *>(bodyChar) : NULL;
             if(bodyChar->physBody->GetLinearVelocity().y>10 && bodyChar->bottom() < bodyBlock->top()+10)
             {
                 contact->SetEnabled(true);
-                dynamic_cast<LVL_Player *>(bodyChar)->onGround=true;
-                dynamic_cast<LVL_Player *>(bodyChar)->foot_contacts++;
+                if(player)
+                {
+                    player->onGround=true;
+                    player->foot_contacts++;
+                }
             }
             else if( (bodyChar->bottom() > bodyBlock->top()+2) )
             {
@@ -264,6 +270,9 @@ void PGEContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManif
 
             if(platformFixture)
             {
+                LVL_Player *player = (bodyChar->type == PGE_Phys_Object::LVLPlayer) ?
+                                      dynamic_cast<LVL_Player *>(bodyChar) : NULL;
+
                 if(dynamic_cast<LVL_Block *>(bodyBlock)->destroyed)
                 {
                         contact->SetEnabled(false);
@@ -271,19 +280,21 @@ void PGEContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManif
                 }
 
 
-                if(bodyChar->top() >= bodyBlock->bottom() && bodyChar->top() <= bodyBlock->bottom()+3
+                //Blocks are hitten by players only
+                if(player && bodyChar->top() >= bodyBlock->bottom() && bodyChar->top() <= bodyBlock->bottom()+3
                         && bodyChar->physBody->GetLinearVelocity().y < -0.01 )
                 {
                     if(dynamic_cast<LVL_Block *>(bodyBlock)->setup->hitable)
                     {
-                        dynamic_cast<LVL_Player *>(bodyChar)->bump();
+                        player->bump();
                     }
                     dynamic_cast<LVL_Block *>(bodyBlock)->hit();
                 }
 
                 if(dynamic_cast<LVL_Block *>(bodyBlock)->destroyed)
                 {
-                        dynamic_cast<LVL_Player *>(bodyChar)->bump();
+                        if(player)
+                            player->bump();
                         contact->SetEnabled(false);
                         return;
                 }
@@ -296,13 +307,13 @@ void PGEContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManif
 
                 if(bodyBlock->isRectangle)
                 {
-                    if( bodyChar->bottom() <= bodyBlock->top() && bodyChar->bottom() <= bodyBlock->top()+3 )
+                    if( player && bodyChar->bottom() <= bodyBlock->top() && bodyChar->bottom() <= bodyBlock->top()+3 )
                     {
-                        dynamic_cast<LVL_Player *>(bodyChar)->onGround=true;
+                        player->onGround=true;
 
                         if(dynamic_cast<LVL_Block *>(bodyBlock)->setup->bounce)
                         {
-                            dynamic_cast<LVL_Player *>(bodyChar)->bump(true);
+                            player->bump(true);
                             dynamic_cast<LVL_Block *>(bodyBlock)->hit(LVL_Block::down);
                         }
                     }
@@ -314,8 +325,9 @@ void PGEContactListener::PreSolve(b2Contact *contact, const b2Manifold *oldManif
                     }
                 }
                 else
+                if(player)
                 {
-                    dynamic_cast<LVL_Player *>(bodyChar)->onGround=true;
+                    player->onGround=true;
                 }
             }
         }
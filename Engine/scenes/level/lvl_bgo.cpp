@@ -23,6 +23,7 @@ LVL_Bgo::LVL_Bgo()
 {
     type = LVLBGO;
     data = NULL;
+    array_id = 0;
     animated=false;
     animator_ID=0;
 }
@@ -78,7 +79,7 @@ void LVL_Bgo::render(float camX, float camY)
     AniPos x(0,1);
 
     if(animated) //Get current animated frame
-        x = ConfigManager::Animator_BGO[animator_ID].image();
+        x = ConfigManager::Animator_BGO[animator_ID]->image();
 
     glEnable(GL_TEXTURE_2D);
     glColor4f( 1.f, 1.f, 1.f, 1.f);
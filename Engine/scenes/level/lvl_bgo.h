@@ -31,7 +31,8 @@ public:
     ~LVL_Bgo();
     void init();
 
-    LevelBGO* data; //Local settings
+    LevelBGO* data; //Local settings, valid while item is placed
+    unsigned int array_id; //Array-ID of this item in the level file
 
     bool animated;
     long animator_ID;
@@ -20,11 +20,13 @@
 #include "../../data_configs/config_manager.h"
 
 #include "lvl_scene_ptr.h"
+#include "../../graphics/window.h"
 
 LVL_Block::LVL_Block()
 {
     type = LVLBlock;
     data = NULL;
+    array_id = 0;
     animated=false;
     sizable=false;
     animator_ID=0;
@@ -34,10 +36,22 @@ LVL_Block::LVL_Block()
 
     isHidden=false;
     destroyed=false;
+
+    fixedX = 0.f;
+    fixedY = 0.f;
+    canMerge = false;
+    mergedInto = NULL;
+
+    fader_timer_id = 0;
+
+    meshWidth = 0.f;
+    meshHeight = 0.f;
+    meshTexture = 0;
 }
 
 LVL_Block::~LVL_Block()
 {
+    TimerScheduler::remove(fader_timer_id);
     if(physBody && worldPtr)
     {
       worldPtr->DestroyBody(physBody);
@@ -46,15 +60,24 @@ LVL_Block::~LVL_Block()
     }
 }
 
-//float LVL_Block::posX()
-//{
-//    return data->x;
-//}
+float LVL_Block::posX()
+{
+    if(physBody)
+        return PGE_Phys_Object::posX();
+    return fixedX;
+}
 
-//float LVL_Block::posY()
-//{
-//    return data->y;
-//}
+float LVL_Block::posY()
+{
+    if(physBody)
+        return PGE_Phys_Object::posY();
+    return fixedY;
+}
+
+int LVL_Block::mergeClass()
+{
+    return ((setup->view==1) ? 2 : 0) | (slippery ? 1 : 0);
+}
 
 void LVL_Block::init()
 {
@@ -77,11 +100,29 @@ void LVL_Block::init()
         collide = COLLISION_NONE;
     }
 
+    fixedX = data->x;
+    fixedY = data->y;
+
+    canMerge = (setup->collision==1) && !setup->sizable &&
+               (qAbs(setup->phys_shape)!=1) && (qAbs(setup->phys_shape)!=2) &&
+               !setup->hitable && !setup->bounce && !setup->destroyable &&
+               !setup->destroyable_by_bomb && !setup->destroyable_by_fireball &&
+               !setup->spawn && !setup->lava && (setup->danger==0) && (setup->algorithm==0) &&
+               !data->invisible && (data->npc_id==0) &&
+               data->event_destroy.isEmpty() && data->event_hit.isEmpty() && data->event_no_more.isEmpty();
+
+    if(setup->algorithm==3)
+        ConfigManager::Animator_Blocks[animator_ID]->setFrames(1, -1);
+
+    initPhysics();
+}
 
+void LVL_Block::initPhysics()
+{
     b2BodyDef bodyDef;
     bodyDef.type = b2_staticBody;
-    bodyDef.position.Set( PhysUtil::pix2met( data->x+posX_coefficient ),
-        PhysUtil::pix2met(data->y + posY_coefficient ) );
+    bodyDef.position.Set( PhysUtil::pix2met( fixedX+posX_coefficient ),
+        PhysUtil::pix2met( fixedY+posY_coefficient ) );
     bodyDef.userData = (void*)dynamic_cast<PGE_Phys_Object *>(this);
     physBody = worldPtr->CreateBody(&bodyDef);
 
@@ -153,21 +194,31 @@ void LVL_Block::init()
     b2Fixture * block = physBody->CreateFixture(&shape, 1.0f);
 
     if(setup->algorithm==3)
-        {
-            block->SetSensor(true);
-            ConfigManager::Animator_Blocks[animator_ID].setFrames(1, -1);
-        }
+        block->SetSensor(true);
 
     if(collide==COLLISION_NONE)// || collide==COLLISION_TOP)
         block->SetSensor(true);
 
-    block->SetFriction(data->slippery? 0.04f : 0.25f );
+    block->SetFriction(slippery? 0.04f : 0.25f );
 
 }
 
 
 void LVL_Block::render(float camX, float camY)
 {
+    //Merged block has no own image, it draws blocks which it stands for
+    if(!mergedBlocks.isEmpty())
+    {
+        foreach(LVL_Block *block, mergedBlocks)
+        {
+            if((block->right() < camX) || (block->left() > camX+PGE_Window::Width) ||
+               (block->bottom() < camY) || (block->top() > camY+PGE_Window::Height))
+                continue;
+            block->render(camX, camY);
+        }
+        return;
+    }
+
     //Don't draw hidden block before it will be hitten
     if(isHidden) return;
     if(destroyed) return;
@@ -181,7 +232,7 @@ void LVL_Block::render(float camX, float camY)
     AniPos x(0,1);
 
     if(animated) //Get current animated frame
-        x = ConfigManager::Animator_Blocks[animator_ID].image();
+        x = ConfigManager::Animator_Blocks[animator_ID]->image();
 
     glEnable(GL_TEXTURE_2D);
     glColor4f( 1.f, 1.f, 1.f, 1.f);
@@ -192,180 +243,172 @@ void LVL_Block::render(float camX, float camY)
 
     if(sizable)
     {
-        int w = width;
-        int h = height;
+        if((meshWidth != width) || (meshHeight != height) || (meshTexture != texId))
+            buildSizableMesh();
 
-        int x,y, i, j;
-        int hc, wc;
+        glPushMatrix();
+        glTranslatef(blockG.x(), blockG.y(), 0.0f);
+        sizableMesh.draw();
+        glPopMatrix();
+    }
+    else
+    {
+        glBegin( GL_QUADS );
+            glTexCoord2f( 0, x.first );
+            glVertex2f( blockG.left(), blockG.top());
+
+            glTexCoord2f( 1, x.first );
+            glVertex2f(  blockG.right(), blockG.top());
+
+            glTexCoord2f( 1, x.second );
+            glVertex2f(  blockG.right(),  blockG.bottom());
+
+            glTexCoord2f( 0, x.second );
+            glVertex2f( blockG.left(),  blockG.bottom());
+        glEnd();
+    }
+
+    glDisable(GL_TEXTURE_2D);
+}
+
+void LVL_Block::buildSizableMesh()
+{
+    sizableMesh.clear();
+    meshWidth = width;
+    meshHeight = height;
+    meshTexture = texId;
 
-        x = qRound(qreal(texture.w)/3);  // Width of one piece
-        y = qRound(qreal(texture.h)/3); // Height of one piece
+    int w = width;
+    int h = height;
 
-        int fLnt = 0; // Free Lenght
-        int fWdt = 0; // Free Width
+    int x,y, i, j;
+    int hc, wc;
 
-        int dX=0; //Draw Offset. This need for crop junk on small sizes
-        int dY=0;
+    x = qRound(qreal(texture.w)/3);  // Width of one piece
+    y = qRound(qreal(texture.h)/3); // Height of one piece
 
-        if(w < 2*x) dX = (2*x-w)/2; else dX=0;
-        if(h < 2*y) dY = (2*y-h)/2; else dY=0;
+    int fLnt = 0; // Free Lenght
+    int fWdt = 0; // Free Width
 
-        //L Draw left border
-        if(h > 2*y)
+    int dX=0; //Draw Offset. This need for crop junk on small sizes
+    int dY=0;
+
+    if(w < 2*x) dX = (2*x-w)/2; else dX=0;
+    if(h < 2*y) dY = (2*y-h)/2; else dY=0;
+
+    //L Draw left border
+    if(h > 2*y)
+    {
+        hc=0;
+        for(i=0; i<((h-2*y) / y); i++ )
         {
-            hc=0;
-            for(i=0; i<((h-2*y) / y); i++ )
-            {
-                drawPiece(blockG, QRectF(0, x+hc, x-dX, y), QRectF(0, y, x-dX, y));
-                hc+=x;
-            }
-                fLnt = (h-2*y)%y;
-                if( fLnt != 0)
-                    drawPiece(blockG, QRectF(0, x+hc, x-dX, fLnt), QRectF(0, y, x-dX, fLnt));
+            addPiece(QRectF(0, x+hc, x-dX, y), QRectF(0, y, x-dX, y));
+            hc+=x;
         }
+            fLnt = (h-2*y)%y;
+            if( fLnt != 0)
+                addPiece(QRectF(0, x+hc, x-dX, fLnt), QRectF(0, y, x-dX, fLnt));
+    }
 
-        //T Draw top border
-        if(w > 2*x)
+    //T Draw top border
+    if(w > 2*x)
+    {
+        hc=0;
+        for(i=0; i<( (w-2*x) / x); i++ )
         {
-            hc=0;
-            for(i=0; i<( (w-2*x) / x); i++ )
-            {
-                drawPiece(blockG, QRectF(x+hc, 0, x, y-dY), QRectF(x, 0, x, y-dY));
-                    hc+=x;
-            }
-                fLnt = (w-2*x)%x;
-                if( fLnt != 0)
-                    drawPiece(blockG, QRectF(x+hc, 0, fLnt, y-dY), QRectF(x, 0, fLnt, y-dY));
+            addPiece(QRectF(x+hc, 0, x, y-dY), QRectF(x, 0, x, y-dY));
+                hc+=x;
         }
+            fLnt = (w-2*x)%x;
+            if( fLnt != 0)
+                addPiece(QRectF(x+hc, 0, fLnt, y-dY), QRectF(x, 0, fLnt, y-dY));
+    }
 
-        //B Draw bottom border
-        if(w > 2*x)
+    //B Draw bottom border
+    if(w > 2*x)
+    {
+        hc=0;
+        for(i=0; i< ( (w-2*x) / x); i++ )
         {
-            hc=0;
-            for(i=0; i< ( (w-2*x) / x); i++ )
-            {
-                drawPiece(blockG, QRectF(x+hc, h-y+dY, x, y-dY), QRectF(x, texture.w-y+dY, x, y-dY));
-                    hc+=x;
-            }
-                fLnt = (w-2*x)%x;
-                if( fLnt != 0)
-                    drawPiece(blockG, QRectF(x+hc, h-y+dY, fLnt, y-dY), QRectF(x, texture.w-y+dY, fLnt, y-dY));
+            addPiece(QRectF(x+hc, h-y+dY, x, y-dY), QRectF(x, texture.w-y+dY, x, y-dY));
+                hc+=x;
         }
+            fLnt = (w-2*x)%x;
+            if( fLnt != 0)
+                addPiece(QRectF(x+hc, h-y+dY, fLnt, y-dY), QRectF(x, texture.w-y+dY, fLnt, y-dY));
+    }
 
-        //R Draw right border
-        if(h > 2*y)
+    //R Draw right border
+    if(h > 2*y)
+    {
+        hc=0;
+        for(i=0; i<((h-2*y) / y); i++ )
         {
-            hc=0;
-            for(i=0; i<((h-2*y) / y); i++ )
-            {
-                drawPiece(blockG, QRectF(w-x+dX, y+hc, x-dX, y), QRectF(texture.w-x+dX, y, x-dX, y));
-                    hc+=x;
-            }
-                fLnt = (h-2*y)%y;
-                if( fLnt != 0)
-                    drawPiece(blockG, QRectF(w-x+dX, y+hc, x-dX, fLnt), QRectF(texture.w-x+dX, y, x-dX, fLnt));
+            addPiece(QRectF(w-x+dX, y+hc, x-dX, y), QRectF(texture.w-x+dX, y, x-dX, y));
+                hc+=x;
         }
+            fLnt = (h-2*y)%y;
+            if( fLnt != 0)
+                addPiece(QRectF(w-x+dX, y+hc, x-dX, fLnt), QRectF(texture.w-x+dX, y, x-dX, fLnt));
+    }
 
 
-        //C Draw center
-        if( w > 2*x && h > 2*y)
+    //C Draw center
+    if( w > 2*x && h > 2*y)
+    {
+        hc=0;
+        wc=0;
+        for(i=0; i<((h-2*y) / y); i++ )
         {
             hc=0;
-            wc=0;
-            for(i=0; i<((h-2*y) / y); i++ )
+            for(j=0; j<((w-2*x) / x); j++ )
             {
-                hc=0;
-                for(j=0; j<((w-2*x) / x); j++ )
-                {
-                    drawPiece(blockG, QRectF(x+hc, y+wc, x, y), QRectF(x, y, x, y));
-                    hc+=x;
-                }
-                    fLnt = (w-2*x)%x;
-                    if(fLnt != 0 )
-                        drawPiece(blockG, QRectF(x+hc, y+wc, fLnt, y), QRectF(x, y, fLnt, y));
-                wc+=y;
+                addPiece(QRectF(x+hc, y+wc, x, y), QRectF(x, y, x, y));
+                hc+=x;
             }
+                fLnt = (w-2*x)%x;
+                if(fLnt != 0 )
+                    addPiece(QRectF(x+hc, y+wc, fLnt, y), QRectF(x, y, fLnt, y));
+            wc+=y;
+        }
 
-            fWdt = (h-2*y)%y;
-            if(fWdt !=0)
+        fWdt = (h-2*y)%y;
+        if(fWdt !=0)
+        {
+            hc=0;
+            for(j=0; j<((w-2*x) / x); j++ )
             {
-                hc=0;
-                for(j=0; j<((w-2*x) / x); j++ )
-                {
-                    drawPiece(blockG, QRectF(x+hc, y+wc, x, y), QRectF(x, y, x, y));
-                    hc+=x;
-                }
-                    fLnt = (w-2*x)%x;
-                    if(fLnt != 0 )
-                        drawPiece(blockG, QRectF(x+hc, y+wc, fLnt, fWdt), QRectF(x, y, fLnt, fWdt));
+                addPiece(QRectF(x+hc, y+wc, x, y), QRectF(x, y, x, y));
+                hc+=x;
             }
-
+                fLnt = (w-2*x)%x;
+                if(fLnt != 0 )
+                    addPiece(QRectF(x+hc, y+wc, fLnt, fWdt), QRectF(x, y, fLnt, fWdt));
         }
 
-        //Draw corners
-         //1 Left-top
-        drawPiece(blockG, QRectF(0,0,x-dX,y-dY), QRectF(0,0,x-dX, y-dY));
-         //2 Right-top
-        drawPiece(blockG, QRectF(w-x+dX, 0, x-dX, y-dY), QRectF(texture.w-x+dX, 0, x-dX, y-dY));
-         //3 Right-bottom
-        drawPiece(blockG, QRectF(w-x+dX, h-y+dY, x-dX, y-dY), QRectF(texture.w-x+dX, texture.h-y+dY, x-dX, y-dY));
-         //4 Left-bottom
-        drawPiece(blockG, QRectF(0, h-y+dY, x-dX, y-dY), QRectF(0, texture.h-y+dY, x-dX, y-dY));
-
-    }
-    else
-    {
-        glBegin( GL_QUADS );
-            glTexCoord2f( 0, x.first );
-            glVertex2f( blockG.left(), blockG.top());
-
-            glTexCoord2f( 1, x.first );
-            glVertex2f(  blockG.right(), blockG.top());
-
-            glTexCoord2f( 1, x.second );
-            glVertex2f(  blockG.right(),  blockG.bottom());
-
-            glTexCoord2f( 0, x.second );
-            glVertex2f( blockG.left(),  blockG.bottom());
-        glEnd();
     }
 
-    glDisable(GL_TEXTURE_2D);
+    //Draw corners
+     //1 Left-top
+    addPiece(QRectF(0,0,x-dX,y-dY), QRectF(0,0,x-dX, y-dY));
+     //2 Right-top
+    addPiece(QRectF(w-x+dX, 0, x-dX, y-dY), QRectF(texture.w-x+dX, 0, x-dX, y-dY));
+     //3 Right-bottom
+    addPiece(QRectF(w-x+dX, h-y+dY, x-dX, y-dY), QRectF(texture.w-x+dX, texture.h-y+dY, x-dX, y-dY));
+     //4 Left-bottom
+    addPiece(QRectF(0, h-y+dY, x-dX, y-dY), QRectF(0, texture.h-y+dY, x-dX, y-dY));
 }
 
-void LVL_Block::drawPiece(QRectF target, QRectF block, QRectF texture)
+void LVL_Block::addPiece(QRectF block, QRectF texture)
 {
-    QRectF tx;
-    tx.setLeft(texture.left()/this->texture.w);
-    tx.setRight(texture.right()/this->texture.w);
-    tx.setTop(texture.top()/this->texture.h);
-    tx.setBottom(texture.bottom()/this->texture.h);
-
-    QRectF blockG;
-    blockG.setX(target.x()+block.x());
-    blockG.setY(target.y()+block.y());
-    blockG.setRight(target.x()+block.x()+block.width());
-    blockG.setBottom(target.y()+block.y()+block.height());
-
-    glBegin( GL_QUADS );
-        glTexCoord2f( tx.left(), tx.top() );
-        glVertex2f( blockG.left(), blockG.top());
-
-        glTexCoord2f( tx.right(), tx.top() );
-        glVertex2f(  blockG.right(), blockG.top());
-
-        glTexCoord2f( tx.right(), tx.bottom() );
-        glVertex2f(  blockG.right(),  blockG.bottom());
-
-        glTexCoord2f( tx.left(), tx.bottom() );
-        glVertex2f( blockG.left(),  blockG.bottom());
-    glEnd();
-
+    sizableMesh.addQuad(block,
+                        texture.left()/this->texture.w,
+                        texture.top()/this->texture.h,
+                        texture.right()/this->texture.w,
+                        texture.bottom()/this->texture.h);
 }
 
 
-
-
 void LVL_Block::hit(LVL_Block::directions _dir)
 {
     hitDirection = _dir;
@@ -392,8 +435,8 @@ void LVL_Block::setFade(int speed, float target, float step)
     targetOffset = target;
     fadeSpeed = speed;
 
-    fader_timer_id = SDL_AddTimer(speed, &LVL_Block::nextOpacity, this);
-    if(!fader_timer_id) fadeOffset = targetOffset;
+    TimerScheduler::remove(fader_timer_id);
+    fader_timer_id = TimerScheduler::add(speed, &LVL_Block::nextOpacity, this);
 }
 
 unsigned int LVL_Block::nextOpacity(unsigned int x, void *p)
@@ -401,7 +444,7 @@ unsigned int LVL_Block::nextOpacity(unsigned int x, void *p)
     Q_UNUSED(x);
     LVL_Block *self = reinterpret_cast<LVL_Block *>(p);
     self->fadeStep();
-    return 0;
+    return self->fadeSpeed;
 }
 
 void LVL_Block::fadeStep()
@@ -413,15 +456,11 @@ void LVL_Block::fadeStep()
 
     if(fadeOffset>=1.0f || fadeOffset<=0.0f)
     {
-        SDL_RemoveTimer(fader_timer_id);
+        TimerScheduler::remove(fader_timer_id);
+        fader_timer_id = 0;
         if(fadeOffset>=1.0f)
             setFade(fadeSpeed, 0.0f, fade_step);
     }
-    else
-        {
-            fader_timer_id = SDL_AddTimer(fadeSpeed, &LVL_Block::nextOpacity, this);
-            if(!fader_timer_id) fadeOffset = targetOffset;
-        }
 
     if(fadeOffset>1.0f) fadeOffset = 1.0f;
     else
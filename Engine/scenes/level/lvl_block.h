@@ -24,7 +24,9 @@
 
 #include <file_formats.h>
 
-#include <SDL2/SDL_timer.h>
+#include "../../common_features/timer_scheduler.h"
+#include "../../graphics/quad_buffer.h"
+#include <QVector>
 
 class LVL_Block : public PGE_Phys_Object
 {
@@ -32,8 +34,11 @@ public:
     LVL_Block();
     ~LVL_Block();
     void init();
+    //! Creates physical body at fixedX, fixedY
+    void initPhysics();
 
-    LevelBlock* data; //Local settings
+    LevelBlock* data; //Local settings, valid while item is placed
+    unsigned int array_id; //Array-ID of this item in the level file
     bool slippery;
 
     bool animated;
@@ -66,14 +71,29 @@ public:
     void setFade(int speed, float target, float step);
     static unsigned int nextOpacity(unsigned int x, void *p);
     void fadeStep();
-    SDL_TimerID fader_timer_id;
+    int fader_timer_id;
     /**************Fader**************/
 
-    //float posX();
-    //float posY();
+    float posX();
+    float posY();
     void render(float camX, float camY);
+
+    /**************Merged collision**************/
+    float fixedX; //Position of block without own physical body
+    float fixedY;
+    bool canMerge; //Solid rectangle without any reaction on hits, may share body with neighbours
+    int mergeClass();
+    LVL_Block *mergedInto; //Merged block which has collision of this block
+    QVector<LVL_Block* > mergedBlocks; //Blocks which collision is merged into this one
+    /**************Merged collision**************/
 private:
-    void drawPiece(QRectF target, QRectF block, QRectF texture);
+    //! Makes 9-slice pieces of sizable block, it's done when size or texture was changed
+    void buildSizableMesh();
+    void addPiece(QRectF block, QRectF texture);
+    QuadBuffer sizableMesh; //Pieces of sizable block relative to it's top-left corner
+    float meshWidth;
+    float meshHeight;
+    GLuint meshTexture;
 };
 
 #endif // LVL_BLOCK_H
@@ -0,0 +1,108 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lvl_npc.h"
+#include "../../graphics/window.h"
+
+LVL_Npc::LVL_Npc()
+{
+    type = LVLNPC;
+    isActivated = false;
+    activationTimeout = 0;
+}
+
+LVL_Npc::~LVL_Npc()
+{
+    if(physBody && worldPtr)
+    {
+      worldPtr->DestroyBody(physBody);
+      physBody->SetUserData(NULL);
+      physBody = NULL;
+    }
+}
+
+void LVL_Npc::init()
+{
+    if(!worldPtr) return;
+    //Size will be taken from NPC config
+    setSize(32, 32);
+
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.position.Set( PhysUtil::pix2met( data.x+posX_coefficient ),
+        PhysUtil::pix2met(data.y + posY_coefficient ) );
+    bodyDef.fixedRotation = true;
+    bodyDef.active = false; //Sleeps until any camera will find it
+    bodyDef.userData = (void*)dynamic_cast<PGE_Phys_Object *>(this);
+    physBody = worldPtr->CreateBody(&bodyDef);
+
+    b2PolygonShape shape;
+    shape.SetAsBox(PhysUtil::pix2met(posX_coefficient), PhysUtil::pix2met(posY_coefficient) );
+
+    b2FixtureDef fixtureDef;
+    fixtureDef.shape = &shape;
+    fixtureDef.density = 1.0f; fixtureDef.friction = 0.3f;
+    physBody->CreateFixture(&fixtureDef);
+}
+
+void LVL_Npc::activate(int timeout)
+{
+    activationTimeout = timeout;
+    if(isActivated) return;
+    isActivated = true;
+    if(physBody)
+        physBody->SetActive(true);
+}
+
+void LVL_Npc::deActivate()
+{
+    isActivated = false;
+    activationTimeout = 0;
+    if(!physBody) return;
+
+    //Like in SMBX, NPC appears again at initial position
+    physBody->SetLinearVelocity(b2Vec2(0.0f, 0.0f));
+    setPos(data.x, data.y);
+    physBody->SetActive(false);
+}
+
+void LVL_Npc::update()
+{
+    if(!isActivated) return;
+    //NPC's AI will be here
+}
+
+void LVL_Npc::render(float camX, float camY)
+{
+    //Until NPC configs are loaded, NPCs are visible in the debug mode only
+    if(!PGE_Window::showDebugInfo) return;
+
+    QRectF npcG = QRectF(posX()-camX,
+                         posY()-camY,
+                         width,
+                         height);
+
+    glDisable(GL_TEXTURE_2D);
+    glColor4f( 1.f, 0.f, 1.f, 0.5f);
+    glBegin( GL_QUADS );
+        glVertex2f( npcG.left(), npcG.top());
+        glVertex2f( npcG.right(), npcG.top());
+        glVertex2f( npcG.right(), npcG.bottom());
+        glVertex2f( npcG.left(), npcG.bottom());
+    glEnd();
+}
@@ -0,0 +1,46 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LVL_NPC_H
+#define LVL_NPC_H
+
+#include "../../physics/base_object.h"
+
+#include <file_formats.h>
+
+class LVL_Npc : public PGE_Phys_Object
+{
+public:
+    LVL_Npc();
+    ~LVL_Npc();
+    void init();
+
+    LevelNPC data; //Local settings
+
+    /**************Activation**************/
+    bool isActivated;
+    int activationTimeout; //!< Milliseconds left before NPC out of cameras goes sleep
+    void activate(int timeout);
+    void deActivate(); //!< Returns NPC to initial position and excludes it from physics
+    /**************Activation**************/
+
+    void update();
+    void render(float camX, float camY);
+};
+
+#endif // LVL_NPC_H
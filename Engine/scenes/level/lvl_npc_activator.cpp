@@ -0,0 +1,197 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "lvl_npc_activator.h"
+
+#include <math.h>
+
+LVL_NpcActivator::LVL_NpcActivator()
+{
+    timeout = 3000;
+    padding = 128;
+}
+
+void LVL_NpcActivator::setTimeout(int ms)
+{
+    timeout = ms;
+}
+
+void LVL_NpcActivator::setPadding(int px)
+{
+    padding = px;
+}
+
+long LVL_NpcActivator::cellOf(float v)
+{
+    return (long)floor(v / (float)cellSize);
+}
+
+quint64 LVL_NpcActivator::cellKey(long x, long y)
+{
+    return (quint64(quint32(x)) << 32) | quint64(quint32(y));
+}
+
+void LVL_NpcActivator::addNpc(LVL_Npc *npc)
+{
+    if(npc->isActivated)
+        active.push_back(npc);
+    else
+        sleeping[cellKey(cellOf(npc->data.x), cellOf(npc->data.y))].push_back(npc);
+}
+
+void LVL_NpcActivator::removeNpc(LVL_Npc *npc)
+{
+    int i = active.indexOf(npc);
+    if(i >= 0) { active.remove(i); return; }
+
+    i = waiting.indexOf(npc);
+    if(i >= 0) { waiting.remove(i); return; }
+
+    quint64 key = cellKey(cellOf(npc->data.x), cellOf(npc->data.y));
+    QHash<quint64, QVector<LVL_Npc *> >::iterator it = sleeping.find(key);
+    if(it != sleeping.end())
+    {
+        i = it.value().indexOf(npc);
+        if(i >= 0) it.value().remove(i);
+        if(it.value().isEmpty())
+            sleeping.erase(it);
+    }
+}
+
+void LVL_NpcActivator::clear()
+{
+    sleeping.clear();
+    active.clear();
+    waiting.clear();
+}
+
+const QVector<LVL_Npc *> &LVL_NpcActivator::activeNpcs()
+{
+    return active;
+}
+
+bool LVL_NpcActivator::intersects(const Region &r, float left, float top, float right, float bottom)
+{
+    return (left < r.right) && (right > r.left) && (top < r.bottom) && (bottom > r.top);
+}
+
+bool LVL_NpcActivator::inRegions(float left, float top, float right, float bottom)
+{
+    for(int i = 0; i < regions.size(); i++)
+        if(intersects(regions[i], left, top, right, bottom))
+            return true;
+    return false;
+}
+
+bool LVL_NpcActivator::spawnInRegions(LVL_Npc *npc)
+{
+    return inRegions(npc->data.x, npc->data.y, npc->data.x+npc->width, npc->data.y+npc->height);
+}
+
+void LVL_NpcActivator::putToSleep(LVL_Npc *npc)
+{
+    npc->deActivate();
+    if(spawnInRegions(npc))
+        waiting.push_back(npc);
+    else
+        sleeping[cellKey(cellOf(npc->data.x), cellOf(npc->data.y))].push_back(npc);
+}
+
+void LVL_NpcActivator::update(const QVector<PGE_LevelCamera *> &cameras, int ticks)
+{
+    regions.resize(cameras.size());
+    for(int i = 0; i < cameras.size(); i++)
+    {
+        regions[i].left   = cameras[i]->posX() - padding;
+        regions[i].top    = cameras[i]->posY() - padding;
+        regions[i].right  = cameras[i]->posX() + cameras[i]->w() + padding;
+        regions[i].bottom = cameras[i]->posY() + cameras[i]->h() + padding;
+    }
+
+    //Awake NPCs: keep alive while they are seen, otherwise count down
+    for(int i = 0; i < active.size(); )
+    {
+        LVL_Npc *npc = active[i];
+        if(inRegions(npc->left(), npc->top(), npc->right(), npc->bottom()))
+            npc->activationTimeout = timeout;
+        else
+            npc->activationTimeout -= ticks;
+
+        if(npc->activationTimeout <= 0)
+        {
+            active[i] = active.last();
+            active.pop_back();
+            putToSleep(npc);
+            continue;
+        }
+        i++;
+    }
+
+    //Initial position of NPC must leave the cameras before it can be waked again
+    for(int i = 0; i < waiting.size(); )
+    {
+        LVL_Npc *npc = waiting[i];
+        if(!spawnInRegions(npc))
+        {
+            waiting[i] = waiting.last();
+            waiting.pop_back();
+            sleeping[cellKey(cellOf(npc->data.x), cellOf(npc->data.y))].push_back(npc);
+            continue;
+        }
+        i++;
+    }
+
+    //Wake NPCs from cells under the cameras
+    for(int r = 0; r < regions.size(); r++)
+    {
+        //Sleeping NPC is found by its top-left corner, so cells at the left and at the top are also checked
+        long cx1 = cellOf(regions[r].left - cellSize);
+        long cy1 = cellOf(regions[r].top - cellSize);
+        long cx2 = cellOf(regions[r].right);
+        long cy2 = cellOf(regions[r].bottom);
+
+        for(long cy = cy1; cy <= cy2; cy++)
+        {
+            for(long cx = cx1; cx <= cx2; cx++)
+            {
+                QHash<quint64, QVector<LVL_Npc *> >::iterator it = sleeping.find(cellKey(cx, cy));
+                if(it == sleeping.end())
+                    continue;
+
+                QVector<LVL_Npc *> &cell = it.value();
+                for(int i = 0; i < cell.size(); )
+                {
+                    LVL_Npc *npc = cell[i];
+                    if(!intersects(regions[r], npc->data.x, npc->data.y,
+                                   npc->data.x+npc->width, npc->data.y+npc->height))
+                    {
+                        i++;
+                        continue;
+                    }
+                    cell[i] = cell.last();
+                    cell.pop_back();
+                    npc->activate(timeout);
+                    active.push_back(npc);
+                }
+
+                if(cell.isEmpty())
+                    sleeping.erase(it);
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LVL_NPC_ACTIVATOR_H
+#define LVL_NPC_ACTIVATOR_H
+
+#include "lvl_npc.h"
+#include "../../graphics/lvl_camera.h"
+
+#include <QVector>
+#include <QHash>
+
+///
+/// \brief Wakes NPCs which are near to the cameras and sends to sleep forgotten NPCs
+///
+/// Sleeping NPCs are kept in the grid by their initial positions, so waking
+/// costs only the cells under the expanded camera rectangles. Awake NPC which
+/// stays out of all cameras longer than timeout is returned to the initial
+/// position and goes sleep. It can be waked up again only when its initial
+/// position will leave the cameras (as in SMBX).
+///
+class LVL_NpcActivator
+{
+public:
+    LVL_NpcActivator();
+
+    void setTimeout(int ms);   //!< Time of life out of cameras
+    void setPadding(int px);   //!< Expansion of camera rectangle
+
+    void addNpc(LVL_Npc *npc);
+    void removeNpc(LVL_Npc *npc);
+    void clear();
+
+    void update(const QVector<PGE_LevelCamera *> &cameras, int ticks);
+    const QVector<LVL_Npc *> &activeNpcs();
+
+private:
+    struct Region
+    {
+        float left, top, right, bottom;
+    };
+
+    static bool intersects(const Region &r, float left, float top, float right, float bottom);
+    bool inRegions(float left, float top, float right, float bottom);
+    bool spawnInRegions(LVL_Npc *npc);
+
+    static const int cellSize = 256;
+    static quint64 cellKey(long x, long y);
+    static long cellOf(float v);
+
+    void putToSleep(LVL_Npc *npc);
+
+    QHash<quint64, QVector<LVL_Npc *> > sleeping; //!< Sleeping NPCs by cells of initial position
+    QVector<LVL_Npc *> active;
+    QVector<LVL_Npc *> waiting; //!< Sleeping NPCs whose initial position is still seen
+    QVector<Region> regions;
+
+    int timeout;
+    int padding;
+};
+
+#endif // LVL_NPC_ACTIVATOR_H
@@ -21,6 +21,7 @@
 #include "../../data_configs/config_manager.h"
 
 #include "lvl_scene_ptr.h"
+#include "../../common_features/level_prefetch.h"
 
 #include <QtDebug>
 
@@ -281,6 +282,9 @@ void LVL_Player::update()
     {
         if(contactedWarp)
         {
+            //Next level is loading while player is entering the warp
+            if(!contactedWarp->data.lname.isEmpty())
+                LevelPrefetch::start(LevelScene::levelFilePath(LvlSceneP::s->levelData()->path+"/"+contactedWarp->data.lname));
 
             switch( contactedWarp->data.type )
             {
@@ -449,20 +453,25 @@ void LVL_Player::teleport(float x, float y)
 {
     if(!LvlSceneP::s) return;
 
-    this->setPos(x, y);
-
     int sID = LvlSceneP::s->findNearSection(x, y);
+    b2World *target = LvlSceneP::s->sectionWorld(sID);
+
+    if(target && (target != worldPtr))
+        moveToWorld(target, x, y);
+    else
+        this->setPos(x, y);
 
     if(camera->section->id != LvlSceneP::s->levelData()->sections[sID].id)
     {
         camera->changeSection(LvlSceneP::s->levelData()->sections[sID]);
+        camera->setWorld(target);
 
         if(ConfigManager::lvl_bg_indexes.contains(camera->BackgroundID))
         {
             LvlSceneP::s->bgList()->last()->setBg(ConfigManager::lvl_bg_indexes[camera->BackgroundID]);
 
             if(ConfigManager::lvl_bg_indexes[camera->BackgroundID].animated)
-                ConfigManager::Animator_BG[ConfigManager::lvl_bg_indexes[camera->BackgroundID].animator_ID].start();
+                ConfigManager::Animator_BG[ConfigManager::lvl_bg_indexes[camera->BackgroundID].animator_ID]->start();
         }
         else
             LvlSceneP::s->bgList()->last()->setNone();
@@ -473,6 +482,26 @@ void LVL_Player::teleport(float x, float y)
     }
 }
 
+void LVL_Player::moveToWorld(b2World *target, float x, float y)
+{
+    b2Vec2 velocity(0.0f, 0.0f);
+    if(physBody && worldPtr)
+    {
+        velocity = physBody->GetLinearVelocity();
+        //Contacts with objects of old section are finished here
+        worldPtr->DestroyBody(physBody);
+        physBody = NULL;
+    }
+
+    worldPtr = target;
+    data.x = (long)x;
+    data.y = (long)y;
+    init();
+
+    if(physBody)
+        physBody->SetLinearVelocity(velocity);
+}
+
 void LVL_Player::exitFromLevel(QString levelFile, int targetWarp)
 {
     isLive = false;
@@ -73,6 +73,8 @@ class LVL_Player :
         PGE_LevelCamera * camera;
 
         void teleport(float x, float y);
+        //! Re-creates body in the physical world of another section
+        void moveToWorld(b2World *target, float x, float y);
         void exitFromLevel(QString levelFile, int targetWarp);
 
         void render(float camX, float camY);
@@ -23,8 +23,12 @@
 #include <QFileInfo>
 #include <QElapsedTimer>
 #include <QApplication>
+#include <QSet>
+#include <QMap>
+#include <QCryptographicHash>
 
 #include "../../networking/intproc.h"
+#include "../../common_features/level_prefetch.h"
 
 bool LevelScene::loadFile(QString filePath)
 {
@@ -36,13 +40,69 @@ bool LevelScene::loadFile(QString filePath)
         return false;
     }
 
-    data = FileFormats::OpenLevelFile(filePath);
+    //File may be already loaded in background while player was entering the warp
+    if(!LevelPrefetch::take(filePath, data))
+        data = FileFormats::OpenLevelFile(filePath);
     if(!data.ReadFileValid)
         errorMsg += "Bad file format\n";
     return data.ReadFileValid;
 }
 
 
+void LevelScene::setInputRecording(QString filePath)
+{
+    isInputRecording = !filePath.isEmpty();
+    inputRecordFile = filePath;
+    inputRecord.clear();
+}
+
+void LevelScene::setInputReplay(QString filePath)
+{
+    isInputReplay = false;
+    if(filePath.isEmpty()) return;
+
+    if(!inputReplay.open(filePath))
+    {
+        qWarning() << "Replay:" << inputReplay.record.errorString;
+        return;
+    }
+    isInputReplay = true;
+    isInputRecording = false;
+}
+
+void LevelScene::setInputScript(const InputRecord &script)
+{
+    inputReplay.record = script;
+    isInputReplay = true;
+    isInputRecording = false;
+}
+
+QByteArray LevelScene::levelHash()
+{
+    return QCryptographicHash::hash(FileFormats::WriteLvlRawData(data), QCryptographicHash::Md5);
+}
+
+quint32 LevelScene::playersState()
+{
+    //FNV-1a over exact bits of positions and velocities
+    quint32 hash = 2166136261u;
+    foreach(LVL_Player *player, players)
+    {
+        if(!player->physBody) continue;
+        float state[4] = { player->physBody->GetPosition().x,
+                           player->physBody->GetPosition().y,
+                           player->physBody->GetLinearVelocity().x,
+                           player->physBody->GetLinearVelocity().y };
+        const uchar *bytes = reinterpret_cast<const uchar*>(state);
+        for(unsigned int i = 0; i < sizeof(state); i++)
+        {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
 bool LevelScene::loadFileIP()
 {
     if(!IntProc::isEnabled()) return false;
@@ -75,6 +135,101 @@ bool LevelScene::loadFileIP()
     if(!timeOut && !data.ReadFileValid)
         errorMsg += "Bad file format\n";
 
+    isLiveEditing = data.ReadFileValid;
+
     return data.ReadFileValid;
 }
 
+
+/**
+ * @brief LevelScene::applyLevelDeltas
+ *  Applies changes of blocks and BGO which were made in editor while level is tested.
+ *  Changed items are re-created, so they will get new settings and position.
+ */
+void LevelScene::applyLevelDeltas()
+{
+    if(!IntProc::isWorking()) return;
+
+    QList<IntProcProto::LevelDelta> deltas;
+    if(!IntProc::editor->takeLevelDeltas(deltas)) return;
+
+    QElapsedTimer time;
+    time.start();
+
+    //Collect everything first: item changed several times is re-created only once
+    QSet<LVL_Block*> oldBlocks;
+    QSet<LVL_Bgo*> oldBGO;
+    QMap<unsigned int, LevelBlock> newBlocks;
+    QMap<unsigned int, LevelBGO> newBGO;
+
+    foreach(const IntProcProto::LevelDelta &delta, deltas)
+    {
+        foreach(quint32 id, delta.removedBlocks)
+        {
+            LVL_Block *b = blocks_byArrayId.take(id);
+            if(b) oldBlocks.insert(b);
+            newBlocks.remove(id);
+        }
+        foreach(const LevelBlock &block, delta.blocks)
+        {
+            LVL_Block *b = blocks_byArrayId.take(block.array_id);
+            if(b) oldBlocks.insert(b);
+            newBlocks[block.array_id] = block;
+        }
+
+        foreach(quint32 id, delta.removedBGO)
+        {
+            LVL_Bgo *b = bgo_byArrayId.take(id);
+            if(b) oldBGO.insert(b);
+            newBGO.remove(id);
+        }
+        foreach(const LevelBGO &bgo, delta.bgo)
+        {
+            LVL_Bgo *b = bgo_byArrayId.take(bgo.array_id);
+            if(b) oldBGO.insert(b);
+            newBGO[bgo.array_id] = bgo;
+        }
+    }
+
+    //Remove old items in one pass, physical bodies are destroyed with them
+    if(!oldBlocks.isEmpty())
+    {
+        foreach(LVL_Block *b, oldBlocks)
+        {
+            if(b->mergedInto) unmergeBlocks(b->mergedInto);
+        }
+
+        int out = 0;
+        for(int i = 0; i < blocks.size(); i++)
+        {
+            if(oldBlocks.contains(blocks[i])) continue;
+            blocks[out++] = blocks[i];
+        }
+        blocks.resize(out);
+        foreach(LVL_Block *b, oldBlocks) delete b;
+    }
+
+    if(!oldBGO.isEmpty())
+    {
+        int out = 0;
+        for(int i = 0; i < bgos.size(); i++)
+        {
+            if(oldBGO.contains(bgos[i])) continue;
+            bgos[out++] = bgos[i];
+        }
+        bgos.resize(out);
+        foreach(LVL_Bgo *b, oldBGO) delete b;
+    }
+
+    foreach(const LevelBlock &block, newBlocks)
+        placeBlock(block);
+    if(!oldBlocks.isEmpty() || !newBlocks.isEmpty())
+        mergeStaticBlocks();
+
+    foreach(const LevelBGO &bgo, newBGO)
+        placeBGO(bgo);
+
+    qDebug() << "Level changes applied in" << time.elapsed() << "ms: removed"
+             << oldBlocks.size()+oldBGO.size() << "placed" << newBlocks.size()+newBGO.size();
+}
+
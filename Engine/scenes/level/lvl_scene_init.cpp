@@ -21,8 +21,10 @@
 #include "../../physics/contact_listener.h"
 
 #include "../../gui/pge_msgbox.h"
+#include "../../graphics/gl_renderer.h"
 
 #include <QDebug>
+#include <QDateTime>
 
 
 bool LevelScene::setEntrance(int entr)
@@ -46,9 +48,18 @@ bool LevelScene::setEntrance(int entr)
         {
             exitLevelCode = EXIT_Error;
 
-            PGE_MsgBox msgBox(NULL, "ERROR:\nCan't start level without player's start point.\nPlease set a player's start point and start level again.",
-                              PGE_MsgBox::msg_error);
-            msgBox.exec();
+            //There is no window to show message box in headless mode
+            if(GlRenderer::isHeadless())
+            {
+                errorMsg += "Can't start level without player's start point\n";
+                qWarning() << "Can't start level without player's start point";
+            }
+            else
+            {
+                PGE_MsgBox msgBox(NULL, "ERROR:\nCan't start level without player's start point.\nPlease set a player's start point and start level again.",
+                                  PGE_MsgBox::msg_error);
+                msgBox.exec();
+            }
         }
 
         //Find available start points
@@ -110,9 +121,17 @@ bool LevelScene::setEntrance(int entr)
 
     isWarpEntrance=false;
 
-    PGE_MsgBox msgBox(NULL, "ERROR:\nTarget section is not found.\nMayby level is empty.",
-                      PGE_MsgBox::msg_error);
-    msgBox.exec();
+    if(GlRenderer::isHeadless())
+    {
+        errorMsg += "Target section is not found\n";
+        qWarning() << "Target section is not found";
+    }
+    else
+    {
+        PGE_MsgBox msgBox(NULL, "ERROR:\nTarget section is not found.\nMayby level is empty.",
+                          PGE_MsgBox::msg_error);
+        msgBox.exec();
+    }
 
     //Error, sections is not found
     exitLevelCode = EXIT_Error;
@@ -127,13 +146,9 @@ bool LevelScene::loadConfigs()
 {
     bool success=true;
 
-    //Load INI-files
-        loaderStep();
-    success = ConfigManager::loadLevelBlocks(); //!< Blocks
-        loaderStep();
-    success = ConfigManager::loadLevelBGO();    //!< BGO
+    //Load INI-files (they are parsed only when they was changed since last level)
         loaderStep();
-    success = ConfigManager::loadLevelBackG();  //!< Backgrounds
+    success = ConfigManager::loadLevelSettings();
 
     //Set paths
     ConfigManager::Dir_Blocks.setCustomDirs(data.path, data.filename, ConfigManager::PathLevelBlock() );
@@ -158,15 +173,23 @@ bool LevelScene::init()
 
     //Set Entrance  (int entr=0)
 
-    //Init Physics
-    b2Vec2 gravity(0.0f, 150.0f);
-    world = new b2World(gravity);
-    world->SetAllowSleeping(true);
-
-    PGEContactListener *contactListener;
+    //Random seed and level data are stored with input record to make session repeatable
+    quint32 seed = (quint32)QDateTime::currentMSecsSinceEpoch();
+    if(isInputReplay)
+    {
+        if(inputReplay.record.levelHash != levelHash())
+            qWarning() << "Replay: record was made with other level data, replay may diverge";
+        seed = inputReplay.record.seed;
+    }
+    if(isInputRecording)
+    {
+        inputRecord.seed = seed;
+        inputRecord.levelHash = levelHash();
+    }
+    qsrand(seed);
 
+    //Init Physics: worlds of sections are created when first object is placed into them
     contactListener = new PGEContactListener();
-    world->SetContactListener(contactListener);
 
     int sID = findNearSection(cameraStart.x(), cameraStart.y());
 
@@ -177,7 +200,7 @@ bool LevelScene::init()
     //Init Cameras
     PGE_LevelCamera* camera;
     camera = new PGE_LevelCamera();
-    camera->setWorld(world);
+    camera->setWorld(sectionWorld(sID));
     camera->changeSection(data.sections[sID]);
     camera->isWarp = data.sections[sID].IsWarp;
     camera->section = &(data.sections[sID]);
@@ -214,6 +237,7 @@ bool LevelScene::init()
         loaderStep();
         placeBlock(data.blocks[i]);
     }
+    mergeStaticBlocks();
 
     qDebug()<<"Init BGOs";
     //BGO
@@ -223,6 +247,16 @@ bool LevelScene::init()
         placeBGO(data.bgo[i]);
     }
 
+    qDebug()<<"Init NPCs";
+    //NPC
+    npcActivator.setTimeout(ConfigManager::npc_activation_time);
+    npcActivator.setPadding(ConfigManager::npc_activation_padding);
+    for(int i=0; i<data.npc.size(); i++)
+    {
+        loaderStep();
+        placeNPC(data.npc[i]);
+    }
+
     qDebug()<<"Init Warps";
     //BGO
     for(int i=0; i<data.doors.size(); i++)
@@ -231,7 +265,7 @@ bool LevelScene::init()
 
         LVL_Warp * warpP;
         warpP = new LVL_Warp();
-        warpP->worldPtr = world;
+        warpP->worldPtr = worldAt(data.doors[i].ix, data.doors[i].iy);
         warpP->data = data.doors[i];
         warpP->init();
         warps.push_back(warpP);
@@ -240,6 +274,11 @@ bool LevelScene::init()
 
     qDebug() << "textures " << ConfigManager::level_textures.size();
 
+    int worldsCount = 0;
+    foreach(b2World *w, worlds)
+        if(w) worldsCount++;
+    qDebug() << "Physical worlds:" << worldsCount << "of" << data.sections.size() << "sections";
+
 
     qDebug()<<"Add players";
 
@@ -266,13 +305,13 @@ bool LevelScene::init()
 
     //start animation
     for(int i=0; i<ConfigManager::Animator_Blocks.size(); i++)
-        ConfigManager::Animator_Blocks[i].start();
+        ConfigManager::Animator_Blocks[i]->start();
 
     for(int i=0; i<ConfigManager::Animator_BGO.size(); i++)
-        ConfigManager::Animator_BGO[i].start();
+        ConfigManager::Animator_BGO[i]->start();
 
     for(int i=0; i<ConfigManager::Animator_BG.size(); i++)
-        ConfigManager::Animator_BG[i].start();
+        ConfigManager::Animator_BG[i]->start();
 
     stopLoaderAnimation();
     isInit = true;
@@ -19,6 +19,8 @@
 #include "../scene_level.h"
 #include "../../data_configs/config_manager.h"
 
+#include <algorithm>
+
 
 static double zCounter = 0;
 
@@ -57,8 +59,9 @@ void LevelScene::placeBlock(LevelBlock blockData)
         block->z_index += zCounter;
     }
 
-    block->worldPtr = world;
+    block->worldPtr = worldAt(blockData.x, blockData.y);
     block->data = &(blockData);
+    block->array_id = blockData.array_id;
     long tID = ConfigManager::getBlockTexture(blockData.id);
     if( tID >= 0 )
     {
@@ -70,6 +73,7 @@ void LevelScene::placeBlock(LevelBlock blockData)
 
     block->init();
     blocks.push_back(block);
+    blocks_byArrayId[blockData.array_id] = block;
 
 }
 
@@ -92,8 +96,9 @@ void LevelScene::placeBGO(LevelBGO bgoData)
         return;
     }
 
-    bgo->worldPtr = world;
+    bgo->worldPtr = worldAt(bgoData.x, bgoData.y);
     bgo->data = &(bgoData);
+    bgo->array_id = bgoData.array_id;
 
     double targetZ = 0;
     double zOffset = bgo->setup->zOffset;
@@ -131,6 +136,7 @@ void LevelScene::placeBGO(LevelBGO bgoData)
     bgo->init();
 
     bgos.push_back(bgo);
+    bgo_byArrayId[bgoData.array_id] = bgo;
 }
 
 
@@ -138,6 +144,20 @@ void LevelScene::placeBGO(LevelBGO bgoData)
 
 
 
+void LevelScene::placeNPC(LevelNPC npcData)
+{
+    LVL_Npc * npc;
+    npc = new LVL_Npc();
+    npc->worldPtr = worldAt(npcData.x, npcData.y);
+    npc->data = npcData;
+    npc->z_index = Z_npcStd;
+    npc->init();
+    npcs.push_back(npc);
+    npcActivator.addNpc(npc);
+}
+
+
+
 void LevelScene::addPlayer(PlayerPoint playerData, bool byWarp)
 {
     if(byWarp)
@@ -152,7 +172,7 @@ void LevelScene::addPlayer(PlayerPoint playerData, bool byWarp)
     LVL_Player * player;
     player = new LVL_Player();
     player->camera = cameras.last();
-    player->worldPtr = world;
+    player->worldPtr = worldAt(playerData.x, playerData.y);
     player->setSize(playerData.w, playerData.h);
     player->data = playerData;
     player->z_index = Z_Player;
@@ -160,13 +180,172 @@ void LevelScene::addPlayer(PlayerPoint playerData, bool byWarp)
     players.push_back(player);
 
     if(player->playerID==1)
-        keyboard1.registerInControl(player);
+    {
+        if(isInputReplay)
+            inputReplay.registerInControl(player);
+        else
+            keyboard1.registerInControl(player);
+    }
 }
 
 
 void LevelScene::destroyBlock(LVL_Block *_block)
 {
+    if(_block->mergedInto)
+        unmergeBlocks(_block->mergedInto);
+
     blocks.remove(blocks.indexOf(_block));
+    if(blocks_byArrayId.value(_block->array_id)==_block)
+        blocks_byArrayId.remove(_block->array_id);
     delete _block;
     _block = NULL;
 }
+
+void LevelScene::destroyBGO(LVL_Bgo *_bgo)
+{
+    bgos.remove(bgos.indexOf(_bgo));
+    if(bgo_byArrayId.value(_bgo->array_id)==_bgo)
+        bgo_byArrayId.remove(_bgo->array_id);
+    delete _bgo;
+    _bgo = NULL;
+}
+
+
+
+//Bounding rectangle of group of blocks which share one physical body
+struct MergedRect
+{
+    b2World *world;
+    int cls;
+    float x, y, w, h;
+    QVector<LVL_Block* > members;
+};
+
+static void countBodies(const QVector<b2World* > &worlds, int &bodies, int &fixtures)
+{
+    bodies = 0;
+    fixtures = 0;
+    foreach(b2World *world, worlds)
+    {
+        if(!world) continue;
+        bodies += world->GetBodyCount();
+        for(b2Body *b = world->GetBodyList(); b; b = b->GetNext())
+            for(b2Fixture *f = b->GetFixtureList(); f; f = f->GetNext())
+                fixtures++;
+    }
+}
+
+void LevelScene::mergeStaticBlocks()
+{
+    int bodiesBefore, fixturesBefore;
+    countBodies(worlds, bodiesBefore, fixturesBefore);
+
+    QVector<LVL_Block* > candidates;
+    foreach(LVL_Block *b, blocks)
+    {
+        if(b->canMerge && b->physBody && !b->mergedInto)
+            candidates.push_back(b);
+    }
+
+    //Rows: blocks of same height which are touching by sides
+    std::sort(candidates.begin(), candidates.end(), [](LVL_Block *a, LVL_Block *b)
+    {
+        if(a->worldPtr != b->worldPtr) return a->worldPtr < b->worldPtr;
+        if(a->mergeClass() != b->mergeClass()) return a->mergeClass() < b->mergeClass();
+        if(a->fixedY != b->fixedY) return a->fixedY < b->fixedY;
+        if(a->height != b->height) return a->height < b->height;
+        return a->fixedX < b->fixedX;
+    });
+
+    QVector<MergedRect> rows;
+    foreach(LVL_Block *b, candidates)
+    {
+        if(!rows.isEmpty())
+        {
+            MergedRect &r = rows.last();
+            if((r.world == b->worldPtr) && (r.cls == b->mergeClass()) && (r.y == b->fixedY) &&
+               (r.h == b->height) && (r.x + r.w == b->fixedX))
+            {
+                r.w += b->width;
+                r.members.push_back(b);
+                continue;
+            }
+        }
+        MergedRect r;
+        r.world = b->worldPtr;
+        r.cls = b->mergeClass();
+        r.x = b->fixedX; r.y = b->fixedY;
+        r.w = b->width;  r.h = b->height;
+        r.members.push_back(b);
+        rows.push_back(r);
+    }
+
+    //Rows of same width which are placed one under another are joined into rectangles
+    std::sort(rows.begin(), rows.end(), [](const MergedRect &a, const MergedRect &b)
+    {
+        if(a.world != b.world) return a.world < b.world;
+        if(a.cls != b.cls) return a.cls < b.cls;
+        if(a.x != b.x) return a.x < b.x;
+        if(a.w != b.w) return a.w < b.w;
+        return a.y < b.y;
+    });
+
+    QVector<MergedRect> rects;
+    foreach(const MergedRect &r, rows)
+    {
+        if(!rects.isEmpty())
+        {
+            MergedRect &last = rects.last();
+            if((last.world == r.world) && (last.cls == r.cls) && (last.x == r.x) &&
+               (last.w == r.w) && (last.y + last.h == r.y))
+            {
+                last.h += r.h;
+                last.members += r.members;
+                continue;
+            }
+        }
+        rects.push_back(r);
+    }
+
+    foreach(const MergedRect &r, rects)
+    {
+        if(r.members.size() < 2) continue;
+
+        LVL_Block *first = r.members.first();
+        LVL_Block *merged = new LVL_Block();
+        merged->setup = first->setup;
+        merged->worldPtr = r.world;
+        merged->slippery = first->slippery;
+        merged->z_index = first->z_index;
+        merged->fixedX = r.x;
+        merged->fixedY = r.y;
+        merged->setSize(r.w, r.h);
+        merged->mergedBlocks = r.members;
+
+        foreach(LVL_Block *b, r.members)
+        {
+            r.world->DestroyBody(b->physBody);
+            b->physBody = NULL;
+            b->mergedInto = merged;
+        }
+
+        merged->initPhysics();
+        blockStrips.push_back(merged);
+    }
+
+    int bodiesAfter, fixturesAfter;
+    countBodies(worlds, bodiesAfter, fixturesAfter);
+    qDebug() << "Static blocks merged: bodies" << bodiesBefore << "->" << bodiesAfter
+             << "fixtures" << fixturesBefore << "->" << fixturesAfter;
+}
+
+void LevelScene::unmergeBlocks(LVL_Block *merged)
+{
+    foreach(LVL_Block *b, merged->mergedBlocks)
+    {
+        b->mergedInto = NULL;
+        b->initPhysics();
+    }
+    blockStrips.remove(blockStrips.indexOf(merged));
+    delete merged;
+}
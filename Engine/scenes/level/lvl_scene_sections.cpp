@@ -17,6 +17,7 @@
  */
 
 #include "../scene_level.h"
+#include "../../physics/contact_listener.h"
 
 #include <QtDebug>
 
@@ -57,3 +58,35 @@ int LevelScene::findNearSection(long x, long y)
     return result;
 }
 
+b2World *LevelScene::sectionWorld(int sID)
+{
+    if((sID < 0) || (sID >= data.sections.size()))
+        return NULL;
+
+    if(worlds.size() < data.sections.size())
+        worlds.resize(data.sections.size());
+
+    if(!worlds[sID])
+    {
+        b2Vec2 gravity(0.0f, 150.0f);
+        b2World *world = new b2World(gravity);
+        world->SetAllowSleeping(true);
+        world->SetContactListener(contactListener);
+        worlds[sID] = world;
+    }
+    return worlds[sID];
+}
+
+b2World *LevelScene::worldAt(long x, long y)
+{
+    return sectionWorld(findNearSection(x, y));
+}
+
+int LevelScene::physBodiesCount()
+{
+    int count = 0;
+    foreach(b2World *w, worlds)
+        if(w) count += w->GetBodyCount();
+    return count;
+}
+
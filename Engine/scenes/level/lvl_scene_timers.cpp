@@ -19,6 +19,7 @@
 #include "../scene_level.h"
 #include "../../common_features/simple_animator.h"
 #include "../../common_features/graphics_funcs.h"
+#include "../../graphics/gl_renderer.h"
 
 #include "../../networking/intproc.h"
 
@@ -29,7 +30,8 @@ void LevelScene::setFade(int speed, float target, float step)
     fade_step = fabs(step);
     target_opacity = target;
     fadeSpeed = speed;
-    fader_timer_id = SDL_AddTimer(speed, &LevelScene::nextOpacity, this);
+    TimerScheduler::remove(fader_timer_id);
+    fader_timer_id = TimerScheduler::add(speed, &LevelScene::nextOpacity, this);
 }
 
 unsigned int LevelScene::nextOpacity(unsigned int x, void *p)
@@ -37,7 +39,7 @@ unsigned int LevelScene::nextOpacity(unsigned int x, void *p)
     Q_UNUSED(x);
     LevelScene *self = reinterpret_cast<LevelScene *>(p);
     self->fadeStep();
-    return 0;
+    return self->fadeSpeed;
 }
 
 void LevelScene::fadeStep()
@@ -48,9 +50,10 @@ void LevelScene::fadeStep()
         fader_opacity-=fade_step;
 
     if(fader_opacity>=1.0 || fader_opacity<=0.0)
-        SDL_RemoveTimer(fader_timer_id);
-    else
-        fader_timer_id = SDL_AddTimer(fadeSpeed, &LevelScene::nextOpacity, this);
+    {
+        TimerScheduler::remove(fader_timer_id);
+        fader_timer_id = 0;
+    }
 }
 /**************************Fader**end**************************/
 
@@ -130,7 +133,8 @@ void LevelScene::setLoaderAnimation(int speed)
                                      0, -1, false, false);
     loading_Ani->start();
 
-    loader_timer_id = SDL_AddTimer(speed, &LevelScene::nextLoadAniFrame, this);
+    TimerScheduler::remove(loader_timer_id);
+    loader_timer_id = TimerScheduler::add(speed, &LevelScene::nextLoadAniFrame, this);
     IsLoaderWorks = true;
 }
 
@@ -140,9 +144,11 @@ void LevelScene::stopLoaderAnimation()
 
     doLoaderStep = false;
     IsLoaderWorks = false;
-    SDL_RemoveTimer(loader_timer_id);
+    TimerScheduler::remove(loader_timer_id);
+    loader_timer_id = 0;
 
-    render();
+    if(!GlRenderer::isHeadless())
+        render();
     if(loading_Ani)
     {
         loading_Ani->stop();
@@ -159,7 +165,7 @@ unsigned int LevelScene::nextLoadAniFrame(unsigned int x, void *p)
     Q_UNUSED(x);
     LevelScene *self = reinterpret_cast<LevelScene *>(p);
     self->loaderTick();
-    return 0;
+    return self->loaderSpeed;
 }
 
 void LevelScene::loaderTick()
@@ -170,6 +176,8 @@ void LevelScene::loaderTick()
 void LevelScene::loaderStep()
 {
     if(!IsLoaderWorks) return;
+    //Loading is not simulated, so loader animation is going by wall clock
+    TimerScheduler::sync();
     if(!doLoaderStep) return;
 
     SDL_Event event; //  Events of SDL
@@ -184,10 +192,10 @@ void LevelScene::loaderStep()
 
     drawLoader();
 
+    GlRenderer::captureFrame();
     glFlush();
     SDL_GL_SwapWindow(PGE_Window::window);
 
-    loader_timer_id = SDL_AddTimer(loaderSpeed, &LevelScene::nextLoadAniFrame, this);
     doLoaderStep = false;
 }
 
@@ -20,12 +20,14 @@
 
 #include "common_features/app_path.h"
 #include "common_features/graphics_funcs.h"
+#include "common_features/texture_cache.h"
 
 #include "../graphics/gl_renderer.h"
 
 #include "level/lvl_scene_ptr.h"
 
 #include "../data_configs/config_manager.h"
+#include "../physics/contact_listener.h"
 
 #include "../fontman/font_manager.h"
 
@@ -43,10 +45,18 @@ LevelScene::LevelScene()
 
     isInit=false;
     isWarpEntrance=false;
+    isLiveEditing=false;
 
     isPauseMenu=false;
     isTimeStopped=false;
 
+    isInputRecording=false;
+    isInputReplay=false;
+
+    isProfiling=false;
+    profStepTime=0;
+    profCullTime=0;
+
     /*********Exit*************/
     isLevelContinues=true;
 
@@ -62,10 +72,12 @@ LevelScene::LevelScene()
     numberOfPlayers=1;
     /*********Default players number*************/
 
-    world=NULL;
+    contactListener=NULL;
 
     /*********Loader*************/
     IsLoaderWorks=false;
+    doLoaderStep=false;
+    loader_timer_id=0;
     /*********Loader*************/
 
     /*********Fader*************/
@@ -73,6 +85,7 @@ LevelScene::LevelScene()
     target_opacity=1.0f;
     fade_step=0.0f;
     fadeSpeed=25;
+    fader_timer_id=0;
     /*********Fader*************/
 
 
@@ -115,6 +128,17 @@ LevelScene::LevelScene()
 LevelScene::~LevelScene()
 {
     LvlSceneP::s = NULL;
+
+    TimerScheduler::remove(fader_timer_id);
+    TimerScheduler::remove(loader_timer_id);
+
+    if(isInputRecording)
+    {
+        if(inputRecord.save(inputRecordFile))
+            qDebug() << "Input record saved:" << inputRecord.keys.size() << "ticks into" << inputRecordFile;
+        else
+            qWarning() << inputRecord.errorString;
+    }
     //stop animators
 
     //desroy animators
@@ -124,8 +148,11 @@ LevelScene::~LevelScene()
     qDebug() << "clear textures";
     while(!textures_bank.isEmpty())
     {
-        glDisable(GL_TEXTURE_2D);
-        glDeleteTextures( 1, &(textures_bank[0].texture) );
+        if(!GlRenderer::isHeadless())
+        {
+            glDisable(GL_TEXTURE_2D);
+            glDeleteTextures( 1, &(textures_bank[0].texture) );
+        }
         textures_bank.pop_front();
     }
 
@@ -155,10 +182,18 @@ LevelScene::~LevelScene()
         tmp = players.first();
         players.pop_front();
         keyboard1.removeFromControl(tmp);
+        inputReplay.removeFromControl(tmp);
         if(tmp) delete tmp;
     }
 
     qDebug() << "Destroy blocks";
+    while(!blockStrips.isEmpty())
+    {
+        LVL_Block* tmp;
+        tmp = blockStrips.first();
+        blockStrips.pop_front();
+        if(tmp) delete tmp;
+    }
     while(!blocks.isEmpty())
     {
         LVL_Block* tmp;
@@ -167,6 +202,16 @@ LevelScene::~LevelScene()
         if(tmp) delete tmp;
     }
 
+    qDebug() << "Destroy NPC";
+    npcActivator.clear();
+    while(!npcs.isEmpty())
+    {
+        LVL_Npc* tmp;
+        tmp = npcs.first();
+        npcs.pop_front();
+        if(tmp) delete tmp;
+    }
+
     qDebug() << "Destroy BGO";
     while(!bgos.isEmpty())
     {
@@ -186,9 +231,16 @@ LevelScene::~LevelScene()
         if(tmp) delete tmp;
     }
 
-    qDebug() << "Destroy world";
-    if(world) delete world; //!< Destroy annoying world, mu-ha-ha-ha >:-D
-    world = NULL;
+    qDebug() << "Destroy worlds";
+    while(!worlds.isEmpty())
+    {
+        b2World* tmp;
+        tmp = worlds.last();
+        worlds.pop_back();
+        if(tmp) delete tmp; //!< Destroy annoying world, mu-ha-ha-ha >:-D
+    }
+    if(contactListener) delete contactListener;
+    contactListener = NULL;
 
     //destroy players
     //destroy blocks
@@ -213,6 +265,9 @@ void LevelScene::update(float step)
 {
     if(step<=0) step=10.0f;
 
+    //Animators and faders are going by simulation time
+    TimerScheduler::advance(1000.0/(double)PGE_Window::PhysStep);
+
     if(doExit)
     {
         if(exitLevelDelay>=0)
@@ -227,11 +282,45 @@ void LevelScene::update(float step)
     else
     if(!isPauseMenu) //Update physics is not pause menu
     {
-        //Make world step
-        world->Step(1.0f / (float)PGE_Window::PhysStep, 5, 1);
+        //Apply changes made in editor while level is tested
+        if(isLiveEditing)
+            applyLevelDeltas();
+
+        //Make step of worlds where players or cameras are, other sections are frozen
+        activeWorlds.clear();
+        for(i=0; i<cameras.size(); i++)
+        {
+            b2World *w = cameras[i]->world();
+            if(w && !activeWorlds.contains(w)) activeWorlds.push_back(w);
+        }
+        for(i=0; i<players.size(); i++)
+        {
+            b2World *w = players[i]->worldPtr;
+            if(w && !activeWorlds.contains(w)) activeWorlds.push_back(w);
+        }
+        if(isProfiling) profTimer.start();
+        foreach(b2World *w, activeWorlds)
+            w->Step(1.0f / (float)PGE_Window::PhysStep, 5, 1);
+        if(isProfiling) profStepTime += profTimer.nsecsElapsed();
 
         //Update controllers
-        keyboard1.sendControls();
+        if(isInputReplay)
+        {
+            if(inputReplay.isFinished() && !doExit)
+            {
+                qDebug() << "Replay finished at tick" << inputReplay.currentTick()
+                         << ((inputReplay.divergedTick()<0) ? "without divergence" : "with divergence");
+                setExiting(0, EXIT_Closed);
+            }
+            inputReplay.update();
+            inputReplay.sendControls();
+        }
+        else
+        {
+            keyboard1.sendControls();
+            if(isInputRecording)
+                inputRecord.keys.push_back(InputRecord::packKeys(keyboard1.keys));
+        }
 
         //update players
         for(i=0; i<players.size(); i++)
@@ -269,23 +358,38 @@ void LevelScene::update(float step)
             }
             else
             {
-                delayToEnter-= lastTicks;//(1000.0/(float)PGE_Window::PhysStep)-lastTicks;
+                if(isInputRecording || isInputReplay) //Real time is not repeatable
+                    delayToEnter-= 1000/PGE_Window::PhysStep;
+                else
+                    delayToEnter-= lastTicks;//(1000.0/(float)PGE_Window::PhysStep)-lastTicks;
             }
         }
 
 
+        //Wake NPCs near cameras and send to sleep forgotten
+        npcActivator.update(cameras, 1000/PGE_Window::PhysStep);
+
         if(!isTimeStopped) //if activated Time stop bonus or time disabled by special event
         {
             //update activated NPC's
-                //comming soon
+            foreach(LVL_Npc *npc, npcActivator.activeNpcs())
+                npc->update();
 
             //udate visible Effects and destroy invisible
                 //comming soon
         }
 
         //update cameras
+        if(isProfiling) profTimer.start();
         for(i=0; i<cameras.size(); i++)
             cameras[i]->update();
+        if(isProfiling) profCullTime += profTimer.nsecsElapsed();
+
+        if(isInputRecording)
+            inputRecord.states.push_back(playersState());
+        else
+        if(isInputReplay)
+            inputReplay.checkState(playersState());
     }
 
 }
@@ -323,6 +427,7 @@ void LevelScene::render()
             {
             case PGE_Phys_Object::LVLBlock:
             case PGE_Phys_Object::LVLBGO:
+            case PGE_Phys_Object::LVLNPC:
             case PGE_Phys_Object::LVLPlayer:
                 item->render(cam->posX(), cam->posY());
                 break;
@@ -343,6 +448,10 @@ void LevelScene::render()
                                .arg(debug_player_onground)
                                .arg(debug_player_foots), 10,100);
 
+        FontManager::printText(TextureCache::stats(), 10,130);
+        FontManager::printText(QString("NPC active %1 of %2")
+                               .arg(npcActivator.activeNpcs().size()).arg(npcs.size()), 10,160);
+
         if(doExit)
             FontManager::printText(QString("Exit delay %1, %2")
                                    .arg(exitLevelDelay)
@@ -387,6 +496,7 @@ int LevelScene::exec()
 
             render();
 
+            GlRenderer::captureFrame();
             glFlush();
             SDL_GL_SwapWindow(PGE_Window::window);
 
@@ -429,6 +539,9 @@ int LevelScene::exec()
                     case SDLK_F3:
                         PGE_Window::showDebugInfo=!PGE_Window::showDebugInfo;
                     break;
+                    case SDLK_F11:
+                        GlRenderer::toggleRecording();
+                    break;
                     case SDLK_F12:
                         GlRenderer::makeShot();
                     break;
@@ -495,14 +608,20 @@ bool LevelScene::isExit()
 
 QString LevelScene::toAnotherLevel()
 {
-    if(!warpToLevelFile.isEmpty())
-    if(!warpToLevelFile.endsWith(".lvl", Qt::CaseInsensitive) &&
-       !warpToLevelFile.endsWith(".lvlx", Qt::CaseInsensitive))
-        warpToLevelFile.append(".lvl");
-
+    warpToLevelFile = levelFilePath(warpToLevelFile);
     return warpToLevelFile;
 }
 
+QString LevelScene::levelFilePath(QString levelFile)
+{
+    if(!levelFile.isEmpty())
+    if(!levelFile.endsWith(".lvl", Qt::CaseInsensitive) &&
+       !levelFile.endsWith(".lvlx", Qt::CaseInsensitive))
+        levelFile.append(".lvl");
+
+    return levelFile;
+}
+
 int LevelScene::toAnotherEntrance()
 {
     return warpToArrayID;
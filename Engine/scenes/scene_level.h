@@ -26,6 +26,8 @@
 #include "level/lvl_player.h"
 #include "level/lvl_block.h"
 #include "level/lvl_bgo.h"
+#include "level/lvl_npc.h"
+#include "level/lvl_npc_activator.h"
 
 #include "level/lvl_warp.h"
 
@@ -35,6 +37,8 @@
 #include "../graphics/window.h"
 
 #include "../controls/controller_keyboard.h"
+#include "../controls/controller_replay.h"
+#include "../controls/input_record.h"
 
 #include "../data_configs/custom_data.h"
 
@@ -42,9 +46,14 @@
 #include <Box2D/Box2D.h>
 #include <QString>
 #include <QVector>
+#include <QHash>
+#include <QElapsedTimer>
 
 #include <SDL2/SDL_opengl.h>
 #include <SDL2/SDL_timer.h>
+#include "../common_features/timer_scheduler.h"
+
+class PGEContactListener;
 
 class LevelScene : public Scene
 {
@@ -58,6 +67,8 @@ public:
     //Init 1
     bool loadFile(QString filePath);
     bool loadFileIP(); //!< Load data via interprocessing
+    bool isLiveEditing; //!< Level was received from editor, it's changes are applied while testing
+    void applyLevelDeltas();
 
     //Init 2
     bool setEntrance(int entr);
@@ -93,6 +104,10 @@ public:
 
 
     int findNearSection(long x, long y);
+    //! Physical world of section, it is created on first request
+    b2World *sectionWorld(int sID);
+    //! Physical world of section nearest to the point
+    b2World *worldAt(long x, long y);
 
     bool isExit();
 
@@ -129,6 +144,8 @@ public:
 
     QString toAnotherLevel();
     QString warpToLevelFile;
+    //! Appends ".lvl" to level file name given without extension
+    static QString levelFilePath(QString levelFile);
 
     int toAnotherEntrance();
     int warpToArrayID;
@@ -141,6 +158,27 @@ public:
 
     KeyboardController keyboard1;
 
+    /**************Input record**************/
+    void setInputRecording(QString filePath); //!< Keys of every tick will be saved on level exit
+    void setInputReplay(QString filePath);    //!< Keys of every tick will be taken from record
+    bool isInputRecording;
+    bool isInputReplay;
+    QString inputRecordFile;
+    InputRecord inputRecord;
+    ReplayController inputReplay;
+    QByteArray levelHash();
+    quint32 playersState(); //!< Checksum of position and velocity of players
+    void setInputScript(const InputRecord &script); //!< Keys of every tick are taken from given set
+    /**************Input record**************/
+
+    /**************Profiling**************/
+    bool isProfiling;
+    qint64 profStepTime; //!< Nanoseconds spent in physics steps
+    qint64 profCullTime; //!< Nanoseconds spent in camera culling and sorting
+    QElapsedTimer profTimer;
+    int physBodiesCount();
+    /**************Profiling**************/
+
 
     /**************Z-Layers**************/
     double Z_backImage; //Background
@@ -179,7 +217,7 @@ public:
     void setFade(int speed, float target, float step);
     static unsigned int nextOpacity(unsigned int x, void *p);
     void fadeStep();
-    SDL_TimerID fader_timer_id;
+    int fader_timer_id;
     /**************Fader**************/
 
     /**************LoadScreen**************/
@@ -192,7 +230,7 @@ public:
     void loaderTick();
     bool doLoaderStep;
     void loaderStep();
-    SDL_TimerID loader_timer_id;
+    int loader_timer_id;
     /**************LoadScreen**************/
 
 
@@ -202,11 +240,17 @@ public:
     /*********************Item placing**********************/
     void placeBlock(LevelBlock blockData);
     void placeBGO(LevelBGO bgoData);
+    void placeNPC(LevelNPC npcData);
 
     void addPlayer(PlayerPoint playerData, bool byWarp=false);
     /*********************Item placing**********************/
 
     void destroyBlock(LVL_Block * _block);
+    //! Joins collision of neighbouring inert blocks into shared bodies
+    void mergeStaticBlocks();
+    //! Returns own bodies to blocks of merged block and deletes it
+    void unmergeBlocks(LVL_Block * merged);
+    void destroyBGO(LVL_Bgo * _bgo);
 
 private:
     LevelData data;
@@ -214,7 +258,12 @@ private:
     QVector<PGE_LevelCamera* > cameras;
     QVector<LVL_Player* > players;
     QVector<LVL_Block* > blocks;
+    QVector<LVL_Block* > blockStrips; //Merged collision of static blocks
     QVector<LVL_Bgo* > bgos;
+    QVector<LVL_Npc* > npcs;
+    LVL_NpcActivator npcActivator;
+    QHash<unsigned int, LVL_Block* > blocks_byArrayId;
+    QHash<unsigned int, LVL_Bgo* > bgo_byArrayId;
     QVector<LVL_Warp* > warps;
 
     QVector<LVL_Background *> backgrounds;
@@ -222,7 +271,9 @@ private:
     QString errorMsg;
 
 
-    b2World *world;
+    QVector<b2World* > worlds; //!< Every section has own physical world, only worlds with players or cameras are stepped
+    QVector<b2World* > activeWorlds; //!< Worlds stepped on this frame
+    PGEContactListener *contactListener;
     QVector<PGE_Texture > textures_bank;
 };
 
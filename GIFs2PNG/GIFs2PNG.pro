@@ -21,7 +21,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 QT       -= opengl
 
 DESTDIR = ../bin
@@ -61,7 +61,8 @@ TEMPLATE = app
 RC_FILE = _resources/gifs2png.rc
 
 SOURCES += \
-    gifs2png.cpp
+    gifs2png.cpp \
+    ../_common/mask_blend.cpp
 
 RESOURCES += \
     _resources/gifs2png.qrc
@@ -70,4 +71,5 @@ OTHER_FILES += \
     _resources/gifs2png.rc
 
 HEADERS += \
-    version.h
+    version.h \
+    ../_common/mask_blend.h
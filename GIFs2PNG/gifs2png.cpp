@@ -24,33 +24,35 @@
 #include <QString>
 #include <QTextStream>
 #include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QtConcurrent/QtConcurrentMap>
 #include "version.h"
 
-QImage setAlphaMask(QImage image, QImage mask)
-{
-    if(mask.isNull())
-        return image;
-
-    if(image.isNull())
-        return image;
-
-    QImage target = image;
-    QImage newmask = mask;
+#include "../_common/mask_blend.h"
 
-    if(target.size()!= newmask.size())
-    {
-        newmask = newmask.copy(0,0, target.width(), target.height());
-    }
-
-    newmask.invertPixels();
-
-    target.setAlphaChannel(newmask);
-
-    return target;
-}
+struct ConvertJob
+{
+    QString path;
+    QString fname;
+    QString OPath;
+};
 
-void doMagicIn(QString path, QString q, QString OPath, bool removeMode)
+struct ConvertResult
+{
+    ConvertResult() : converted(false), failed(false), bytes(0) {}
+    QString out; //Log lines, printed by main thread in order of jobs
+    QString err;
+    bool converted;
+    bool failed;
+    qint64 bytes; //Size of source images
+};
+
+ConvertResult doMagicIn(QString path, QString q, QString OPath, bool removeMode)
 {
+    ConvertResult result;
+
     QRegExp isMask = QRegExp("*m.gif");
     isMask.setPatternSyntax(QRegExp::Wildcard);
 
@@ -58,10 +60,10 @@ void doMagicIn(QString path, QString q, QString OPath, bool removeMode)
     isBackupDir.setPatternSyntax(QRegExp::Wildcard);
 
     if(isBackupDir.exactMatch(path))
-        return; //Skip backup directories
+        return result; //Skip backup directories
 
     if(isMask.exactMatch(q))
-        return;
+        return result;
 
     QImage target;
     QString imgFileM;
@@ -69,18 +71,20 @@ void doMagicIn(QString path, QString q, QString OPath, bool removeMode)
     if(tmp.size()==2)
         imgFileM = tmp[0] + "m." + tmp[1];
     else
-        return;
+        return result;
 
     QImage image = QImage(path+q);
     QImage mask = QImage(path+imgFileM);
 
-    target = setAlphaMask(image, mask);
+    target = MaskBlend::applyMask(image, mask);
 
     if(!target.isNull())
     {
+        result.bytes = QFileInfo(path+q).size() + QFileInfo(path+imgFileM).size();
         target.save(OPath+tmp[0]+".png");
-        QTextStream(stdout) << path+q <<"\n";
-        QTextStream(stdout) << OPath+tmp[0]+".png" <<"\n";
+        result.out += path+q +"\n";
+        result.out += OPath+tmp[0]+".png" +"\n";
+        result.converted = true;
         if(removeMode)
         {
             QFile::remove( path+q );
@@ -88,9 +92,25 @@ void doMagicIn(QString path, QString q, QString OPath, bool removeMode)
         }
     }
     else
-    QTextStream(stderr) << path+q+" - WRONG!\n";
+    {
+        result.err += path+q+" - WRONG!\n";
+        result.failed = true;
+    }
+
+    return result;
 }
 
+struct DoMagicJob
+{
+    typedef ConvertResult result_type;
+    DoMagicJob(bool removeMode) : removeMode(removeMode) {}
+    ConvertResult operator()(const ConvertJob &job) const
+    {
+        return doMagicIn(job.path, job.fname, job.OPath, removeMode);
+    }
+    bool removeMode;
+};
+
 int main(int argc, char *argv[])
 {
     QCoreApplication::addLibraryPath(".");
@@ -106,6 +126,8 @@ int main(int argc, char *argv[])
     bool walkSubDirs=false;
     bool cOpath=false;
     bool singleFiles=false;
+    int threads=1;
+    QList<ConvertJob> jobs;
 
     QString argPath;
     QString argOPath;
@@ -151,6 +173,23 @@ int main(int argc, char *argv[])
             nopause=true;
         }
         else
+        if(a.arguments().at(arg).startsWith("-j"))
+        {
+            //-j N, -jN or -j (all cores)
+            QString num = a.arguments().at(arg).mid(2);
+            bool ok=false;
+            if(num.isEmpty() && (arg+1<a.arguments().size()))
+            {
+                a.arguments().at(arg+1).toInt(&ok);
+                if(ok) num = a.arguments().at(++arg);
+            }
+            threads = num.toInt(&ok);
+            if(!ok || threads<=0)
+                threads = QThread::idealThreadCount();
+            if(threads<=0)
+                threads = 1;
+        }
+        else
         {
             //if begins from "-O"
             if(a.arguments().at(arg).size()>=2 && a.arguments().at(arg).at(0)=='-'&& a.arguments().at(arg).at(1)=='O')
@@ -210,10 +249,12 @@ int main(int argc, char *argv[])
     {
         foreach(QString q, fileList)
         {
-            path=QFileInfo(q).absoluteDir().path()+"/";
-            QString fname = QFileInfo(q).fileName();
-            if(cOpath) OPath=path;
-            doMagicIn(path, fname , OPath, removeMode);
+            ConvertJob job;
+            job.path=QFileInfo(q).absoluteDir().path()+"/";
+            job.fname = QFileInfo(q).fileName();
+            if(cOpath) OPath=job.path;
+            job.OPath = OPath;
+            jobs << job;
         }
     }
     else
@@ -222,7 +263,11 @@ int main(int argc, char *argv[])
     if(!walkSubDirs) //By directories
         foreach(QString q, fileList)
         {
-            doMagicIn(path, q, OPath, removeMode);
+            ConvertJob job;
+            job.path = path;
+            job.fname = q;
+            job.OPath = OPath;
+            jobs << job;
         }
         else
         {
@@ -237,13 +282,48 @@ int main(int argc, char *argv[])
                         continue;
 
                     if(cOpath) OPath = QFileInfo(dirsList.filePath()).dir().absolutePath()+"/";
-                    doMagicIn(QFileInfo(dirsList.filePath()).dir().absolutePath()+"/", dirsList.fileName(), OPath, removeMode);
+                    ConvertJob job;
+                    job.path = QFileInfo(dirsList.filePath()).dir().absolutePath()+"/";
+                    job.fname = dirsList.fileName();
+                    job.OPath = OPath;
+                    jobs << job;
               }
 
 
         }
     }
 
+    {
+        //Files are converted by pool of threads, results are printed in order of the files list
+        QElapsedTimer time;
+        time.start();
+
+        int converted=0;
+        int failed=0;
+        qint64 totalBytes=0;
+
+        QThreadPool::globalInstance()->setMaxThreadCount(threads);
+        QFuture<ConvertResult> results = QtConcurrent::mapped(jobs, DoMagicJob(removeMode));
+        for(int i=0; i<jobs.size(); i++)
+        {
+            ConvertResult r = results.resultAt(i);
+            if(!r.out.isEmpty()) QTextStream(stdout) << r.out;
+            if(!r.err.isEmpty()) QTextStream(stderr) << r.err;
+            if(r.converted) converted++;
+            if(r.failed) failed++;
+            totalBytes += r.bytes;
+        }
+
+        double seconds = double(time.elapsed())/1000.0;
+        if(seconds<=0.0) seconds = 0.001;
+        QTextStream(stdout) <<"============================================================================\n";
+        QTextStream(stdout) << QString("Converted %1 images, failed %2, in %3 sec using %4 threads\n")
+                               .arg(converted).arg(failed).arg(seconds, 0, 'f', 2).arg(threads);
+        QTextStream(stdout) << QString("Throughput: %1 images/sec, %2 MB/sec\n")
+                               .arg(double(converted)/seconds, 0, 'f', 1)
+                               .arg(double(totalBytes)/(1024.0*1024.0)/seconds, 0, 'f', 2);
+    }
+
     QTextStream(stdout) <<"============================================================================\n";
     QTextStream(stdout) <<"Done!\n\n";
 
@@ -256,13 +336,14 @@ DisplayHelp:
     QTextStream(stdout) <<"This utility will merge GIF images and his mask into solid PNG image:\n";
     QTextStream(stdout) <<"============================================================================\n";
     QTextStream(stdout) <<"Syntax:\n\n";
-    QTextStream(stdout) <<"   GIFs2PNG [--help] [-R] file1.gif [file2.gif] [...] [-O/path/to/out]\n";
-    QTextStream(stdout) <<"   GIFs2PNG [--help] [-W] [-R] /path/to/folder [-O/path/to/out]\n\n";
+    QTextStream(stdout) <<"   GIFs2PNG [--help] [-R] [-j N] file1.gif [file2.gif] [...] [-O/path/to/out]\n";
+    QTextStream(stdout) <<"   GIFs2PNG [--help] [-W] [-R] [-j N] /path/to/folder [-O/path/to/out]\n\n";
     QTextStream(stdout) <<" --help              - Display this help\n";
     QTextStream(stdout) <<" /path/to/folder     - path to a directory with pairs of GIF files\n";
     QTextStream(stdout) <<" -O/path/to/out      - path to a directory where the PNG images will be saved\n";
     QTextStream(stdout) <<" -R                  - Remove source images after succesfull converting\n";
     QTextStream(stdout) <<" -W                  - Also look for images in subdirectories\n";
+    QTextStream(stdout) <<" -j N                - Convert N images at same time (-j without N uses all CPU cores)\n";
     QTextStream(stdout) <<"\n\n";
 
     getchar();
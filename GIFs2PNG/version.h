@@ -23,12 +23,12 @@
 #define EDITOR_VERSION_H
 
 //Version of this program
-#define _FILE_VERSION "1.0.5"
+#define _FILE_VERSION "1.0.6"
 #define _FILE_RELEASE ""
 
 #define _VF1 1
 #define _VF2 0
-#define _VF3 5
+#define _VF3 6
 #define _VF4 0
 
 
@@ -28,254 +28,16 @@
 #include <QFileInfo>
 #include "version.h"
 
-#include "../_Libs/EasyBMP/EasyBMP.h"
-extern "C"{
-#include "../_Libs/giflib/gif_lib.h"
-}
+#include "../_common/bmp_reader.h"
+#include "../_common/gif_writer.h"
+#include "../_common/mask_blend.h"
 
 bool noBackUp=false;
-
-QImage setAlphaMask(QImage image, QImage mask);
-QImage setAlphaMask_VB(QImage image, QImage mask);
-
-
-bool toGif(QImage& img, QString& path);
-QImage fromBMP(QString &file);
-QImage loadQImage(QString file);
-
-void doMagicIn(QString path, QString q, QString OPath);
-
-
-QImage setAlphaMask(QImage image, QImage mask)
-{
-    if(mask.isNull())
-        return image;
-
-    if(image.isNull())
-        return image;
-
-    QImage target = image;
-    QImage newmask = mask;
-
-    if(target.size()!= newmask.size())
-    {
-        newmask = newmask.copy(0,0, target.width(), target.height());
-    }
-    target = setAlphaMask_VB(target, newmask);
-
-    return target;
-}
-
-//Implementation of VB similar transparency function
-QImage setAlphaMask_VB(QImage image, QImage mask)
-{
-    if(mask.isNull())
-        return image;
-
-    if(image.isNull())
-        return image;
-
-    bool isWhiteMask = true;
-
-    QImage target;
-
-    target = QImage(image.width(), image.height(), QImage::Format_ARGB32);
-    target.fill(qRgb(128,128,128));
-
-    QImage newmask = mask;
-    target.convertToFormat(QImage::Format_ARGB32);
-
-    if(target.size()!= newmask.size())
-    {
-        newmask = newmask.copy(0, 0, target.width(), target.height());
-    }
-
-    QImage alphaChannel = image.alphaChannel();
-
-    //vbSrcAnd
-    for(int y=0; y< image.height(); y++ )
-        for(int x=0; x < image.width(); x++ )
-        {
-            QColor Dpix = QColor(target.pixel(x,y));
-            QColor Spix = QColor(newmask.pixel(x,y));
-            QColor Npix;
-
-            Npix.setAlpha(255);
-            Npix.setRed( Dpix.red() & Spix.red());
-            Npix.setGreen( Dpix.green() & Spix.green());
-            Npix.setBlue( Dpix.blue() & Spix.blue());
-            target.setPixel(x, y, Npix.rgba());
-
-            isWhiteMask &= ( (Spix.red()>240) //is almost White
-                             &&(Spix.green()>240)
-                             &&(Spix.blue()>240));
-
-            int newAlpha = 255-((Spix.red() + Spix.green() + Spix.blue())/3);
-
-            if( (Spix.red()>240) //is almost White
-                            &&(Spix.green()>240)
-                            &&(Spix.blue()>240))
-            {
-                newAlpha = 0;
-            }
-
-            alphaChannel.setPixel(x,y, newAlpha);
-        }
-
-    //vbSrcPaint
-    for(int y=0; y< image.height(); y++ )
-        for(int x=0; x < image.width(); x++ )
-        {
-            QColor Dpix = QColor(image.pixel(x,y));
-            QColor Spix = QColor(target.pixel(x,y));
-            QColor Npix;
-
-            Npix.setAlpha(255);
-            Npix.setRed( Dpix.red() | Spix.red());
-            Npix.setGreen( Dpix.green() | Spix.green());
-            Npix.setBlue( Dpix.blue() | Spix.blue());
-            target.setPixel(x, y, Npix.rgba());
-
-            //QColor curAlpha;
-            int curAlpha = QColor(alphaChannel.pixel(x,y)).red();
-            int newAlpha = curAlpha+((Dpix.red() + Dpix.green() + Dpix.blue())/3);
-
-            if(newAlpha>255) newAlpha=255;
-            alphaChannel.setPixel(x,y, newAlpha);
-        }
-
-    target.setAlphaChannel(alphaChannel);
-
-    return target;
-}
-
-
-bool toGif(QImage& img, QString& path)
-{
-    int errcode;
-
-    if(QFile(path).exists()) // Remove old file
-        QFile::remove(path);
-
-    GifFileType* t = EGifOpenFileName(path.toLocal8Bit().data(),true, &errcode);
-    if(!t){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "Can't open\n";
-        return false;
-    }
-
-    EGifSetGifVersion(t, true);
-
-    GifColorType* colorArr = new GifColorType[256];
-    ColorMapObject* cmo = GifMakeMapObject(256, colorArr);
-
-    bool unfinished = false;
-    QImage tarQImg(img.width(), img.height(), QImage::Format_Indexed8);
-    QVector<QRgb> table;
-    for(int y = 0; y < img.height(); y++){
-        for(int x = 0; x < img.width(); x++){
-            if(table.size() >= 256){
-                unfinished = true;
-                break;
-            }
-            QRgb pix;
-            if(!table.contains(pix = img.pixel(x,y))){
-                table.push_back(pix);
-                tarQImg.setColor(tarQImg.colorCount(), pix);
-            }
-            tarQImg.setPixel(x,y,table.indexOf(pix));
-        }
-        if(table.size() >= 256){
-            unfinished = true;
-            break;
-        }
-    }
-
-    if(unfinished){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "Unfinished\n";
-        return false;
-    }
-
-
-    for(int l = tarQImg.colorCount(); l < 256; l++){
-        tarQImg.setColor(l,0);
-    }
-
-    if(tarQImg.colorTable().size() != 256){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "A lot of colors\n";
-        return false;
-    }
-
-    QVector<QRgb> clTab = tarQImg.colorTable();
-
-    for(int i = 0; i < 255; i++){
-        QRgb rgb = clTab[i];
-        colorArr[i].Red = qRed(rgb);
-        colorArr[i].Green = qGreen(rgb);
-        colorArr[i].Blue = qBlue(rgb);
-    }
-    cmo->Colors = colorArr;
-
-    errcode = EGifPutScreenDesc(t, img.width(), img.height(), 256, 0, cmo);
-    if(errcode != GIF_OK){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "EGifPutScreenDesc error 1\n";
-        return false;
-    }
-
-    errcode = EGifPutImageDesc(t, 0, 0, img.width(), img.height(), false, 0);
-    if(errcode != GIF_OK){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "EGifPutImageDesc error 2\n";
-        return false;
-    }
-
-    //gen byte array
-    GifByteType* byteArr = tarQImg.bits();
-
-    for(int h = 0; h < tarQImg.height(); h++){
-        errcode = EGifPutLine(t, byteArr, tarQImg.width());
-        if(errcode != GIF_OK){
-            EGifCloseFile(t, &errcode);
-            QTextStream(stdout)  << "EGifPutLine error 3\n";
-            return false;
-        }
-
-        byteArr += tarQImg.width();
-        byteArr += ((tarQImg.width() % 4)!=0 ? 4 - (tarQImg.width() % 4) : 0);
-    }
-
-    if(errcode != GIF_OK){
-        QTextStream(stdout)  << "GIF error 4\n";
-        return false;
-    }
-    EGifCloseFile(t, &errcode);
-
-    return true;
-}
+GifWriter::QuantizeMode gifQuantize=GifWriter::NoQuantize;
 
 QImage fromBMP(QString &file)
 {
-    QImage errImg;
-
-    BMP tarBMP;
-    if(!tarBMP.ReadFromFile( file.toLocal8Bit().data() )){
-        //WriteToLog(QtCriticalMsg, QString("Error: File does not exsist"));
-        return errImg; //Check if empty with errImg.isNull();
-    }
-
-    QImage bmpImg(tarBMP.TellWidth(),tarBMP.TellHeight(),QImage::Format_RGB666);
-
-    for(int x = 0; x < tarBMP.TellWidth(); x++){
-        for(int y = 0; y < tarBMP.TellHeight(); y++){
-            RGBApixel pixAt = tarBMP.GetPixel(x,y);
-            bmpImg.setPixel(x,y,qRgb(pixAt.Red, pixAt.Green, pixAt.Blue));
-        }
-    }
-
-    return bmpImg;
+    return BmpReader::load(file);
 }
 
 QImage loadQImage(QString file)
@@ -324,7 +86,7 @@ void doMagicIn(QString path, QString q, QString OPath)
 
         saveTo = QString(OPath+(tmp[0].toLower())+".gif");
         //overwrite source image (convert BMP to GIF)
-        if(toGif( image, saveTo ) ) //Write gif
+        if(GifWriter::toGif(image, saveTo, gifQuantize) ) //Write gif
         {
             QTextStream(stdout) <<"GIF-1 only\n";
         }
@@ -361,7 +123,7 @@ void doMagicIn(QString path, QString q, QString OPath)
     if(mask.isNull()) //Skip null masks
         return;
 
-    target = setAlphaMask(image, mask);
+    target = MaskBlend::applyMaskVB(image, mask);
 
     if(!target.isNull())
     {
@@ -385,7 +147,7 @@ void doMagicIn(QString path, QString q, QString OPath)
         saveTo = QString(OPath+(tmp[0].toLower())+".gif");
 
         //overwrite source image (convert BMP to GIF)
-        if(toGif(image, saveTo ) ) //Write gif
+        if(GifWriter::toGif(image, saveTo, gifQuantize) ) //Write gif
         {
             QTextStream(stdout) <<"GIF-1 ";
         }
@@ -398,7 +160,7 @@ void doMagicIn(QString path, QString q, QString OPath)
         saveTo = QString(OPath+(tmp[0].toLower())+"m.gif");
 
         //overwrite mask image
-        if( toGif(mask, saveTo ) ) //Write gif
+        if( GifWriter::toGif(mask, saveTo, gifQuantize) ) //Write gif
         {
             QTextStream(stdout) <<"GIF-2\n";
         }
@@ -468,6 +230,17 @@ int main(int argc, char *argv[])
         {
             walkSubDirs=true;
         }
+        else
+        if(a.arguments().at(arg)=="-Q")
+        {
+            if(gifQuantize==GifWriter::NoQuantize)
+                gifQuantize=GifWriter::Quantize;
+        }
+        else
+        if(a.arguments().at(arg)=="-D")
+        {
+            gifQuantize=GifWriter::QuantizeDither;
+        }
 //        else
 //        if(a.arguments().at(arg)=="-G")
 //        {
@@ -585,13 +358,16 @@ DisplayHelp:
     QTextStream(stdout) <<"This utility will fix lazily-made image masks:\n";
     QTextStream(stdout) <<"============================================================================\n";
     QTextStream(stdout) <<"Syntax:\n\n";
-    QTextStream(stdout) <<"   LazyFixTool [--help] [-N] [-G] file1.gif [file2.gif] [...] [-O/path/to/out]\n";
-    QTextStream(stdout) <<"   LazyFixTool [--help] [-W] [-N] [-G] /path/to/folder [-O/path/to/out]\n\n";
+    QTextStream(stdout) <<"   LazyFixTool [--help] [-N] [-Q|-D] file1.gif [file2.gif] [...] [-O/path/to/out]\n";
+    QTextStream(stdout) <<"   LazyFixTool [--help] [-W] [-N] [-Q|-D] /path/to/folder [-O/path/to/out]\n\n";
     QTextStream(stdout) <<" --help              - Display this help\n";
     QTextStream(stdout) <<" /path/to/folder     - path to a directory with a pair of GIF files\n";
     QTextStream(stdout) <<" -O/path/to/out      - path to a directory where the new images will be saved\n";
     QTextStream(stdout) <<" -W                  - Also look for images in subdirectories\n";
     QTextStream(stdout) <<" -N                  - Don't create backup\n";
+    QTextStream(stdout) <<" -Q                  - Reduce colors of images with more than 256 colors\n";
+    QTextStream(stdout) <<"                       instead of saving them as BMP\n";
+    QTextStream(stdout) <<" -D                  - Same as -Q, but with dithering\n";
     //QTextStream(stdout) <<" -G                  - Make gray shades on masks darker\n";
     QTextStream(stdout) <<"\n\n";
 
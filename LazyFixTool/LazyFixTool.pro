@@ -68,16 +68,17 @@ SOURCES += \
     ../_Libs/giflib/gif_hash.c \
     ../_Libs/giflib/gifalloc.c \
     ../_Libs/giflib/quantize.c \
-    ../_Libs/EasyBMP/EasyBMP.cpp
+    ../_common/gif_writer.cpp \
+    ../_common/mask_blend.cpp \
+    ../_common/bmp_reader.cpp
 
 HEADERS += \
+    ../_common/gif_writer.h \
+    ../_common/mask_blend.h \
     ../_Libs/giflib/gif_hash.h \
     ../_Libs/giflib/gif_lib.h \
     ../_Libs/giflib/gif_lib_private.h \
-    ../_Libs/EasyBMP/EasyBMP.h \
-    ../_Libs/EasyBMP/EasyBMP_BMP.h \
-    ../_Libs/EasyBMP/EasyBMP_DataStructures.h \
-    ../_Libs/EasyBMP/EasyBMP_VariousBMPutilities.h \
+    ../_common/bmp_reader.h \
     version.h
 
 RESOURCES += \
@@ -27,139 +27,11 @@
 #include <QFileInfo>
 #include "version.h"
 
-extern "C"{
-	#include "../_Libs/giflib/gif_lib.h"
-}
+#include "../_common/gif_writer.h"
+#include "../_common/mask_blend.h"
 
 bool removeSource=false;
-
-QImage setAlphaMask(QImage image, QImage mask)
-{
-    if(mask.isNull())
-        return image;
-
-    if(image.isNull())
-        return image;
-
-    QImage target = image;
-    QImage newmask = mask;
-
-    if(target.size()!= newmask.size())
-    {
-        newmask = newmask.copy(0,0, target.width(), target.height());
-    }
-
-    newmask.invertPixels();
-
-    target.setAlphaChannel(newmask);
-
-    return target;
-}
-
-bool toGif(QImage& img, QString& path){
-    int errcode;
-
-    if(QFile(path).exists()) // Remove old file
-        QFile::remove(path);
-
-    GifFileType* t = EGifOpenFileName(path.toLocal8Bit().data(),true, &errcode);
-    if(!t){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "Can't open\n";
-        return false;
-    }
-
-    EGifSetGifVersion(t, true);
-
-    GifColorType* colorArr = new GifColorType[256];
-    ColorMapObject* cmo = GifMakeMapObject(256, colorArr);
-
-    bool unfinished = false;
-    QImage tarQImg(img.width(), img.height(), QImage::Format_Indexed8);
-    QVector<QRgb> table;
-    for(int y = 0; y < img.height(); y++){
-        for(int x = 0; x < img.width(); x++){
-            if(table.size() >= 256){
-                unfinished = true;
-                break;
-            }
-            QRgb pix;
-            if(!table.contains(pix = img.pixel(x,y))){
-                table.push_back(pix);
-                tarQImg.setColor(tarQImg.colorCount(), pix);
-            }
-            tarQImg.setPixel(x,y,table.indexOf(pix));
-        }
-        if(table.size() >= 256){
-            unfinished = true;
-            break;
-        }
-    }
-
-    if(unfinished){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "Unfinished\n";
-        return false;
-    }
-
-
-    for(int l = tarQImg.colorCount(); l < 256; l++){
-        tarQImg.setColor(l,0);
-    }
-
-    if(tarQImg.colorTable().size() != 256){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "A lot of colors\n";
-        return false;
-    }
-
-    QVector<QRgb> clTab = tarQImg.colorTable();
-
-    for(int i = 0; i < 255; i++){
-        QRgb rgb = clTab[i];
-        colorArr[i].Red = qRed(rgb);
-        colorArr[i].Green = qGreen(rgb);
-        colorArr[i].Blue = qBlue(rgb);
-    }
-    cmo->Colors = colorArr;
-
-    errcode = EGifPutScreenDesc(t, img.width(), img.height(), 256, 0, cmo);
-    if(errcode != GIF_OK){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "EGifPutScreenDesc error 1\n";
-        return false;
-    }
-
-    errcode = EGifPutImageDesc(t, 0, 0, img.width(), img.height(), false, 0);
-    if(errcode != GIF_OK){
-        EGifCloseFile(t, &errcode);
-        QTextStream(stdout)  << "EGifPutImageDesc error 2\n";
-        return false;
-    }
-
-    //gen byte array
-    GifByteType* byteArr = tarQImg.bits();
-
-    for(int h = 0; h < tarQImg.height(); h++){
-        errcode = EGifPutLine(t, byteArr, tarQImg.width());
-        if(errcode != GIF_OK){
-            EGifCloseFile(t, &errcode);
-            QTextStream(stdout)  << "EGifPutLine error 3\n";
-            return false;
-        }
-
-        byteArr += tarQImg.width();
-        byteArr += ((tarQImg.width() % 4)!=0 ? 4 - (tarQImg.width() % 4) : 0);
-    }
-
-    if(errcode != GIF_OK){
-        QTextStream(stdout)  << "GIF error 4\n";
-        return false;
-    }
-    EGifCloseFile(t, &errcode);
-
-    return true;
-}
+GifWriter::QuantizeMode gifQuantize=GifWriter::NoQuantize;
 
 QImage loadQImage(QString file)
 {
@@ -189,11 +61,10 @@ void doMagicIn(QString path, QString q, QString OPath)
 
     QTextStream(stdout) << path+q+"\n";
 
-    mask = ImgSrc.alphaChannel();
-    mask.invertPixels();
+    MaskBlend::splitMask(ImgSrc, image, mask);
 
     //Write mask image
-    if( toGif(mask, saveToMask ) ) //Write gif
+    if( GifWriter::toGif(mask, saveToMask, gifQuantize) ) //Write gif
     {
         QTextStream(stdout) <<"GIF-1\n";
     }
@@ -205,27 +76,8 @@ void doMagicIn(QString path, QString q, QString OPath)
 
 
 
-    image = ImgSrc;
-    mask = ImgSrc.alphaChannel();
-    mask.invertPixels();
-    for(int w=0; w < mask.width(); w++)
-        for(int h=0; h < mask.height(); h++)
-        {
-            if(mask.pixel(w,h)==qRgb(0xFF,0xFF,0xFF)) //Fill white pixel into black on image
-            {
-                image.setPixel(w,h, qRgb(0,0,0));
-            }
-            else
-            if(mask.pixel(w,h)!=qRgb(0,0,0)) //Fill non-black pixel color into black on mask
-            {
-                mask.setPixel(w,h, qGray(0,0,0));
-            }
-        }
-    mask.invertPixels();
-    image.setAlphaChannel(mask);
-
     //Write mask image
-    if( toGif(image, saveToImg ) ) //Write gif
+    if( GifWriter::toGif(image, saveToImg, gifQuantize) ) //Write gif
     {
         QTextStream(stdout) <<"GIF-2\n";
     }
@@ -288,6 +140,17 @@ int main(int argc, char *argv[])
             walkSubDirs=true;
         }
         else
+        if(a.arguments().at(arg)=="-Q")
+        {
+            if(gifQuantize==GifWriter::NoQuantize)
+                gifQuantize=GifWriter::Quantize;
+        }
+        else
+        if(a.arguments().at(arg)=="-D")
+        {
+            gifQuantize=GifWriter::QuantizeDither;
+        }
+        else
         if(a.arguments().at(arg)=="--nopause")
         {
             nopause=true;
@@ -400,13 +263,16 @@ DisplayHelp:
     QTextStream(stdout) <<"This utility will convert PNG images into GIF with masks format:\n";
     QTextStream(stdout) <<"============================================================================\n";
     QTextStream(stdout) <<"Syntax:\n\n";
-    QTextStream(stdout) <<"   PNG2GIFs [--help] [-R] file1.png [file2.png] [...] [-O/path/to/out]\n";
-    QTextStream(stdout) <<"   PNG2GIFs [--help] [-W] [-R] /path/to/folder [-O/path/to/out]\n\n";
+    QTextStream(stdout) <<"   PNG2GIFs [--help] [-R] [-Q|-D] file1.png [file2.png] [...] [-O/path/to/out]\n";
+    QTextStream(stdout) <<"   PNG2GIFs [--help] [-W] [-R] [-Q|-D] /path/to/folder [-O/path/to/out]\n\n";
     QTextStream(stdout) <<" --help              - Display this help\n";
     QTextStream(stdout) <<" /path/to/folder     - path to a directory with PNG files\n";
     QTextStream(stdout) <<" -O/path/to/out      - path to a directory where the pairs of GIF images will be saved\n";
     QTextStream(stdout) <<" -R                  - Remove source images after successful conversion\n";
     QTextStream(stdout) <<" -W                  - Also look for images in subdirectories\n";
+    QTextStream(stdout) <<" -Q                  - Reduce colors of images with more than 256 colors\n";
+    QTextStream(stdout) <<"                       instead of saving them as BMP\n";
+    QTextStream(stdout) <<" -D                  - Same as -Q, but with dithering\n";
     QTextStream(stdout) <<"\n\n";
 
     getchar();
@@ -68,8 +68,12 @@ SOURCES += \
     ../_Libs/giflib/gif_hash.c \
     ../_Libs/giflib/gifalloc.c \
     ../_Libs/giflib/quantize.c \
+    ../_common/gif_writer.cpp \
+    ../_common/mask_blend.cpp \
 
 HEADERS += \
+    ../_common/gif_writer.h \
+    ../_common/mask_blend.h \
     ../_Libs/giflib/gif_hash.h \
     ../_Libs/giflib/gif_lib.h \
     ../_Libs/giflib/gif_lib_private.h \
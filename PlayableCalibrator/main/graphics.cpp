@@ -18,6 +18,7 @@
  */
 
 #include "graphics.h"
+#include "../../_common/bmp_reader.h"
 
 QImage Graphics::setAlphaMask(QImage image, QImage mask)
 {
@@ -151,24 +152,7 @@ bool Graphics::toGif(QImage& img, QString& path)
 
 QImage Graphics::fromBMP(QString &file)
 {
-    QImage errImg;
-
-    BMP tarBMP;
-    if(!tarBMP.ReadFromFile(file.toStdString().c_str())){
-        //WriteToLog(QtCriticalMsg, QString("Error: File does not exsist"));
-        return errImg; //Check if empty with errImg.isNull();
-    }
-
-    QImage bmpImg(tarBMP.TellWidth(),tarBMP.TellHeight(),QImage::Format_RGB666);
-
-    for(int x = 0; x < tarBMP.TellWidth(); x++){
-        for(int y = 0; y < tarBMP.TellHeight(); y++){
-            RGBApixel pixAt = tarBMP.GetPixel(x,y);
-            bmpImg.setPixel(x,y,qRgb(pixAt.Red, pixAt.Green, pixAt.Blue));
-        }
-    }
-
-    return bmpImg;
+    return BmpReader::load(file);
 }
 
 QImage Graphics::loadQImage(QString file)
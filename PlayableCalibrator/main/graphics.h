@@ -20,7 +20,6 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
-#include "../../_Libs/EasyBMP/EasyBMP.h"
 extern "C"
 {
     #include "../../_Libs/giflib/gif_lib.h"
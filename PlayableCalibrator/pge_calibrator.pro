@@ -62,7 +62,7 @@ SOURCES += main.cpp\
     animator/animate.cpp \
     animator/animationedit.cpp \
     frame_matrix/MatrixScene.cpp \
-    ../_Libs/EasyBMP/EasyBMP.cpp \
+    ../_common/bmp_reader.cpp \
     ../_Libs/giflib/dgif_lib.c \
     ../_Libs/giflib/egif_lib.c \
     ../_Libs/giflib/gif_err.c \
@@ -88,10 +88,7 @@ HEADERS  += calibrationmain.h \
     animator/AnimationScene.h \
     frame_matrix/MatrixScene.h \
     animator/SpriteScene.h \
-    ../_Libs/EasyBMP/EasyBMP.h \
-    ../_Libs/EasyBMP/EasyBMP_BMP.h \
-    ../_Libs/EasyBMP/EasyBMP_DataStructures.h \
-    ../_Libs/EasyBMP/EasyBMP_VariousBMPutilities.h \
+    ../_common/bmp_reader.h \
     ../_Libs/giflib/gif_hash.h \
     ../_Libs/giflib/gif_lib.h \
     ../_Libs/giflib/gif_lib_private.h \
@@ -0,0 +1,215 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bmp_reader.h"
+
+#include <QFile>
+
+static inline quint16 readU16(const uchar *p)
+{
+    return quint16(p[0] | (p[1] << 8));
+}
+
+static inline quint32 readU32(const uchar *p)
+{
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+//Color channel described by bit mask of 16 and 32-bit pixels
+struct BmpChannel
+{
+    BmpChannel(quint32 mask=0) : mask(mask), shift(0), max(0)
+    {
+        if(mask == 0) return;
+        while(((mask >> shift) & 1) == 0)
+            shift++;
+        max = mask >> shift;
+    }
+
+    inline uint get(quint32 pixel) const
+    {
+        if(max == 0) return 0;
+        return uint((quint64((pixel & mask) >> shift) * 255 + max/2) / max);
+    }
+
+    quint32 mask;
+    int shift;
+    quint32 max;
+};
+
+QImage BmpReader::load(const QString &file)
+{
+    QFile f(file);
+    if(!f.open(QIODevice::ReadOnly))
+        return QImage();
+    return fromData(f.readAll());
+}
+
+QImage BmpReader::fromData(const QByteArray &data)
+{
+    const uchar *raw = reinterpret_cast<const uchar*>(data.constData());
+    const qint64 size = data.size();
+
+    if((size < 26) || (raw[0] != 'B') || (raw[1] != 'M'))
+        return QImage();
+
+    quint32 pixelsOffset = readU32(raw+10);
+    quint32 headerSize = readU32(raw+14);
+
+    int width, height, bpp;
+    quint32 compression = 0;
+    quint32 colorsUsed = 0;
+    int paletteEntry;
+
+    if(headerSize == 12) //OS/2 BITMAPCOREHEADER
+    {
+        width  = readU16(raw+18);
+        height = qint16(readU16(raw+20));
+        bpp    = readU16(raw+24);
+        paletteEntry = 3;
+    }
+    else if((headerSize >= 40) && (size >= 54))
+    {
+        width  = qint32(readU32(raw+18));
+        height = qint32(readU32(raw+22));
+        bpp    = readU16(raw+28);
+        compression = readU32(raw+30);
+        colorsUsed  = readU32(raw+46);
+        paletteEntry = 4;
+    }
+    else
+        return QImage();
+
+    bool topDown = (height < 0);
+    if(topDown) height = -height;
+
+    if((width <= 0) || (height <= 0) || (width > 32768) || (height > 32768))
+        return QImage();
+
+    //RLE is not supported (as it was with EasyBMP)
+    if((compression != 0) && (compression != 3))
+        return QImage();
+
+    BmpChannel red, green, blue;
+    switch(bpp)
+    {
+    case 1: case 4: case 8: case 24:
+        if(compression != 0) return QImage();
+        break;
+    case 16:
+    case 32:
+        if(compression == 3)
+        {
+            //Masks are placed after 40-byte header, or inside of V4/V5 header at the same place
+            if(size < 66) return QImage();
+            red   = BmpChannel(readU32(raw+54));
+            green = BmpChannel(readU32(raw+58));
+            blue  = BmpChannel(readU32(raw+62));
+        }
+        else if(bpp == 16)
+        {
+            red = BmpChannel(0x7C00); green = BmpChannel(0x03E0); blue = BmpChannel(0x001F);
+        }
+        else
+        {
+            red = BmpChannel(0xFF0000); green = BmpChannel(0x00FF00); blue = BmpChannel(0x0000FF);
+        }
+        break;
+    default:
+        return QImage();
+    }
+
+    QRgb palette[256];
+    for(int i = 0; i < 256; i++)
+        palette[i] = 0xFF000000;
+
+    if(bpp <= 8)
+    {
+        qint64 paletteOffset = 14 + qint64(headerSize);
+        quint32 count = colorsUsed ? colorsUsed : (1u << bpp);
+        if(count > 256) count = 256;
+        for(quint32 i = 0; i < count; i++)
+        {
+            const qint64 at = paletteOffset + qint64(i)*paletteEntry;
+            if(at + 3 > size) break;
+            palette[i] = qRgb(raw[at+2], raw[at+1], raw[at]);
+        }
+    }
+
+    //Rows are aligned by 4 bytes, last row may come without padding
+    const qint64 stride = ((qint64(width)*bpp + 31) / 32) * 4;
+    const qint64 rowBytes = (qint64(width)*bpp + 7) / 8;
+    if(qint64(pixelsOffset) + stride*(height-1) + rowBytes > size)
+        return QImage();
+
+    QImage image(width, height, QImage::Format_ARGB32);
+    if(image.isNull())
+        return image;
+
+    bool standard32 = (bpp == 32) && (red.mask == 0xFF0000) && (green.mask == 0xFF00) && (blue.mask == 0xFF);
+
+    for(int y = 0; y < height; y++)
+    {
+        const uchar *src = raw + pixelsOffset + stride*y;
+        QRgb *out = reinterpret_cast<QRgb*>(image.scanLine(topDown ? y : (height - 1 - y)));
+
+        switch(bpp)
+        {
+        case 1:
+            for(int x = 0; x < width; x++)
+                out[x] = palette[(src[x >> 3] >> (7 - (x & 7))) & 1];
+            break;
+        case 4:
+            for(int x = 0; x < width; x++)
+                out[x] = palette[(x & 1) ? (src[x >> 1] & 0x0F) : (src[x >> 1] >> 4)];
+            break;
+        case 8:
+            for(int x = 0; x < width; x++)
+                out[x] = palette[src[x]];
+            break;
+        case 16:
+            for(int x = 0; x < width; x++, src += 2)
+            {
+                quint32 px = readU16(src);
+                out[x] = qRgb(red.get(px), green.get(px), blue.get(px));
+            }
+            break;
+        case 24:
+            for(int x = 0; x < width; x++, src += 3)
+                out[x] = 0xFF000000 | (quint32(src[2]) << 16) | (quint32(src[1]) << 8) | src[0];
+            break;
+        case 32:
+            if(standard32)
+            {
+                for(int x = 0; x < width; x++, src += 4)
+                    out[x] = 0xFF000000 | readU32(src);
+            }
+            else
+            {
+                for(int x = 0; x < width; x++, src += 4)
+                {
+                    quint32 px = readU32(src);
+                    out[x] = qRgb(red.get(px), green.get(px), blue.get(px));
+                }
+            }
+            break;
+        }
+    }
+
+    return image;
+}
@@ -0,0 +1,40 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BMP_READER_H
+#define BMP_READER_H
+
+#include <QImage>
+#include <QString>
+#include <QByteArray>
+
+/*!
+ * \brief Decoder of uncompressed BMP files which Qt sometimes can't read
+ *
+ * Supports 1, 4, 8, 16, 24 and 32 bits per pixel, Windows and OS/2 headers,
+ * bottom-up and top-down rows. Image is decoded row by row into Format_ARGB32,
+ * alpha is always opaque. Returns null image on any error.
+ */
+class BmpReader
+{
+public:
+    static QImage load(const QString &file);
+    static QImage fromData(const QByteArray &data);
+};
+
+#endif // BMP_READER_H
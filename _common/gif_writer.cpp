@@ -0,0 +1,264 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gif_writer.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QByteArray>
+
+extern "C"{
+#include "../_Libs/giflib/gif_lib.h"
+}
+
+bool GifWriter::makeIndexed(const QImage &img, QImage &target, QVector<QRgb> &palette)
+{
+    QImage src = img.convertToFormat(QImage::Format_ARGB32);
+    target = QImage(src.width(), src.height(), QImage::Format_Indexed8);
+    palette.clear();
+
+    //Open addressing hash, for 256 colors it's never filled more than a half
+    const int slotsCount = 512;
+    QRgb slotColor[slotsCount];
+    int  slotIndex[slotsCount];
+    for(int i = 0; i < slotsCount; i++)
+        slotIndex[i] = -1;
+
+    QRgb lastColor = 0;
+    int lastIndex = -1;
+
+    for(int y = 0; y < src.height(); y++)
+    {
+        const QRgb *line = reinterpret_cast<const QRgb*>(src.constScanLine(y));
+        uchar *out = target.scanLine(y);
+        for(int x = 0; x < src.width(); x++)
+        {
+            QRgb pix = line[x] | 0xFF000000; //GIF has no alpha channel
+
+            //Sprites have long runs of same color
+            if((lastIndex >= 0) && (pix == lastColor))
+            {
+                out[x] = uchar(lastIndex);
+                continue;
+            }
+
+            unsigned int h = (pix * 2654435761u) >> 23;
+            while((slotIndex[h] >= 0) && (slotColor[h] != pix))
+                h = (h+1) & (slotsCount-1);
+
+            if(slotIndex[h] < 0)
+            {
+                if(palette.size() >= 256)
+                    return false;
+                slotColor[h] = pix;
+                slotIndex[h] = palette.size();
+                palette.push_back(pix);
+            }
+
+            lastColor = pix;
+            lastIndex = slotIndex[h];
+            out[x] = uchar(lastIndex);
+        }
+    }
+
+    target.setColorTable(palette);
+    return true;
+}
+
+static int nearestColor(const GifColorType *colors, int count, int r, int g, int b)
+{
+    int best = 0;
+    int bestDist = 0x7FFFFFFF;
+    for(int i = 0; i < count; i++)
+    {
+        int dr = r - colors[i].Red;
+        int dg = g - colors[i].Green;
+        int db = b - colors[i].Blue;
+        int dist = dr*dr + dg*dg + db*db;
+        if(dist < bestDist)
+        {
+            bestDist = dist;
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool GifWriter::quantize(const QImage &img, QImage &target, QVector<QRgb> &palette, bool dither)
+{
+    QImage src = img.convertToFormat(QImage::Format_ARGB32);
+    int w = src.width();
+    int h = src.height();
+    if((w <= 0) || (h <= 0))
+        return false;
+
+    QByteArray red(w*h, 0), green(w*h, 0), blue(w*h, 0), indexes(w*h, 0);
+    GifByteType *r = reinterpret_cast<GifByteType*>(red.data());
+    GifByteType *g = reinterpret_cast<GifByteType*>(green.data());
+    GifByteType *b = reinterpret_cast<GifByteType*>(blue.data());
+    for(int y = 0; y < h; y++)
+    {
+        const QRgb *line = reinterpret_cast<const QRgb*>(src.constScanLine(y));
+        for(int x = 0; x < w; x++, r++, g++, b++)
+        {
+            *r = GifByteType(qRed(line[x]));
+            *g = GifByteType(qGreen(line[x]));
+            *b = GifByteType(qBlue(line[x]));
+        }
+    }
+
+    //Median cut of giflib
+    GifColorType colors[256];
+    int colorsCount = 256;
+    if(GifQuantizeBuffer(w, h, &colorsCount,
+                         reinterpret_cast<GifByteType*>(red.data()),
+                         reinterpret_cast<GifByteType*>(green.data()),
+                         reinterpret_cast<GifByteType*>(blue.data()),
+                         reinterpret_cast<GifByteType*>(indexes.data()), colors) != GIF_OK)
+        return false;
+
+    palette.clear();
+    for(int i = 0; i < colorsCount; i++)
+        palette.push_back(qRgb(colors[i].Red, colors[i].Green, colors[i].Blue));
+
+    target = QImage(w, h, QImage::Format_Indexed8);
+
+    if(!dither)
+    {
+        for(int y = 0; y < h; y++)
+            memcpy(target.scanLine(y), indexes.constData()+y*w, size_t(w));
+        target.setColorTable(palette);
+        return true;
+    }
+
+    //Floyd-Steinberg. Errors are kept multiplied by 16, rows have one extra pixel on each side
+    QVector<short> nearestCache(32768, -1);
+    QVector<int> errCur((w+2)*3, 0);
+    QVector<int> errNext((w+2)*3, 0);
+
+    for(int y = 0; y < h; y++)
+    {
+        const QRgb *line = reinterpret_cast<const QRgb*>(src.constScanLine(y));
+        uchar *out = target.scanLine(y);
+        errNext.fill(0);
+        int *ec = errCur.data();
+        int *en = errNext.data();
+
+        for(int x = 0; x < w; x++)
+        {
+            int *e = ec + (x+1)*3;
+            int pr = qBound(0, qRed(line[x])   + e[0]/16, 255);
+            int pg = qBound(0, qGreen(line[x]) + e[1]/16, 255);
+            int pb = qBound(0, qBlue(line[x])  + e[2]/16, 255);
+
+            int key = ((pr>>3)<<10) | ((pg>>3)<<5) | (pb>>3);
+            int idx = nearestCache[key];
+            if(idx < 0)
+            {
+                idx = nearestColor(colors, colorsCount, pr, pg, pb);
+                nearestCache[key] = short(idx);
+            }
+            out[x] = uchar(idx);
+
+            int d[3] = { pr - colors[idx].Red, pg - colors[idx].Green, pb - colors[idx].Blue };
+            for(int c = 0; c < 3; c++)
+            {
+                ec[(x+2)*3+c] += d[c]*7;
+                en[(x  )*3+c] += d[c]*3;
+                en[(x+1)*3+c] += d[c]*5;
+                en[(x+2)*3+c] += d[c];
+            }
+        }
+        errCur.swap(errNext);
+    }
+
+    target.setColorTable(palette);
+    return true;
+}
+
+bool GifWriter::toGif(QImage &img, QString &path, QuantizeMode mode)
+{
+    int errcode;
+
+    QImage tarQImg;
+    QVector<QRgb> palette;
+    if(!makeIndexed(img, tarQImg, palette))
+    {
+        if(mode == NoQuantize)
+        {
+            QTextStream(stdout)  << "Unfinished\n";
+            return false;
+        }
+
+        if(!quantize(img, tarQImg, palette, (mode == QuantizeDither)))
+        {
+            QTextStream(stdout)  << "Can't reduce colors\n";
+            return false;
+        }
+        QTextStream(stdout)  << "Colors reduced to " << palette.size() << "\n";
+    }
+
+    if(QFile(path).exists()) // Remove old file
+        QFile::remove(path);
+
+    GifFileType* t = EGifOpenFileName(path.toLocal8Bit().data(),true, &errcode);
+    if(!t){
+        QTextStream(stdout)  << "Can't open\n";
+        return false;
+    }
+
+    EGifSetGifVersion(t, true);
+
+    GifColorType colorArr[256];
+    for(int i = 0; i < 256; i++){
+        QRgb rgb = (i < palette.size()) ? palette[i] : 0;
+        colorArr[i].Red = qRed(rgb);
+        colorArr[i].Green = qGreen(rgb);
+        colorArr[i].Blue = qBlue(rgb);
+    }
+    ColorMapObject* cmo = GifMakeMapObject(256, colorArr);
+
+    //Screen descriptor keeps own copy of color map
+    errcode = EGifPutScreenDesc(t, tarQImg.width(), tarQImg.height(), 256, 0, cmo);
+    GifFreeMapObject(cmo);
+    if(errcode != GIF_OK){
+        EGifCloseFile(t, &errcode);
+        QTextStream(stdout)  << "EGifPutScreenDesc error 1\n";
+        return false;
+    }
+
+    errcode = EGifPutImageDesc(t, 0, 0, tarQImg.width(), tarQImg.height(), false, 0);
+    if(errcode != GIF_OK){
+        EGifCloseFile(t, &errcode);
+        QTextStream(stdout)  << "EGifPutImageDesc error 2\n";
+        return false;
+    }
+
+    for(int h = 0; h < tarQImg.height(); h++){
+        errcode = EGifPutLine(t, tarQImg.scanLine(h), tarQImg.width());
+        if(errcode != GIF_OK){
+            EGifCloseFile(t, &errcode);
+            QTextStream(stdout)  << "EGifPutLine error 3\n";
+            return false;
+        }
+    }
+
+    EGifCloseFile(t, &errcode);
+
+    return true;
+}
@@ -0,0 +1,47 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GIF_WRITER_H
+#define GIF_WRITER_H
+
+#include <QImage>
+#include <QString>
+#include <QVector>
+
+/*!
+ * \brief Writes QImage into 8-bit GIF file (used by PNG2GIFs and LazyFixTool)
+ */
+class GifWriter
+{
+public:
+    enum QuantizeMode
+    {
+        NoQuantize=0,   //!< Images with more than 256 colors are not written
+        Quantize,       //!< Reduce colors by median cut
+        QuantizeDither  //!< Reduce colors by median cut and Floyd-Steinberg dithering
+    };
+
+    static bool toGif(QImage &img, QString &path, QuantizeMode mode=NoQuantize);
+
+    //! Builds palette of exact colors. Returns false if image has more than 256 colors
+    static bool makeIndexed(const QImage &img, QImage &target, QVector<QRgb> &palette);
+    //! Reduces image to 256 colors
+    static bool quantize(const QImage &img, QImage &target, QVector<QRgb> &palette, bool dither);
+};
+
+#endif // GIF_WRITER_H
@@ -0,0 +1,191 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mask_blend.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+//Returns weighted sums of R, G and B of four pixels as 32-bit values.
+//weights - 16-bit B,G,R,0 multipliers for two pixels
+static inline __m128i sumChannels(__m128i px, __m128i weights)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), weights);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), weights);
+    lo = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2,3,0,1)));
+    hi = _mm_add_epi32(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2,3,0,1)));
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2,0,2,0)));
+}
+
+//x/3 for 0..765, values are 32-bit with zero upper half
+static inline __m128i div3(__m128i x)
+{
+    return _mm_srli_epi32(_mm_madd_epi16(x, _mm_set1_epi32(683)), 11);
+}
+#endif
+
+void MaskBlend::maskToAlphaLine(const QRgb *image, const QRgb *mask, QRgb *out, int count)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i rgbBits = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i grayWeights = _mm_set_epi16(0, 11, 16, 5, 0, 11, 16, 5); //Same as qGray()
+    const __m128i round = _mm_set1_epi32(128);
+    for(; x+4 <= count; x += 4)
+    {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(image+x));
+        __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask+x));
+        m = _mm_andnot_si128(m, rgbBits); //Inverted mask
+        __m128i gray = _mm_srli_epi32(sumChannels(m, grayWeights), 5);
+        __m128i a = _mm_madd_epi16(gray, _mm_srli_epi32(p, 24));
+        a = _mm_add_epi32(a, round);
+        a = _mm_srli_epi32(_mm_add_epi32(a, _mm_srli_epi32(a, 8)), 8);
+        p = _mm_or_si128(_mm_and_si128(p, rgbBits), _mm_slli_epi32(a, 24));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+x), p);
+    }
+#endif
+    for(; x < count; x++)
+    {
+        unsigned int a = unsigned(qGray(~mask[x])) * unsigned(qAlpha(image[x])) + 128;
+        a = (a + (a >> 8)) >> 8;
+        out[x] = (image[x] & 0x00FFFFFF) | (a << 24);
+    }
+}
+
+void MaskBlend::srcAndPaintLine(const QRgb *image, const QRgb *mask, QRgb *out, int count)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i rgbBits = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i alphaBits = _mm_set1_epi32(0xFF000000);
+    const __m128i grayBits = _mm_set1_epi32(0x00808080);
+    const __m128i ones = _mm_set_epi16(0, 1, 1, 1, 0, 1, 1, 1);
+    const __m128i whiteLevel = _mm_set1_epi8(char(241));
+    const __m128i allBits = _mm_set1_epi32(-1);
+    const __m128i max = _mm_set1_epi32(255);
+    for(; x+4 <= count; x += 4)
+    {
+        __m128i p = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(image+x)), rgbBits);
+        __m128i m = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask+x)), rgbBits);
+
+        //vbSrcAnd of gray background and mask, then vbSrcPaint of image
+        __m128i rgb = _mm_or_si128(p, _mm_and_si128(m, grayBits));
+
+        //Almost white mask pixels (all channels are above 240) are fully transparent
+        __m128i white = _mm_cmpeq_epi8(_mm_max_epu8(m, whiteLevel), m);
+        white = _mm_cmpeq_epi32(_mm_or_si128(white, alphaBits), allBits);
+
+        __m128i a = _mm_sub_epi32(max, div3(sumChannels(m, ones)));
+        a = _mm_andnot_si128(white, a);
+        a = _mm_add_epi32(a, div3(sumChannels(p, ones)));
+        a = _mm_min_epi16(a, max);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out+x), _mm_or_si128(rgb, _mm_slli_epi32(a, 24)));
+    }
+#endif
+    for(; x < count; x++)
+    {
+        QRgb p = image[x];
+        QRgb m = mask[x];
+        QRgb rgb = (p | (m & 0x00808080)) & 0x00FFFFFF;
+
+        int a = 255 - (qRed(m) + qGreen(m) + qBlue(m))/3;
+        if((qRed(m) > 240) && (qGreen(m) > 240) && (qBlue(m) > 240))
+            a = 0;
+        a += (qRed(p) + qGreen(p) + qBlue(p))/3;
+        if(a > 255) a = 255;
+
+        out[x] = rgb | (QRgb(a) << 24);
+    }
+}
+
+void MaskBlend::splitAlphaLine(const QRgb *image, QRgb *front, QRgb *mask, int count)
+{
+    int x = 0;
+#ifdef __SSE2__
+    const __m128i alphaBits = _mm_set1_epi32(0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    for(; x+4 <= count; x += 4)
+    {
+        __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(image+x));
+        __m128i a = _mm_srli_epi32(p, 24);
+        __m128i transparent = _mm_cmpeq_epi32(a, zero);
+        __m128i f = _mm_or_si128(_mm_andnot_si128(transparent, p), alphaBits);
+        //Alpha is spread into three color channels and inverted
+        __m128i m = _mm_or_si128(_mm_or_si128(a, _mm_slli_epi32(a, 8)), _mm_slli_epi32(a, 16));
+        m = _mm_xor_si128(m, _mm_set1_epi32(-1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(front+x), f);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(mask+x), m);
+    }
+#endif
+    for(; x < count; x++)
+    {
+        QRgb p = image[x];
+        int a = 255 - qAlpha(p);
+        front[x] = (qAlpha(p) == 0) ? 0xFF000000 : (p | 0xFF000000);
+        mask[x] = qRgb(a, a, a);
+    }
+}
+
+QImage MaskBlend::blend(const QImage &image, const QImage &mask, LineKernel kernel)
+{
+    if(mask.isNull())
+        return image;
+
+    if(image.isNull())
+        return image;
+
+    QImage src = image.convertToFormat(QImage::Format_ARGB32);
+    QImage newmask = mask;
+    if(src.size() != newmask.size())
+        newmask = newmask.copy(0, 0, src.width(), src.height());
+    newmask = newmask.convertToFormat(QImage::Format_ARGB32);
+
+    QImage target(src.width(), src.height(), QImage::Format_ARGB32);
+    for(int y = 0; y < src.height(); y++)
+    {
+        kernel(reinterpret_cast<const QRgb*>(src.constScanLine(y)),
+               reinterpret_cast<const QRgb*>(newmask.constScanLine(y)),
+               reinterpret_cast<QRgb*>(target.scanLine(y)), src.width());
+    }
+    return target;
+}
+
+QImage MaskBlend::applyMask(const QImage &image, const QImage &mask)
+{
+    return blend(image, mask, &MaskBlend::maskToAlphaLine);
+}
+
+QImage MaskBlend::applyMaskVB(const QImage &image, const QImage &mask)
+{
+    return blend(image, mask, &MaskBlend::srcAndPaintLine);
+}
+
+void MaskBlend::splitMask(const QImage &image, QImage &front, QImage &mask)
+{
+    QImage src = image.convertToFormat(QImage::Format_ARGB32);
+    front = QImage(src.width(), src.height(), QImage::Format_RGB32);
+    mask = QImage(src.width(), src.height(), QImage::Format_RGB32);
+    for(int y = 0; y < src.height(); y++)
+    {
+        splitAlphaLine(reinterpret_cast<const QRgb*>(src.constScanLine(y)),
+                       reinterpret_cast<QRgb*>(front.scanLine(y)),
+                       reinterpret_cast<QRgb*>(mask.scanLine(y)), src.width());
+    }
+}
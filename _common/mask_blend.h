@@ -0,0 +1,53 @@
+/*
+ * Platformer Game Engine by Wohlstand, a free platform for game making
+ * Copyright (c) 2014 Vitaly Novichkov <admin@wohlnet.ru>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MASK_BLEND_H
+#define MASK_BLEND_H
+
+#include <QImage>
+#include <QRgb>
+
+/*!
+ * \brief Applying of SMBX-like masks (black - visible, white - transparent) to images
+ *
+ * Whole image is processed by scanline kernels over Format_ARGB32 lines,
+ * with SSE2 path (four pixels per step) when compiler supports it.
+ */
+class MaskBlend
+{
+public:
+    //! Inverted mask becomes alpha channel of image
+    static QImage applyMask(const QImage &image, const QImage &mask);
+    //! Emulation of VB drawing: mask by vbSrcAnd, then image by vbSrcPaint
+    static QImage applyMaskVB(const QImage &image, const QImage &mask);
+    //! Splits image with alpha channel into front image and mask pair
+    static void splitMask(const QImage &image, QImage &front, QImage &mask);
+
+    //! out = image with alpha multiplied by gray of inverted mask
+    static void maskToAlphaLine(const QRgb *image, const QRgb *mask, QRgb *out, int count);
+    //! out = (gray & mask) | image, alpha is taken from brightness of mask and image
+    static void srcAndPaintLine(const QRgb *image, const QRgb *mask, QRgb *out, int count);
+    //! front = image with fully transparent pixels filled by black, mask = inverted alpha
+    static void splitAlphaLine(const QRgb *image, QRgb *front, QRgb *mask, int count);
+
+private:
+    typedef void (*LineKernel)(const QRgb *, const QRgb *, QRgb *, int);
+    static QImage blend(const QImage &image, const QImage &mask, LineKernel kernel);
+};
+
+#endif // MASK_BLEND_H